@@ -12,7 +12,8 @@
 #ifdef _WIN64
 #include <Windows.h>
 #else
-#define DebugBreak __debugbreak
+#include <csignal>
+#define DebugBreak() std::raise(SIGTRAP)
 #endif // _WIN64
 
 #define NpgsAssert(Expr, ...)                                                                                 \
@@ -33,8 +33,15 @@
 #   else
 #       error NPGS can only build on Visual Studio with MSVC
 #   endif // _MSVC_LANG
+#elif defined(__linux__) && defined(__x86_64__)
+#   define NPGS_API
+#   ifdef RELEASE_FORCE_INLINE
+#       define NPGS_INLINE inline __attribute__((always_inline))
+#   else
+#       define NPGS_INLINE inline
+#   endif // RELEASE_FORCE_INLINE
 #else
-#   error NPGS only support 64-bit Windows
+#   error NPGS only support 64-bit Windows and x86-64 Linux
 #endif // _WIN64
 
 // Basic namespace defines
@@ -0,0 +1,300 @@
+#include "SimdKernels.h"
+
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define NPGS_TARGET(Features)
+#else
+#include <cpuid.h>
+#define NPGS_TARGET(Features) __attribute__((target(Features)))
+#endif // _MSC_VER
+
+_NPGS_BEGIN
+_MATH_BEGIN
+
+namespace
+{
+
+// CPU 特性检测
+// ------------
+void CpuId(std::uint32_t Leaf, std::uint32_t SubLeaf, std::uint32_t (&Registers)[4])
+{
+#ifdef _MSC_VER
+    int Info[4]{};
+    __cpuidex(Info, static_cast<int>(Leaf), static_cast<int>(SubLeaf));
+    for (int i = 0; i != 4; ++i)
+    {
+        Registers[i] = static_cast<std::uint32_t>(Info[i]);
+    }
+#else
+    __cpuid_count(Leaf, SubLeaf, Registers[0], Registers[1], Registers[2], Registers[3]);
+#endif // _MSC_VER
+}
+
+std::uint64_t ReadXcr0()
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    std::uint32_t Eax = 0;
+    std::uint32_t Edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(Eax), "=d"(Edx) : "c"(0));
+    return (static_cast<std::uint64_t>(Edx) << 32) | Eax;
+#endif // _MSC_VER
+}
+
+ESimdLevel DetectSimdLevel()
+{
+    std::uint32_t Registers[4]{};
+    CpuId(0, 0, Registers);
+    std::uint32_t MaxLeaf = Registers[0];
+
+    CpuId(1, 0, Registers);
+    bool bHasSse2    = (Registers[3] & (1u << 26)) != 0;
+    bool bHasFma     = (Registers[2] & (1u << 12)) != 0;
+    bool bHasOsxsave = (Registers[2] & (1u << 27)) != 0;
+    bool bHasAvx     = (Registers[2] & (1u << 28)) != 0;
+
+    if (!bHasSse2)
+    {
+        return ESimdLevel::kScalar;
+    }
+
+    if (!bHasOsxsave || !bHasAvx || MaxLeaf < 7)
+    {
+        return ESimdLevel::kSse2;
+    }
+
+    // 操作系统必须保存 YMM（以及 AVX-512 的 opmask 和 ZMM）状态
+    std::uint64_t Xcr0 = ReadXcr0();
+    bool bOsSupportsAvx    = (Xcr0 & 0x06) == 0x06;
+    bool bOsSupportsAvx512 = (Xcr0 & 0xE6) == 0xE6;
+
+    CpuId(7, 0, Registers);
+    bool bHasAvx2    = (Registers[1] & (1u << 5))  != 0;
+    bool bHasAvx512F = (Registers[1] & (1u << 16)) != 0;
+
+    if (bHasAvx512F && bOsSupportsAvx512)
+    {
+        return ESimdLevel::kAvx512;
+    }
+
+    if (bHasAvx2 && bHasFma && bOsSupportsAvx)
+    {
+        return ESimdLevel::kAvx2;
+    }
+
+    return ESimdLevel::kSse2;
+}
+
+// exp10 的多项式近似
+// 10^x = 2^n * e^r，其中 n = round(x * log2(10))，r = (x - n * log10(2)) * ln(10)，|r| <= ln(2) / 2
+// e^r 使用 12 阶泰勒展开，截断误差约 2e-16
+// ---------------------------------------------------------------------------------------------
+constexpr double kExp10InputMin = -307.0;
+constexpr double kExp10InputMax =  308.0;
+constexpr double kLog2Of10      =  3.321928094887362347870;
+constexpr double kLog10Of2Hi    =  0.30102999566361177;      // log10(2) 的高 40 位，与 n 相乘没有舍入误差
+constexpr double kLog10Of2Lo    =  3.694239077158931e-13;    // log10(2) 的剩余部分
+constexpr double kLn10          =  2.302585092994045684018;
+
+constexpr std::array<double, 13> kExpCoefficients
+{
+    1.0 / 479001600.0, // 1/12!
+    1.0 / 39916800.0,
+    1.0 / 3628800.0,
+    1.0 / 362880.0,
+    1.0 / 40320.0,
+    1.0 / 5040.0,
+    1.0 / 720.0,
+    1.0 / 120.0,
+    1.0 / 24.0,
+    1.0 / 6.0,
+    1.0 / 2.0,
+    1.0,
+    1.0                // 1/0!
+};
+
+// 标量实现
+// --------
+void Exp10ArrayScalar(const double* Source, double* Result, std::size_t Count)
+{
+    for (std::size_t i = 0; i != Count; ++i)
+    {
+        Result[i] = std::pow(10.0, std::clamp(Source[i], kExp10InputMin, kExp10InputMax));
+    }
+}
+
+// SSE2 实现
+// ---------
+__m128d Exp10Sse2(__m128d Input)
+{
+    __m128d X = _mm_min_pd(_mm_max_pd(Input, _mm_set1_pd(kExp10InputMin)), _mm_set1_pd(kExp10InputMax));
+
+    // SSE2 没有 round 指令，借助默认舍入模式（就近舍入）的整数转换
+    __m128i N32 = _mm_cvtpd_epi32(_mm_mul_pd(X, _mm_set1_pd(kLog2Of10)));
+    __m128d N   = _mm_cvtepi32_pd(N32);
+
+    __m128d R = _mm_sub_pd(X, _mm_mul_pd(N, _mm_set1_pd(kLog10Of2Hi)));
+    R = _mm_sub_pd(R, _mm_mul_pd(N, _mm_set1_pd(kLog10Of2Lo)));
+    R = _mm_mul_pd(R, _mm_set1_pd(kLn10));
+
+    __m128d Polynomial = _mm_set1_pd(kExpCoefficients[0]);
+    for (std::size_t i = 1; i != kExpCoefficients.size(); ++i)
+    {
+        Polynomial = _mm_add_pd(_mm_mul_pd(Polynomial, R), _mm_set1_pd(kExpCoefficients[i]));
+    }
+
+    // 把 n + 1023 放到每个 64 位通道的指数位上得到 2^n
+    __m128i Biased = _mm_add_epi32(N32, _mm_set1_epi32(1023));
+    __m128i Scale  = _mm_slli_epi64(_mm_unpacklo_epi32(_mm_setzero_si128(), Biased), 20);
+
+    // 钳制会把 NaN 变成边界值，NaN 通道换回输入，与标量版本的 std::pow 一致
+    __m128d Exp10 = _mm_mul_pd(Polynomial, _mm_castsi128_pd(Scale));
+    __m128d NaN   = _mm_cmpunord_pd(Input, Input);
+    return _mm_or_pd(_mm_and_pd(NaN, Input), _mm_andnot_pd(NaN, Exp10));
+}
+
+void Exp10ArraySse2(const double* Source, double* Result, std::size_t Count)
+{
+    std::size_t i = 0;
+    for (; i + 2 <= Count; i += 2)
+    {
+        _mm_storeu_pd(Result + i, Exp10Sse2(_mm_loadu_pd(Source + i)));
+    }
+
+    Exp10ArrayScalar(Source + i, Result + i, Count - i);
+}
+
+// AVX2 实现
+// ---------
+NPGS_TARGET("avx2,fma")
+__m256d Exp10Avx2(__m256d Input)
+{
+    __m256d X = _mm256_min_pd(_mm256_max_pd(Input, _mm256_set1_pd(kExp10InputMin)), _mm256_set1_pd(kExp10InputMax));
+
+    __m256d N = _mm256_round_pd(_mm256_mul_pd(X, _mm256_set1_pd(kLog2Of10)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+
+    __m256d R = _mm256_fnmadd_pd(N, _mm256_set1_pd(kLog10Of2Hi), X);
+    R = _mm256_fnmadd_pd(N, _mm256_set1_pd(kLog10Of2Lo), R);
+    R = _mm256_mul_pd(R, _mm256_set1_pd(kLn10));
+
+    __m256d Polynomial = _mm256_set1_pd(kExpCoefficients[0]);
+    for (std::size_t i = 1; i != kExpCoefficients.size(); ++i)
+    {
+        Polynomial = _mm256_fmadd_pd(Polynomial, R, _mm256_set1_pd(kExpCoefficients[i]));
+    }
+
+    __m256i Biased = _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(N)), _mm256_set1_epi64x(1023));
+    __m256i Scale  = _mm256_slli_epi64(Biased, 52);
+
+    __m256d Exp10 = _mm256_mul_pd(Polynomial, _mm256_castsi256_pd(Scale));
+    return _mm256_blendv_pd(Exp10, Input, _mm256_cmp_pd(Input, Input, _CMP_UNORD_Q));
+}
+
+NPGS_TARGET("avx2,fma")
+void Exp10ArrayAvx2(const double* Source, double* Result, std::size_t Count)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= Count; i += 4)
+    {
+        _mm256_storeu_pd(Result + i, Exp10Avx2(_mm256_loadu_pd(Source + i)));
+    }
+
+    Exp10ArraySse2(Source + i, Result + i, Count - i);
+}
+
+// AVX-512 实现
+// ------------
+NPGS_TARGET("avx512f")
+__m512d Exp10Avx512(__m512d Input)
+{
+    __m512d X = _mm512_min_pd(_mm512_max_pd(Input, _mm512_set1_pd(kExp10InputMin)), _mm512_set1_pd(kExp10InputMax));
+
+    __m512d N = _mm512_roundscale_pd(_mm512_mul_pd(X, _mm512_set1_pd(kLog2Of10)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+
+    __m512d R = _mm512_fnmadd_pd(N, _mm512_set1_pd(kLog10Of2Hi), X);
+    R = _mm512_fnmadd_pd(N, _mm512_set1_pd(kLog10Of2Lo), R);
+    R = _mm512_mul_pd(R, _mm512_set1_pd(kLn10));
+
+    __m512d Polynomial = _mm512_set1_pd(kExpCoefficients[0]);
+    for (std::size_t i = 1; i != kExpCoefficients.size(); ++i)
+    {
+        Polynomial = _mm512_fmadd_pd(Polynomial, R, _mm512_set1_pd(kExpCoefficients[i]));
+    }
+
+    // scalef 直接计算 Polynomial * 2^N
+    __m512d Exp10 = _mm512_scalef_pd(Polynomial, N);
+    return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(Input, Input, _CMP_UNORD_Q), Exp10, Input);
+}
+
+NPGS_TARGET("avx512f")
+void Exp10ArrayAvx512(const double* Source, double* Result, std::size_t Count)
+{
+    for (std::size_t i = 0; i < Count; i += 8)
+    {
+        __mmask8 Mask = Count - i >= 8 ? static_cast<__mmask8>(0xFF) : static_cast<__mmask8>((1u << (Count - i)) - 1);
+        _mm512_mask_storeu_pd(Result + i, Mask, Exp10Avx512(_mm512_maskz_loadu_pd(Mask, Source + i)));
+    }
+}
+
+// 分派表
+// ------
+struct FKernelTable
+{
+    void (*Exp10Array)(const double*, double*, std::size_t);
+};
+
+FKernelTable MakeKernelTable(ESimdLevel Level)
+{
+    switch (Level)
+    {
+    case ESimdLevel::kAvx512:
+        return { &Exp10ArrayAvx512 };
+    case ESimdLevel::kAvx2:
+        return { &Exp10ArrayAvx2 };
+    case ESimdLevel::kSse2:
+        return { &Exp10ArraySse2 };
+    default:
+        return { &Exp10ArrayScalar };
+    }
+}
+
+const FKernelTable& GetKernelTable()
+{
+    static const FKernelTable kTable = MakeKernelTable(GetSimdLevel());
+    return kTable;
+}
+
+} // namespace
+
+ESimdLevel GetSimdLevel()
+{
+    static const ESimdLevel kLevel = DetectSimdLevel();
+    return kLevel;
+}
+
+void Exp10Array(const double* Source, double* Result, std::size_t Count)
+{
+    GetKernelTable().Exp10Array(Source, Result, Count);
+}
+
+void Exp10Array(const double* Source, double* Result, std::size_t Count, ESimdLevel Level)
+{
+    if (Level > GetSimdLevel())
+    {
+        throw std::invalid_argument("SIMD level not supported by this CPU.");
+    }
+
+    MakeKernelTable(Level).Exp10Array(Source, Result, Count);
+}
+
+_MATH_END
+_NPGS_END
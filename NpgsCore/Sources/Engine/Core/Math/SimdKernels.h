@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include "Engine/Core/Base/Base.h"
+
+_NPGS_BEGIN
+_MATH_BEGIN
+
+enum class ESimdLevel
+{
+    kScalar,
+    kSse2,
+    kAvx2,   // AVX2 + FMA
+    kAvx512  // AVX-512F
+};
+
+// 运行时检测 CPU 与操作系统共同支持的最高指令集，结果在首次调用后缓存
+ESimdLevel GetSimdLevel();
+
+// Result[i] = 10^Source[i]，Source 与 Result 可以相同
+// 输入会被钳制在 [-307, 308] 内，NaN 原样输出，向量版本的相对误差不超过 1e-15 量级
+void Exp10Array(const double* Source, double* Result, std::size_t Count);
+
+// 使用指定指令集的实现，供测试和性能比较使用，Level 高于 GetSimdLevel() 时抛出 std::invalid_argument
+void Exp10Array(const double* Source, double* Result, std::size_t Count, ESimdLevel Level);
+
+_MATH_END
+_NPGS_END
@@ -2,9 +2,12 @@
 
 #include <cstddef>
 #include <algorithm>
+#include <array>
 #include <charconv>
 #include <concepts>
 #include <functional>
+#include <iterator>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -24,13 +27,75 @@ _ASSET_BEGIN
 template <std::size_t ColSize>
 concept CValidFormat = ColSize > 1;
 
-template <typename BasicType, std::size_t ColSize>
+enum class EStorageMode
+{
+    kRowMajor,   // 每行一个 std::vector
+    kColumnMajor // 每列一段连续内存，列间步长为行数
+};
+
+template <typename BasicType, std::size_t ColSize, EStorageMode StorageMode = EStorageMode::kRowMajor>
 requires CValidFormat<ColSize>
 class TCommaSeparatedValues
 {
 public:
     using FRowArray = std::vector<BasicType>;
 
+    // 列主序下的行视图，不持有数据
+    class FRowView
+    {
+    public:
+        FRowView() = default;
+        FRowView(const BasicType* First, std::size_t Stride)
+            : _First(First), _Stride(Stride)
+        {
+        }
+
+        const BasicType& operator[](std::size_t Index) const
+        {
+            return _First[Index * _Stride];
+        }
+
+        bool operator==(const FRowView& Other) const
+        {
+            return _First == Other._First;
+        }
+
+        std::array<BasicType, ColSize> ToArray() const
+        {
+            std::array<BasicType, ColSize> Result{};
+            for (std::size_t i = 0; i != ColSize; ++i)
+            {
+                Result[i] = _First[i * _Stride];
+            }
+
+            return Result;
+        }
+
+        FRowArray ToVector() const
+        {
+            FRowArray Result(ColSize);
+            for (std::size_t i = 0; i != ColSize; ++i)
+            {
+                Result[i] = _First[i * _Stride];
+            }
+
+            return Result;
+        }
+
+        constexpr std::size_t size() const
+        {
+            return ColSize;
+        }
+
+    private:
+        const BasicType* _First{};
+        std::size_t      _Stride{};
+    };
+
+    using FRowType = std::conditional_t<StorageMode == EStorageMode::kRowMajor, FRowArray, FRowView>;
+
+    static constexpr bool kbIsColumnMajor = StorageMode == EStorageMode::kColumnMajor;
+
 public:
     TCommaSeparatedValues(const std::string& Filename, const std::vector<std::string>& ColNames)
         : _Filename(Filename), _ColNames(ColNames)
@@ -39,13 +104,42 @@ public:
         ReadData(io::ignore_extra_column);
     }
 
+    // 从列主序的定长数据构造，用于从二进制数据包还原表格
+    // 列主序模式下不复制数据，只引用外部内存，调用方需保证其生命周期长于该对象
+    TCommaSeparatedValues(const std::string& Filename, const std::vector<std::string>& ColNames,
+                          const BasicType* ColumnMajorData, std::size_t RowCount)
+        : _Filename(Filename), _ColNames(ColNames)
+    {
+        InitHeaderMap();
+        if constexpr (kbIsColumnMajor)
+        {
+            _ColumnData = ColumnMajorData;
+            _RowCount   = RowCount;
+        }
+        else
+        {
+            _Data.assign(RowCount, FRowArray(ColSize));
+            for (std::size_t Col = 0; Col != ColSize; ++Col)
+            {
+                const BasicType* Column = ColumnMajorData + Col * RowCount;
+                for (std::size_t Row = 0; Row != RowCount; ++Row)
+                {
+                    _Data[Row][Col] = Column[Row];
+                }
+            }
+        }
+    }
+
     TCommaSeparatedValues(const TCommaSeparatedValues&) = delete;
     TCommaSeparatedValues(TCommaSeparatedValues&& Other) noexcept
         :
         _Filename(std::move(Other._Filename)),
         _ColNames(std::move(Other._ColNames)),
         _HeaderMap(std::move(Other._HeaderMap)),
-        _Data(std::move(Other._Data))
+        _Data(std::move(Other._Data)),
+        _ColumnStorage(std::move(Other._ColumnStorage)),
+        _ColumnData(std::exchange(Other._ColumnData, nullptr)),
+        _RowCount(std::exchange(Other._RowCount, 0))
     {
     }
 
@@ -56,10 +150,13 @@ public:
     {
         if (this != &Other)
         {
-            _Filename  = std::move(Other._Filename);
-            _ColNames  = std::move(Other._ColNames);
-            _HeaderMap = std::move(Other._HeaderMap);
-            _Data      = std::move(Other._Data);
+            _Filename      = std::move(Other._Filename);
+            _ColNames      = std::move(Other._ColNames);
+            _HeaderMap     = std::move(Other._HeaderMap);
+            _Data          = std::move(Other._Data);
+            _ColumnStorage = std::move(Other._ColumnStorage);
+            _ColumnData    = std::exchange(Other._ColumnData, nullptr);
+            _RowCount      = std::exchange(Other._RowCount, 0);
         }
 
         return *this;
@@ -68,11 +165,19 @@ public:
     FRowArray FindFirstDataArray(const std::string& DataHeader, const BasicType& DataValue) const
     {
         std::size_t DataIndex = GetHeaderIndex(DataHeader);
-        for (const auto& Row : _Data)
+        for (std::size_t i = 0; i != GetRowCount(); ++i)
         {
+            const auto& Row = GetRow(i);
             if (Row[DataIndex] == DataValue)
             {
-                return Row;
+                if constexpr (kbIsColumnMajor)
+                {
+                    return Row.ToVector();
+                }
+                else
+                {
+                    return Row;
+                }
             }
         }
 
@@ -83,8 +188,9 @@ public:
     {
         std::size_t DataIndex   = GetHeaderIndex(DataHeader);
         std::size_t TargetIndex = GetHeaderIndex(TargetHeader);
-        for (const auto& Row : _Data)
+        for (std::size_t i = 0; i != GetRowCount(); ++i)
         {
+            const auto& Row = GetRow(i);
             if (Row[DataIndex] == DataValue)
             {
                 return Row[TargetIndex];
@@ -95,64 +201,130 @@ public:
     }
 
     template <typename Func = std::less<>>
-    std::pair<FRowArray, FRowArray> FindSurroundingValues(const std::string& DataHeader, const BasicType& TargetValue,
-                                                          bool bSorted = true, Func&& Pred = Func())
+    std::pair<FRowType, FRowType> FindSurroundingValues(const std::string& DataHeader, const BasicType& TargetValue,
+                                                        bool bSorted = true, Func&& Pred = Func())
     {
-        std::size_t DataIndex = GetHeaderIndex(DataHeader);
+        return FindSurroundingValues(GetHeaderIndex(DataHeader), TargetValue, bSorted, std::forward<Func>(Pred));
+    }
 
-        std::function<bool(const BasicType&, const BasicType&)> Comparator = Pred;
-        if constexpr (std::is_same_v<Func, std::less<>> && std::is_same_v<BasicType, std::string>)
+    template <typename Func = std::less<>>
+    std::pair<FRowType, FRowType> FindSurroundingValues(std::size_t DataIndex, const BasicType& TargetValue,
+                                                        bool bSorted = true, Func&& Pred = Func())
+    {
+        auto Comparator = [&](const BasicType& Lhs, const BasicType& Rhs) -> bool
         {
-            Comparator = &TCommaSeparatedValues::StrLessThan;
-        }
+            if constexpr (std::is_same_v<std::remove_cvref_t<Func>, std::less<>> && std::is_same_v<BasicType, std::string>)
+            {
+                return StrLessThan(Lhs, Rhs);
+            }
+            else
+            {
+                return Pred(Lhs, Rhs);
+            }
+        };
+
+        if constexpr (kbIsColumnMajor)
+        {
+            // 列主序下直接在单列上二分查找，数据需预先有序
+            if (!bSorted)
+            {
+                throw std::invalid_argument("Column-major data must be sorted.");
+            }
 
-        if (!bSorted)
+            std::span<const BasicType> Column = GetColumn(DataIndex);
+            auto it = std::lower_bound(Column.begin(), Column.end(), TargetValue, Comparator);
+            if (it == Column.end())
+            {
+                throw std::out_of_range("Target value is out of range of the data.");
+            }
+
+            std::size_t UpperIndex = std::distance(Column.begin(), it);
+            std::size_t LowerIndex = UpperIndex;
+            if (*it != TargetValue && UpperIndex != 0)
+            {
+                --LowerIndex;
+            }
+
+            return { GetRow(LowerIndex), GetRow(UpperIndex) };
+        }
+        else
         {
-            std::sort(_Data.begin(), _Data.end(), [&](const FRowArray& Lhs, const FRowArray& Rhs) -> bool
+            if (!bSorted)
+            {
+                std::sort(_Data.begin(), _Data.end(), [&](const FRowArray& Lhs, const FRowArray& Rhs) -> bool
+                {
+                    return Comparator(Lhs[DataIndex], Rhs[DataIndex]);
+                });
+            }
+
+            auto it = std::lower_bound(_Data.begin(), _Data.end(), TargetValue,
+            [&](const FRowArray& Row, const BasicType& Value) -> bool
             {
-                return Comparator(Lhs[DataIndex], Rhs[DataIndex]);
+                return Comparator(Row[DataIndex], Value);
             });
+
+            if (it == _Data.end())
+            {
+                throw std::out_of_range("Target value is out of range of the data.");
+            }
+
+            typename std::vector<FRowArray>::iterator LowerRow;
+            typename std::vector<FRowArray>::iterator UpperRow;
+
+            if ((*it)[DataIndex] == TargetValue)
+            {
+                LowerRow = UpperRow = it;
+            }
+            else
+            {
+                LowerRow = it == _Data.begin() ? it : it - 1;
+                UpperRow = it;
+            }
+
+            return { *LowerRow, *UpperRow };
         }
+    }
 
-        auto it = std::lower_bound(_Data.begin(), _Data.end(), TargetValue,
-        [&](const FRowArray& Row, const BasicType& Value) -> bool
+    decltype(auto) GetRow(std::size_t Index) const
+    {
+        if constexpr (kbIsColumnMajor)
         {
-            return Comparator(Row[DataIndex], Value);
-        });
-
-        if (it == _Data.end())
+            return FRowView(_ColumnData + Index, _RowCount);
+        }
+        else
         {
-            throw std::out_of_range("Target value is out of range of the data.");
+            return static_cast<const FRowArray&>(_Data[Index]);
         }
+    }
 
-        typename std::vector<FRowArray>::iterator LowerRow;
-        typename std::vector<FRowArray>::iterator UpperRow;
-
-        if ((*it)[DataIndex] == TargetValue)
+    std::size_t GetRowCount() const
+    {
+        if constexpr (kbIsColumnMajor)
         {
-            LowerRow = UpperRow = it;
+            return _RowCount;
         }
         else
         {
-            LowerRow = it == _Data.begin() ? it : it - 1;
-            UpperRow = it;
+            return _Data.size();
         }
+    }
 
-        return { *LowerRow, *UpperRow };
+    std::span<const BasicType> GetColumn(std::size_t Index) const
+    requires (StorageMode == EStorageMode::kColumnMajor)
+    {
+        return { _ColumnData + Index * _RowCount, _RowCount };
     }
 
-    const std::vector<FRowArray>* Data() const
+    std::span<const BasicType> GetColumn(const std::string& Header) const
+    requires (StorageMode == EStorageMode::kColumnMajor)
     {
-        return &_Data;
+        return GetColumn(GetHeaderIndex(Header));
     }
 
-private:
-    void InitHeaderMap()
+    const std::vector<FRowArray>* Data() const
+    requires (StorageMode == EStorageMode::kRowMajor)
     {
-        for (std::size_t i = 0; i < _ColNames.size(); ++i)
-        {
-            _HeaderMap[_ColNames[i]] = i;
-        }
+        return &_Data;
     }
 
     std::size_t GetHeaderIndex(const std::string& Header) const
@@ -166,6 +338,15 @@ private:
         throw std::out_of_range("Header not found.");
     }
 
+private:
+    void InitHeaderMap()
+    {
+        for (std::size_t i = 0; i < _ColNames.size(); ++i)
+        {
+            _HeaderMap[_ColNames[i]] = i;
+        }
+    }
+
     template <typename ReaderType>
     void ReadHeader(ReaderType& Reader, io::ignore_column IgnoreColumn)
     {
@@ -184,6 +365,22 @@ private:
         {
             _Data.emplace_back(Row);
         }
+
+        if constexpr (kbIsColumnMajor)
+        {
+            _RowCount = _Data.size();
+            _ColumnStorage.resize(_RowCount * ColSize);
+            for (std::size_t Col = 0; Col != ColSize; ++Col)
+            {
+                for (std::size_t Row = 0; Row != _RowCount; ++Row)
+                {
+                    _ColumnStorage[Col * _RowCount + Row] = _Data[Row][Col];
+                }
+            }
+
+            _ColumnData = _ColumnStorage.data();
+            std::vector<FRowArray>().swap(_Data);
+        }
     }
 
     template <typename ReaderType>
@@ -225,7 +422,10 @@ private:
     std::string                                  _Filename;
     std::vector<std::string>                     _ColNames;
     std::unordered_map<std::string, std::size_t> _HeaderMap;
-    std::vector<FRowArray>                       _Data;
+    std::vector<FRowArray>                       _Data;          // 行主序数据
+    std::vector<BasicType>                       _ColumnStorage; // 列主序数据（自有）
+    const BasicType*                             _ColumnData{};  // 列主序数据（自有或外部映射）
+    std::size_t                                  _RowCount{};
 };
 
 _ASSET_END
@@ -10,7 +10,8 @@ _ASSET_BEGIN
 #pragma warning(disable : 4715)
 std::string GetAssetFullPath(EAssetType Type, const std::string& Filename)
 {
-    std::string RootFolderName = Type == EAssetType::kBinaryShader ? "" : "Assets/";
+    std::string RootFolderName =
+        Type == EAssetType::kBinaryShader || Type == EAssetType::kBinaryDataTable ? "" : "Assets/";
 #ifdef _RELEASE
     RootFolderName = std::string("../") + RootFolderName;
 #endif // _RELEASE
@@ -21,6 +22,8 @@ std::string GetAssetFullPath(EAssetType Type, const std::string& Filename)
         {
         case EAssetType::kBinaryShader:
             return "Cache/Shaders/";
+        case EAssetType::kBinaryDataTable:
+            return "Cache/DataTables/";
         case EAssetType::kDataTable:
             return "DataTables/";
         case EAssetType::kFont:
@@ -9,12 +9,13 @@ _ASSET_BEGIN
 
 enum class EAssetType
 {
-    kBinaryShader, // 二进制着色器程序（不是 SPIR-V）
-    kDataTable,    // 数据表
-    kFont,         // 字体
-    kModel,        // 模型
-    kShader,       // 着色器
-    kTexture       // 纹理
+    kBinaryShader,    // 二进制着色器程序（不是 SPIR-V）
+    kBinaryDataTable, // 由数据表预编译的二进制数据包
+    kDataTable,       // 数据表
+    kFont,            // 字体
+    kModel,           // 模型
+    kShader,          // 着色器
+    kTexture          // 纹理
 };
 
 std::string GetAssetFullPath(EAssetType Type, const std::string& Filename);
@@ -0,0 +1,146 @@
+#include "MemoryMappedFile.h"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN64
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN64
+
+_NPGS_BEGIN
+_RUNTIME_BEGIN
+_ASSET_BEGIN
+
+FMemoryMappedFile::FMemoryMappedFile(const std::string& Filename)
+{
+#ifdef _WIN64
+    HANDLE File = CreateFileA(Filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (File == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Failed to open file: " + Filename);
+    }
+
+    _FileHandle = File;
+
+    LARGE_INTEGER FileSize{};
+    if (!GetFileSizeEx(File, &FileSize) || FileSize.QuadPart == 0)
+    {
+        Close();
+        throw std::runtime_error("Failed to get size of file or file is empty: " + Filename);
+    }
+
+    _MappingHandle = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_MappingHandle == nullptr)
+    {
+        Close();
+        throw std::runtime_error("Failed to create file mapping: " + Filename);
+    }
+
+    // 只映射视图，不预读，实际访问到的页才会被载入
+    void* View = MapViewOfFile(_MappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (View == nullptr)
+    {
+        Close();
+        throw std::runtime_error("Failed to map view of file: " + Filename);
+    }
+
+    _Data = static_cast<const std::byte*>(View);
+    _Size = static_cast<std::size_t>(FileSize.QuadPart);
+#else
+    int File = open(Filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (File == -1)
+    {
+        throw std::runtime_error("Failed to open file: " + Filename);
+    }
+
+    struct stat FileStat{};
+    if (fstat(File, &FileStat) != 0 || FileStat.st_size == 0)
+    {
+        close(File);
+        throw std::runtime_error("Failed to get size of file or file is empty: " + Filename);
+    }
+
+    void* View = mmap(nullptr, static_cast<std::size_t>(FileStat.st_size), PROT_READ, MAP_PRIVATE, File, 0);
+    close(File); // 映射建立后文件描述符不再需要
+    if (View == MAP_FAILED)
+    {
+        throw std::runtime_error("Failed to map view of file: " + Filename);
+    }
+
+    // 与 Windows 的 FILE_FLAG_RANDOM_ACCESS 对应，关闭预读
+    madvise(View, static_cast<std::size_t>(FileStat.st_size), MADV_RANDOM);
+
+    _Data = static_cast<const std::byte*>(View);
+    _Size = static_cast<std::size_t>(FileStat.st_size);
+#endif // _WIN64
+}
+
+FMemoryMappedFile::FMemoryMappedFile(FMemoryMappedFile&& Other) noexcept
+    :
+    _FileHandle(std::exchange(Other._FileHandle, nullptr)),
+    _MappingHandle(std::exchange(Other._MappingHandle, nullptr)),
+    _Data(std::exchange(Other._Data, nullptr)),
+    _Size(std::exchange(Other._Size, 0))
+{
+}
+
+FMemoryMappedFile::~FMemoryMappedFile()
+{
+    Close();
+}
+
+FMemoryMappedFile& FMemoryMappedFile::operator=(FMemoryMappedFile&& Other) noexcept
+{
+    if (this != &Other)
+    {
+        Close();
+
+        _FileHandle    = std::exchange(Other._FileHandle, nullptr);
+        _MappingHandle = std::exchange(Other._MappingHandle, nullptr);
+        _Data          = std::exchange(Other._Data, nullptr);
+        _Size          = std::exchange(Other._Size, 0);
+    }
+
+    return *this;
+}
+
+void FMemoryMappedFile::Close()
+{
+#ifdef _WIN64
+    if (_Data != nullptr)
+    {
+        UnmapViewOfFile(_Data);
+        _Data = nullptr;
+    }
+
+    if (_MappingHandle != nullptr)
+    {
+        CloseHandle(_MappingHandle);
+        _MappingHandle = nullptr;
+    }
+
+    if (_FileHandle != nullptr)
+    {
+        CloseHandle(_FileHandle);
+        _FileHandle = nullptr;
+    }
+#else
+    if (_Data != nullptr)
+    {
+        munmap(const_cast<std::byte*>(_Data), _Size);
+        _Data = nullptr;
+    }
+#endif // _WIN64
+
+    _Size = 0;
+}
+
+_ASSET_END
+_RUNTIME_END
+_NPGS_END
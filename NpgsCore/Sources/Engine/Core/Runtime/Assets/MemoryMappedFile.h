@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "Engine/Core/Base/Base.h"
+
+_NPGS_BEGIN
+_RUNTIME_BEGIN
+_ASSET_BEGIN
+
+// 只读内存映射文件，映射失败时抛出 std::runtime_error
+class FMemoryMappedFile
+{
+public:
+    FMemoryMappedFile() = default;
+    explicit FMemoryMappedFile(const std::string& Filename);
+    FMemoryMappedFile(const FMemoryMappedFile&) = delete;
+    FMemoryMappedFile(FMemoryMappedFile&& Other) noexcept;
+    ~FMemoryMappedFile();
+
+    FMemoryMappedFile& operator=(const FMemoryMappedFile&) = delete;
+    FMemoryMappedFile& operator=(FMemoryMappedFile&& Other) noexcept;
+
+    void Close();
+
+    const std::byte* GetData() const;
+    std::size_t GetSize() const;
+    bool IsOpen() const;
+
+private:
+    void*            _FileHandle{ nullptr };
+    void*            _MappingHandle{ nullptr };
+    const std::byte* _Data{ nullptr };
+    std::size_t      _Size{};
+};
+
+_ASSET_END
+_RUNTIME_END
+_NPGS_END
+
+#include "MemoryMappedFile.inl"
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "MemoryMappedFile.h"
+
+_NPGS_BEGIN
+_RUNTIME_BEGIN
+_ASSET_BEGIN
+
+NPGS_INLINE const std::byte* FMemoryMappedFile::GetData() const
+{
+    return _Data;
+}
+
+NPGS_INLINE std::size_t FMemoryMappedFile::GetSize() const
+{
+    return _Size;
+}
+
+NPGS_INLINE bool FMemoryMappedFile::IsOpen() const
+{
+    return _Data != nullptr;
+}
+
+_ASSET_END
+_RUNTIME_END
+_NPGS_END
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Engine/Core/Base/Base.h"
+#include "Engine/Core/Runtime/Assets/CommaSeparatedValues.hpp"
+#include "Engine/Core/Runtime/Assets/MemoryMappedFile.h"
+
+_NPGS_BEGIN
+_RUNTIME_BEGIN
+_ASSET_BEGIN
+
+// 演化轨迹二进制数据包
+// 一个数据包对应一个目录下的所有轨迹文件，布局如下：
+// FHeader | FIndexEntry[TrackCount]（按质量升序）| 每条轨迹的列主序定长数据（按 64 字节对齐）
+template <typename BasicType, std::size_t ColSize>
+requires CValidFormat<ColSize> && std::is_arithmetic_v<BasicType>
+class TTrackPack
+{
+public:
+    struct FTrackView
+    {
+        const BasicType* Data{}; // 列主序，第 i 列起始于 Data + i * RowCount
+        std::size_t      RowCount{};
+        float            Mass{};
+    };
+
+public:
+    explicit TTrackPack(const std::string& Filename)
+        : _File(Filename)
+    {
+        const std::byte* Base = _File.GetData();
+        std::size_t FileSize  = _File.GetSize();
+
+        FHeader Header{};
+        if (FileSize < sizeof(FHeader))
+        {
+            throw std::runtime_error("Track pack is truncated.");
+        }
+
+        std::memcpy(&Header, Base, sizeof(FHeader));
+        if (Header.Magic != _kMagic || Header.Version != _kVersion ||
+            Header.ColumnCount != ColSize || Header.ElementSize != sizeof(BasicType) || Header.FileSize != FileSize)
+        {
+            throw std::runtime_error("Track pack format mismatch.");
+        }
+
+        if (Header.IndexOffset + static_cast<std::uint64_t>(Header.TrackCount) * sizeof(FIndexEntry) > FileSize)
+        {
+            throw std::runtime_error("Track pack index is out of range.");
+        }
+
+        _Index.resize(Header.TrackCount);
+        std::memcpy(_Index.data(), Base + Header.IndexOffset, Header.TrackCount * sizeof(FIndexEntry));
+
+        _Masses.reserve(Header.TrackCount);
+        for (const auto& Entry : _Index)
+        {
+            std::uint64_t DataSize = Entry.RowCount * ColSize * sizeof(BasicType);
+            if (Entry.DataOffset % _kDataAlignment != 0 || Entry.DataOffset + DataSize > FileSize)
+            {
+                throw std::runtime_error("Track pack data is out of range.");
+            }
+
+            _Masses.emplace_back(Entry.Mass);
+        }
+
+        if (!std::is_sorted(_Masses.begin(), _Masses.end()))
+        {
+            throw std::runtime_error("Track pack index is not sorted.");
+        }
+    }
+
+    TTrackPack(const TTrackPack&)     = delete;
+    TTrackPack(TTrackPack&&) noexcept = default;
+    ~TTrackPack()                     = default;
+
+    TTrackPack& operator=(const TTrackPack&)     = delete;
+    TTrackPack& operator=(TTrackPack&&) noexcept = default;
+
+    FTrackView GetTrack(std::size_t Index) const
+    {
+        const FIndexEntry& Entry = _Index.at(Index);
+        return
+        {
+            reinterpret_cast<const BasicType*>(_File.GetData() + Entry.DataOffset),
+            static_cast<std::size_t>(Entry.RowCount),
+            Entry.Mass
+        };
+    }
+
+    const std::vector<float>& GetMasses() const
+    {
+        return _Masses;
+    }
+
+    std::size_t GetTrackCount() const
+    {
+        return _Index.size();
+    }
+
+    // 从已加载的 csv 生成数据包，Tracks 需按质量升序排列
+    // 先写入临时文件再替换，防止写入中断留下损坏的数据包
+    template <typename CsvType>
+    static void Build(const std::string& Filename, const std::vector<std::pair<float, const CsvType*>>& Tracks)
+    {
+        std::filesystem::path FilePath(Filename);
+        std::filesystem::path TempPath(Filename + ".tmp");
+        if (FilePath.has_parent_path())
+        {
+            std::filesystem::create_directories(FilePath.parent_path());
+        }
+
+        std::vector<FIndexEntry> Index;
+        Index.reserve(Tracks.size());
+
+        std::uint64_t Offset = AlignOffset(sizeof(FHeader) + Tracks.size() * sizeof(FIndexEntry));
+        for (const auto& [Mass, Csv] : Tracks)
+        {
+            FIndexEntry Entry{};
+            Entry.Mass       = Mass;
+            Entry.RowCount   = Csv->GetRowCount();
+            Entry.DataOffset = Offset;
+            Index.emplace_back(Entry);
+
+            Offset = AlignOffset(Offset + Entry.RowCount * ColSize * sizeof(BasicType));
+        }
+
+        FHeader Header{};
+        Header.Magic       = _kMagic;
+        Header.Version     = _kVersion;
+        Header.ColumnCount = static_cast<std::uint32_t>(ColSize);
+        Header.ElementSize = static_cast<std::uint32_t>(sizeof(BasicType));
+        Header.TrackCount  = static_cast<std::uint32_t>(Tracks.size());
+        Header.IndexOffset = sizeof(FHeader);
+        Header.FileSize    = Index.empty() ? AlignOffset(sizeof(FHeader)) : Offset;
+
+        {
+            std::ofstream PackFile(TempPath, std::ios::binary | std::ios::trunc);
+            if (!PackFile.is_open())
+            {
+                throw std::runtime_error("Failed to create track pack: " + TempPath.string());
+            }
+
+            PackFile.write(reinterpret_cast<const char*>(&Header), sizeof(FHeader));
+            PackFile.write(reinterpret_cast<const char*>(Index.data()), Index.size() * sizeof(FIndexEntry));
+
+            std::vector<BasicType> Column;
+            for (std::size_t i = 0; i != Tracks.size(); ++i)
+            {
+                PadTo(PackFile, Index[i].DataOffset);
+
+                const CsvType* Csv = Tracks[i].second;
+                Column.resize(Csv->GetRowCount());
+                for (std::size_t Col = 0; Col != ColSize; ++Col)
+                {
+                    for (std::size_t Row = 0; Row != Column.size(); ++Row)
+                    {
+                        Column[Row] = Csv->GetRow(Row)[Col];
+                    }
+
+                    PackFile.write(reinterpret_cast<const char*>(Column.data()), Column.size() * sizeof(BasicType));
+                }
+            }
+
+            PadTo(PackFile, Header.FileSize);
+            if (!PackFile.good())
+            {
+                throw std::runtime_error("Failed to write track pack: " + TempPath.string());
+            }
+        }
+
+        std::filesystem::rename(TempPath, FilePath);
+    }
+
+private:
+    struct FHeader
+    {
+        std::array<char, 8> Magic;
+        std::uint32_t       Version;
+        std::uint32_t       ColumnCount;
+        std::uint32_t       ElementSize;
+        std::uint32_t       TrackCount;
+        std::uint64_t       IndexOffset;
+        std::uint64_t       FileSize;
+    };
+
+    struct FIndexEntry
+    {
+        float         Mass;
+        std::uint32_t Reserved;
+        std::uint64_t RowCount;
+        std::uint64_t DataOffset;
+    };
+
+    static std::uint64_t AlignOffset(std::uint64_t Offset)
+    {
+        return (Offset + _kDataAlignment - 1) / _kDataAlignment * _kDataAlignment;
+    }
+
+    static void PadTo(std::ofstream& PackFile, std::uint64_t Offset)
+    {
+        static const std::array<char, _kDataAlignment> kZeros{};
+        auto Current = static_cast<std::uint64_t>(PackFile.tellp());
+        if (Current < Offset)
+        {
+            PackFile.write(kZeros.data(), static_cast<std::streamsize>(Offset - Current));
+        }
+    }
+
+private:
+    static constexpr std::array<char, 8> _kMagic{ 'N', 'P', 'G', 'S', 'T', 'R', 'K', '\0' };
+    static constexpr std::uint32_t       _kVersion       = 1;
+    static constexpr std::size_t         _kDataAlignment = 64;
+
+    FMemoryMappedFile        _File;
+    std::vector<FIndexEntry> _Index;
+    std::vector<float>       _Masses;
+};
+
+_ASSET_END
+_RUNTIME_END
+_NPGS_END
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include "Engine/Core/Base/Base.h"
+
+_NPGS_BEGIN
+_RUNTIME_BEGIN
+_THREAD_BEGIN
+
+// 只可移动的 void() 任务，小于内部缓冲区的可调用对象直接就地存放，不分配堆内存
+class FTask
+{
+public:
+    FTask() = default;
+
+    template <typename Func>
+    requires (!std::is_same_v<std::decay_t<Func>, FTask> && std::is_invocable_v<std::decay_t<Func>&>)
+    FTask(Func&& Pred);
+
+    FTask(const FTask&) = delete;
+    FTask(FTask&& Other) noexcept;
+    ~FTask();
+
+    FTask& operator=(const FTask&) = delete;
+    FTask& operator=(FTask&& Other) noexcept;
+
+    void operator()();
+    explicit operator bool() const;
+
+    void Reset();
+
+private:
+    static constexpr std::size_t _kStorageSize = 48;
+
+    struct FOperations
+    {
+        void (*Invoke)(void* Storage);
+        void (*Move)(void* Destination, void* Source) noexcept; // 移动后销毁 Source
+        void (*Destroy)(void* Storage) noexcept;
+    };
+
+    template <typename FuncType>
+    static constexpr bool _kbIsStoredInline = sizeof(FuncType) <= _kStorageSize && alignof(FuncType) <= alignof(std::max_align_t) &&
+                                             std::is_nothrow_move_constructible_v<FuncType>;
+
+    template <typename FuncType>
+    static const FOperations _kInlineOperations;
+
+    template <typename FuncType>
+    static const FOperations _kHeapOperations;
+
+private:
+    alignas(std::max_align_t) std::byte _Storage[_kStorageSize];
+    const FOperations* _Operations{ nullptr };
+};
+
+_THREAD_END
+_RUNTIME_END
+_NPGS_END
+
+#include "Task.inl"
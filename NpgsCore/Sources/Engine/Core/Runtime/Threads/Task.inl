@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Task.h"
+
+#include <memory>
+#include <utility>
+
+_NPGS_BEGIN
+_RUNTIME_BEGIN
+_THREAD_BEGIN
+
+template <typename FuncType>
+inline const FTask::FOperations FTask::_kInlineOperations
+{
+    [](void* Storage) -> void
+    {
+        (*std::launder(static_cast<FuncType*>(Storage)))();
+    },
+    [](void* Destination, void* Source) noexcept -> void
+    {
+        auto* SourceFunc = std::launder(static_cast<FuncType*>(Source));
+        ::new (Destination) FuncType(std::move(*SourceFunc));
+        SourceFunc->~FuncType();
+    },
+    [](void* Storage) noexcept -> void
+    {
+        std::launder(static_cast<FuncType*>(Storage))->~FuncType();
+    }
+};
+
+// 放不进缓冲区的可调用对象在堆上分配，缓冲区中只保存指针
+template <typename FuncType>
+inline const FTask::FOperations FTask::_kHeapOperations
+{
+    [](void* Storage) -> void
+    {
+        (**static_cast<FuncType**>(Storage))();
+    },
+    [](void* Destination, void* Source) noexcept -> void
+    {
+        *static_cast<FuncType**>(Destination) = std::exchange(*static_cast<FuncType**>(Source), nullptr);
+    },
+    [](void* Storage) noexcept -> void
+    {
+        delete *static_cast<FuncType**>(Storage);
+    }
+};
+
+template <typename Func>
+requires (!std::is_same_v<std::decay_t<Func>, FTask> && std::is_invocable_v<std::decay_t<Func>&>)
+inline FTask::FTask(Func&& Pred)
+{
+    using FuncType = std::decay_t<Func>;
+
+    if constexpr (_kbIsStoredInline<FuncType>)
+    {
+        ::new (static_cast<void*>(_Storage)) FuncType(std::forward<Func>(Pred));
+        _Operations = &_kInlineOperations<FuncType>;
+    }
+    else
+    {
+        ::new (static_cast<void*>(_Storage)) FuncType*(new FuncType(std::forward<Func>(Pred)));
+        _Operations = &_kHeapOperations<FuncType>;
+    }
+}
+
+NPGS_INLINE FTask::FTask(FTask&& Other) noexcept
+    : _Operations(std::exchange(Other._Operations, nullptr))
+{
+    if (_Operations != nullptr)
+    {
+        _Operations->Move(_Storage, Other._Storage);
+    }
+}
+
+NPGS_INLINE FTask::~FTask()
+{
+    Reset();
+}
+
+NPGS_INLINE FTask& FTask::operator=(FTask&& Other) noexcept
+{
+    if (this != &Other)
+    {
+        Reset();
+
+        _Operations = std::exchange(Other._Operations, nullptr);
+        if (_Operations != nullptr)
+        {
+            _Operations->Move(_Storage, Other._Storage);
+        }
+    }
+
+    return *this;
+}
+
+NPGS_INLINE void FTask::operator()()
+{
+    _Operations->Invoke(_Storage);
+}
+
+NPGS_INLINE FTask::operator bool() const
+{
+    return _Operations != nullptr;
+}
+
+NPGS_INLINE void FTask::Reset()
+{
+    if (_Operations != nullptr)
+    {
+        _Operations->Destroy(_Storage);
+        _Operations = nullptr;
+    }
+}
+
+_THREAD_END
+_RUNTIME_END
+_NPGS_END
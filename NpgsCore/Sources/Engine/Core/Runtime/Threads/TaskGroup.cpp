@@ -0,0 +1,70 @@
+#include "TaskGroup.h"
+
+#include <thread>
+#include <utility>
+
+_NPGS_BEGIN
+_RUNTIME_BEGIN
+_THREAD_BEGIN
+
+FTaskGroup::FTaskGroup(FThreadPool* ThreadPool)
+    : _ThreadPool(ThreadPool), _PendingCount(0)
+{
+}
+
+FTaskGroup::~FTaskGroup()
+{
+    // 析构时仍要等待，避免任务访问已经销毁的组；异常在这里只能丢弃
+    try
+    {
+        Wait();
+    }
+    catch (...)
+    {
+    }
+}
+
+void FTaskGroup::Wait()
+{
+    if (_ThreadPool->IsWorkerThread())
+    {
+        // 工作线程不能阻塞，否则本组的任务可能排在自己的队列里无人执行
+        while (_PendingCount.load(std::memory_order_acquire) != 0)
+        {
+            if (!_ThreadPool->RunPendingTask())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::exception_ptr Exception;
+    {
+        std::unique_lock<std::mutex> Lock(_Mutex);
+        _Condition.wait(Lock, [this]() -> bool { return _PendingCount.load(std::memory_order_acquire) == 0; });
+        Exception = std::exchange(_Exception, nullptr);
+    }
+
+    if (Exception != nullptr)
+    {
+        std::rethrow_exception(Exception);
+    }
+}
+
+void FTaskGroup::FinishTask(std::exception_ptr Exception)
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+    if (Exception != nullptr && _Exception == nullptr)
+    {
+        _Exception = std::move(Exception);
+    }
+
+    if (_PendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        _Condition.notify_all();
+    }
+}
+
+_THREAD_END
+_RUNTIME_END
+_NPGS_END
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+#include "Engine/Core/Base/Base.h"
+#include "Engine/Core/Runtime/Threads/ThreadPool.h"
+
+_NPGS_BEGIN
+_RUNTIME_BEGIN
+_THREAD_BEGIN
+
+// 一组提交到线程池的任务，Wait 只等待本组的任务完成，不影响线程池中的其他任务
+// 在工作线程中等待时会帮助执行线程池中的任务，因此可以嵌套使用
+class FTaskGroup
+{
+public:
+    explicit FTaskGroup(FThreadPool* ThreadPool = FThreadPool::GetInstance());
+    FTaskGroup(const FTaskGroup&) = delete;
+    FTaskGroup(FTaskGroup&&)      = delete;
+    ~FTaskGroup();
+
+    FTaskGroup& operator=(const FTaskGroup&) = delete;
+    FTaskGroup& operator=(FTaskGroup&&)      = delete;
+
+    template <typename Func, typename... Args>
+    void Run(Func&& Pred, Args&&... Params);
+
+    // 等待本组所有任务完成，如果有任务抛出异常，重新抛出第一个异常
+    void Wait();
+
+private:
+    void FinishTask(std::exception_ptr Exception);
+
+private:
+    FThreadPool*             _ThreadPool;
+    std::atomic<std::size_t> _PendingCount;
+    std::mutex               _Mutex;     // 保护 _Exception，计数也在锁内递减，保证等待者返回前任务已不再访问本组
+    std::condition_variable  _Condition;
+    std::exception_ptr       _Exception;
+};
+
+_THREAD_END
+_RUNTIME_END
+_NPGS_END
+
+#include "TaskGroup.inl"
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "TaskGroup.h"
+
+#include <functional>
+#include <utility>
+
+_NPGS_BEGIN
+_RUNTIME_BEGIN
+_THREAD_BEGIN
+
+template <typename Func, typename... Args>
+inline void FTaskGroup::Run(Func&& Pred, Args&&... Params)
+{
+    _PendingCount.fetch_add(1, std::memory_order_relaxed);
+    _ThreadPool->SubmitDetached([this, Pred = std::forward<Func>(Pred), ...Params = std::forward<Args>(Params)]() mutable -> void
+    {
+        std::exception_ptr Exception;
+        try
+        {
+            std::invoke(Pred, Params...);
+        }
+        catch (...)
+        {
+            Exception = std::current_exception();
+        }
+
+        FinishTask(std::move(Exception));
+    });
+}
+
+_THREAD_END
+_RUNTIME_END
+_NPGS_END
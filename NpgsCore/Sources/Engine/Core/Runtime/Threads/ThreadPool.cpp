@@ -1,8 +1,23 @@
 #include "ThreadPool.h"
 
+#include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _WIN64
 #include <Windows.h>
+#else
+#include <filesystem>
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#endif // _WIN64
 
 _NPGS_BEGIN
 _RUNTIME_BEGIN
@@ -10,18 +25,148 @@ _THREAD_BEGIN
 
 namespace
 {
-    int GetPhysicalCoreCount();
+    std::vector<std::vector<std::size_t>> GetCoreProcessors();
+    std::vector<int> GetCoreNumaNodes(const std::vector<std::vector<std::size_t>>& CoreProcessors);
+    void InterleaveNumaNodes(std::vector<std::vector<std::size_t>>& CoreProcessors, std::vector<int>& CoreNumaNodes);
+    int GetCpuQuota();
+
+    // 当前线程所属的线程池及其工作线程序号，非工作线程为 nullptr
+    thread_local FThreadPool* kCurrentPool = nullptr;
+    thread_local std::size_t  kWorkerIndex = 0;
 }
 
 // ThreadPool implementations
 // --------------------------
-void FThreadPool::Terminate()
+void FThreadPool::Start(int ThreadCount)
 {
+    std::lock_guard<std::mutex> Lock(_LifecycleMutex);
+    if (_Threads.empty())
     {
-        std::unique_lock<std::mutex> Mutex(_Mutex);
+        StartImpl(ThreadCount);
+    }
+}
+
+void FThreadPool::Stop()
+{
+    std::lock_guard<std::mutex> Lock(_LifecycleMutex);
+    StopImpl();
+}
+
+void FThreadPool::Resize(int ThreadCount)
+{
+    std::lock_guard<std::mutex> Lock(_LifecycleMutex);
+    StopImpl();
+    StartImpl(ThreadCount);
+}
+
+bool FThreadPool::IsRunning() const
+{
+    return !_Threads.empty();
+}
+
+bool FThreadPool::RunPendingTask()
+{
+    if (!IsWorkerThread())
+    {
+        return false;
+    }
+
+    FTaskNode* Node = AcquireTask(kWorkerIndex);
+    if (Node == nullptr)
+    {
+        return false;
+    }
+
+    RunTask(Node);
+    return true;
+}
+
+bool FThreadPool::IsWorkerThread() const
+{
+    return kCurrentPool == this;
+}
+
+FThreadPool* FThreadPool::GetInstance()
+{
+    static FThreadPool Instance;
+    return &Instance;
+}
+
+FThreadPool::FThreadPool()
+    :
+    _GlobalTaskCount(0),
+    _PendingTaskCount(0),
+    _SleepingCount(0),
+    _Terminate(false),
+    _kHyperThreadIndex(0),
+    _CoreProcessors(GetCoreProcessors())
+{
+    if (_CoreProcessors.empty())
+    {
+        for (std::size_t i = 0; i != std::max(std::thread::hardware_concurrency(), 1u); ++i)
+        {
+            _CoreProcessors.push_back({ i });
+        }
+    }
+
+    _CoreNumaNodes = GetCoreNumaNodes(_CoreProcessors);
+    InterleaveNumaNodes(_CoreProcessors, _CoreNumaNodes);
+    _kNumaNodeCount = static_cast<int>(std::set<int>(_CoreNumaNodes.begin(), _CoreNumaNodes.end()).size());
+
+    _kPhysicalCoreCount  = static_cast<int>(_CoreProcessors.size());
+    _kDefaultThreadCount = _kPhysicalCoreCount;
+
+    // 在容器中运行时按 cgroup 的 CPU 配额限制线程数，防止超额订阅
+    int CpuQuota = GetCpuQuota();
+    if (CpuQuota > 0)
+    {
+        _kDefaultThreadCount = std::min(_kDefaultThreadCount, CpuQuota);
+    }
+
+    _kMaxThreadCount = _kDefaultThreadCount;
+    StartImpl(_kDefaultThreadCount);
+}
+
+FThreadPool::~FThreadPool()
+{
+    StopImpl();
+}
+
+void FThreadPool::StartImpl(int ThreadCount)
+{
+    _kMaxThreadCount = ThreadCount > 0 ? ThreadCount : _kDefaultThreadCount;
+
+    {
+        std::lock_guard<std::mutex> Lock(_Mutex);
+        _Terminate = false;
+    }
+
+    // 队列必须在任何线程启动前全部创建好，窃取时会遍历所有队列
+    for (int i = 0; i != _kMaxThreadCount; ++i)
+    {
+        _Workers.emplace_back(std::make_unique<FWorkerState>());
+    }
+
+    for (int i = 0; i != _kMaxThreadCount; ++i)
+    {
+        _Threads.emplace_back(&FThreadPool::WorkerLoop, this, static_cast<std::size_t>(i));
+        SetThreadAffinity(_Threads.back(), i);
+    }
+}
+
+void FThreadPool::StopImpl()
+{
+    if (IsWorkerThread())
+    {
+        throw std::runtime_error("Thread pool can not be stopped from its own worker thread.");
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock(_Mutex);
         _Terminate = true;
     }
     _Condition.notify_all();
+
     for (auto& Thread : _Threads)
     {
         if (Thread.joinable())
@@ -29,60 +174,289 @@ void FThreadPool::Terminate()
             Thread.join();
         }
     }
+
+    // 工作线程只有在没有待执行任务时才会退出，此时各自的队列都已清空
+    _Threads.clear();
+    _Workers.clear();
 }
 
-FThreadPool* FThreadPool::GetInstance()
+void FThreadPool::Enqueue(FTask&& Task)
 {
-    static FThreadPool Instance;
-    return &Instance;
+    // 先计数再入队，保证工作线程取到任务时计数不会减到负数
+    _PendingTaskCount.fetch_add(1, std::memory_order_seq_cst);
+
+    if (kCurrentPool == this)
+    {
+        auto& Worker = *_Workers[kWorkerIndex];
+        Worker.Queue.Push(AllocateTaskNode(Worker.FreeTasks, std::move(Task)));
+    }
+    else
+    {
+        std::lock_guard<std::mutex> Lock(_GlobalMutex);
+        _GlobalTasks.Push(AllocateTaskNode(_ExternalFreeTasks, std::move(Task)));
+        _GlobalTaskCount.fetch_add(1, std::memory_order_release);
+    }
+
+    // 只有存在休眠线程时才需要加锁唤醒，锁保证唤醒不会在对方检查条件与进入等待之间丢失
+    if (_SleepingCount.load(std::memory_order_seq_cst) > 0)
+    {
+        {
+            std::lock_guard<std::mutex> Lock(_Mutex);
+        }
+        _Condition.notify_one();
+    }
 }
 
-FThreadPool::FThreadPool()
-    : _Terminate(false), _kMaxThreadCount(GetPhysicalCoreCount()), _kPhysicalCoreCount(GetPhysicalCoreCount())
+void FThreadPool::EnqueuePinned(std::size_t WorkerIndex, FTask&& Task)
 {
-    for (std::size_t i = 0; i != _kPhysicalCoreCount; ++i)
     {
-        _Threads.emplace_back([this]() -> void
+        std::lock_guard<std::mutex> Lock(_GlobalMutex);
+        FTaskFreeList& FreeList = kCurrentPool == this ? _Workers[kWorkerIndex]->FreeTasks : _ExternalFreeTasks;
+        _Workers[WorkerIndex]->PinnedTasks.Push(AllocateTaskNode(FreeList, std::move(Task)));
+        _Workers[WorkerIndex]->PinnedTaskCount.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    // 无法只唤醒指定的线程，其余线程检查条件后会继续休眠
+    {
+        std::lock_guard<std::mutex> Lock(_Mutex);
+    }
+    _Condition.notify_all();
+}
+
+void FThreadPool::WorkerLoop(std::size_t WorkerIndex)
+{
+    kCurrentPool = this;
+    kWorkerIndex = WorkerIndex;
+
+    while (true)
+    {
+        FTaskNode* Node = AcquireTask(WorkerIndex);
+        if (Node != nullptr)
         {
-            while (true)
-            {
-                std::function<void()> Task;
-                {
-                    std::unique_lock<std::mutex> Mutex(_Mutex);
-                    _Condition.wait(Mutex, [this]() -> bool { return !_Tasks.empty() || _Terminate; });
-                    if (_Terminate && _Tasks.empty())
-                    {
-                        return;
-                    }
+            RunTask(Node);
+            continue;
+        }
 
-                    Task = std::move(_Tasks.front());
-                    _Tasks.pop();
-                }
+        const auto& Worker = *_Workers[WorkerIndex];
+        auto HasTask = [&]() -> bool
+        {
+            return _PendingTaskCount.load(std::memory_order_seq_cst) > 0 ||
+                   Worker.PinnedTaskCount.load(std::memory_order_seq_cst) > 0;
+        };
 
-                Task();
-            }
-        });
+        std::unique_lock<std::mutex> Mutex(_Mutex);
+        _SleepingCount.fetch_add(1, std::memory_order_seq_cst);
+        _Condition.wait(Mutex, [&]() -> bool { return HasTask() || _Terminate; });
+        _SleepingCount.fetch_sub(1, std::memory_order_seq_cst);
 
-        SetThreadAffinity(_Threads.back(), i);
+        if (_Terminate && !HasTask())
+        {
+            return;
+        }
     }
 }
 
-FThreadPool::~FThreadPool()
+FThreadPool::FTaskNode* FThreadPool::AcquireTask(std::size_t WorkerIndex)
 {
-    Terminate();
+    // 顺序：指定给自己的任务 -> 自己的队列（LIFO，缓存友好） -> 外部提交的全局队列 -> 从其他线程队列顶端窃取
+    auto& Worker = *_Workers[WorkerIndex];
+    if (Worker.PinnedTaskCount.load(std::memory_order_acquire) > 0)
+    {
+        std::lock_guard<std::mutex> Lock(_GlobalMutex);
+        if (FTaskNode* Task = Worker.PinnedTasks.Pop())
+        {
+            Worker.PinnedTaskCount.fetch_sub(1, std::memory_order_seq_cst);
+            return Task;
+        }
+    }
+
+    FTaskNode* Task = nullptr;
+    if (auto LocalTask = Worker.Queue.Pop())
+    {
+        Task = *LocalTask;
+    }
+
+    if (Task == nullptr && _GlobalTaskCount.load(std::memory_order_acquire) > 0)
+    {
+        std::lock_guard<std::mutex> Lock(_GlobalMutex);
+        Task = _GlobalTasks.Pop();
+        if (Task != nullptr)
+        {
+            _GlobalTaskCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t WorkerCount = _Workers.size();
+    for (std::size_t i = 1; Task == nullptr && i < WorkerCount; ++i)
+    {
+        if (auto StolenTask = _Workers[(WorkerIndex + i) % WorkerCount]->Queue.Steal())
+        {
+            Task = *StolenTask;
+        }
+    }
+
+    if (Task != nullptr)
+    {
+        _PendingTaskCount.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    return Task;
+}
+
+FThreadPool::FTaskNode* FThreadPool::AllocateTaskNode(FTaskFreeList& FreeList, FTask&& Task)
+{
+    FTaskNode* Node = FreeList.Local;
+    if (Node == nullptr)
+    {
+        Node = FreeList.Returned.exchange(nullptr, std::memory_order_acquire);
+    }
+
+    if (Node == nullptr)
+    {
+        Node = new FTaskNode;
+        Node->Owner = &FreeList;
+    }
+    else
+    {
+        FreeList.Local = Node->Next;
+    }
+
+    Node->Task = std::move(Task);
+    Node->Next = nullptr;
+    return Node;
+}
+
+void FThreadPool::RunTask(FTaskNode* Node)
+{
+    try
+    {
+        Node->Task();
+    }
+    catch (...)
+    {
+        ReleaseTaskNode(Node);
+        throw;
+    }
+
+    ReleaseTaskNode(Node);
+}
+
+void FThreadPool::ReleaseTaskNode(FTaskNode* Node)
+{
+    // 先销毁可调用对象，及时释放其中捕获的资源
+    Node->Task.Reset();
+
+    // 任务只在工作线程上执行，节点属于本线程时直接放回，否则压入拥有者的 Returned
+    FTaskFreeList* Owner = Node->Owner;
+    if (Owner == &_Workers[kWorkerIndex]->FreeTasks)
+    {
+        Node->Next   = Owner->Local;
+        Owner->Local = Node;
+        return;
+    }
+
+    FTaskNode* Head = Owner->Returned.load(std::memory_order_relaxed);
+    do
+    {
+        Node->Next = Head;
+    } while (!Owner->Returned.compare_exchange_weak(Head, Node, std::memory_order_release, std::memory_order_relaxed));
+}
+
+FThreadPool::FTaskFreeList::~FTaskFreeList()
+{
+    // 线程池停止后所有节点都已回到拥有者的链表中
+    for (FTaskNode* Head : { Local, Returned.load(std::memory_order_acquire) })
+    {
+        while (Head != nullptr)
+        {
+            delete std::exchange(Head, Head->Next);
+        }
+    }
+}
+
+void FThreadPool::FTaskQueue::Push(FTaskNode* Node)
+{
+    Node->Next = nullptr;
+    if (Tail != nullptr)
+    {
+        Tail->Next = Node;
+    }
+    else
+    {
+        Head = Node;
+    }
+
+    Tail = Node;
+}
+
+FThreadPool::FTaskNode* FThreadPool::FTaskQueue::Pop()
+{
+    FTaskNode* Node = Head;
+    if (Node != nullptr)
+    {
+        Head = Node->Next;
+        if (Head == nullptr)
+        {
+            Tail = nullptr;
+        }
+    }
+
+    return Node;
 }
 
 void FThreadPool::SetThreadAffinity(std::thread& Thread, std::size_t CoreId) const
 {
+    const auto& Processors = _CoreProcessors[CoreId % _CoreProcessors.size()];
+    std::size_t Processor  = Processors[_kHyperThreadIndex % Processors.size()];
+
+#ifdef _WIN64
     HANDLE Handle = Thread.native_handle();
-    DWORD_PTR Mask = 0;
-    Mask = static_cast<DWORD_PTR>(Bit(CoreId * 2) + _kHyperThreadIndex);
+    DWORD_PTR Mask = static_cast<DWORD_PTR>(Bit(Processor));
     SetThreadAffinityMask(Handle, Mask);
+#else
+    cpu_set_t CpuSet;
+    CPU_ZERO(&CpuSet);
+    CPU_SET(Processor, &CpuSet);
+    pthread_setaffinity_np(Thread.native_handle(), sizeof(cpu_set_t), &CpuSet);
+#endif // _WIN64
 }
 
 namespace
 {
-    int GetPhysicalCoreCount()
+    void InterleaveNumaNodes(std::vector<std::vector<std::size_t>>& CoreProcessors, std::vector<int>& CoreNumaNodes)
+    {
+        std::map<int, std::vector<std::size_t>> NodeCores;
+        for (std::size_t i = 0; i != CoreProcessors.size(); ++i)
+        {
+            NodeCores[CoreNumaNodes[i]].emplace_back(i);
+        }
+
+        if (NodeCores.size() <= 1)
+        {
+            return;
+        }
+
+        // 依次从每个节点取一个核心，第 i 个工作线程落在第 i % 节点数 个节点上
+        std::vector<std::vector<std::size_t>> InterleavedProcessors;
+        std::vector<int> InterleavedNodes;
+        for (std::size_t Round = 0; InterleavedProcessors.size() != CoreProcessors.size(); ++Round)
+        {
+            for (const auto& [Node, Cores] : NodeCores)
+            {
+                if (Round < Cores.size())
+                {
+                    InterleavedProcessors.emplace_back(std::move(CoreProcessors[Cores[Round]]));
+                    InterleavedNodes.emplace_back(Node);
+                }
+            }
+        }
+
+        CoreProcessors = std::move(InterleavedProcessors);
+        CoreNumaNodes  = std::move(InterleavedNodes);
+    }
+
+#ifdef _WIN64
+    std::vector<std::vector<std::size_t>> GetCoreProcessors()
     {
         DWORD Length = 0;
         GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &Length);
@@ -90,12 +464,23 @@ namespace
         auto* BufferPtr = reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(Buffer.data());
         GetLogicalProcessorInformationEx(RelationProcessorCore, BufferPtr, &Length);
 
-        int CoreCount = 0;
+        std::vector<std::vector<std::size_t>> CoreProcessors;
         while (Length > 0)
         {
-            if (BufferPtr->Relationship == RelationProcessorCore)
+            // 亲和性掩码只覆盖第 0 个处理器组
+            if (BufferPtr->Relationship == RelationProcessorCore && BufferPtr->Processor.GroupMask[0].Group == 0)
             {
-                ++CoreCount;
+                std::vector<std::size_t> Processors;
+                KAFFINITY Mask = BufferPtr->Processor.GroupMask[0].Mask;
+                for (std::size_t i = 0; i != sizeof(KAFFINITY) * 8; ++i)
+                {
+                    if (Mask & Bit(i))
+                    {
+                        Processors.emplace_back(i);
+                    }
+                }
+
+                CoreProcessors.emplace_back(std::move(Processors));
             }
 
             Length -= BufferPtr->Size;
@@ -103,8 +488,165 @@ namespace
                 reinterpret_cast<std::uint8_t*>(BufferPtr) + BufferPtr->Size);
         }
 
-        return CoreCount;
+        return CoreProcessors;
+    }
+
+    std::vector<int> GetCoreNumaNodes(const std::vector<std::vector<std::size_t>>& CoreProcessors)
+    {
+        std::vector<int> CoreNumaNodes;
+        CoreNumaNodes.reserve(CoreProcessors.size());
+        for (const auto& Processors : CoreProcessors)
+        {
+            UCHAR Node = 0;
+            if (Processors.empty() || !GetNumaProcessorNode(static_cast<UCHAR>(Processors.front()), &Node) || Node == 0xFF)
+            {
+                Node = 0;
+            }
+
+            CoreNumaNodes.emplace_back(static_cast<int>(Node));
+        }
+
+        return CoreNumaNodes;
+    }
+
+    int GetCpuQuota()
+    {
+        return 0;
+    }
+#else
+    std::string ReadFirstLine(const std::string& Filename)
+    {
+        std::ifstream File(Filename);
+        std::string Line;
+        std::getline(File, Line);
+        return Line;
+    }
+
+    int ReadInt(const std::string& Filename, int Default)
+    {
+        std::string Line = ReadFirstLine(Filename);
+        return Line.empty() ? Default : std::atoi(Line.c_str());
+    }
+
+    std::vector<std::vector<std::size_t>> GetCoreProcessors()
+    {
+        // 只考虑进程允许运行的逻辑处理器，再按 (物理封装, 核心) 归并超线程
+        cpu_set_t AllowedSet;
+        CPU_ZERO(&AllowedSet);
+        if (sched_getaffinity(0, sizeof(cpu_set_t), &AllowedSet) != 0)
+        {
+            for (unsigned i = 0; i != std::max(std::thread::hardware_concurrency(), 1u); ++i)
+            {
+                CPU_SET(i, &AllowedSet);
+            }
+        }
+
+        std::map<std::pair<int, int>, std::vector<std::size_t>> Cores;
+        for (int Cpu = 0; Cpu != CPU_SETSIZE; ++Cpu)
+        {
+            if (!CPU_ISSET(Cpu, &AllowedSet))
+            {
+                continue;
+            }
+
+            std::string TopologyDirectory = "/sys/devices/system/cpu/cpu" + std::to_string(Cpu) + "/topology/";
+            int PackageId = ReadInt(TopologyDirectory + "physical_package_id", 0);
+            int CoreId    = ReadInt(TopologyDirectory + "core_id", Cpu); // 读不到拓扑时每个逻辑处理器单独算一个核心
+            Cores[{ PackageId, CoreId }].emplace_back(Cpu);
+        }
+
+        std::vector<std::vector<std::size_t>> CoreProcessors;
+        CoreProcessors.reserve(Cores.size());
+        for (auto& [Key, Processors] : Cores)
+        {
+            CoreProcessors.emplace_back(std::move(Processors));
+        }
+
+        return CoreProcessors;
+    }
+
+    std::vector<int> GetCoreNumaNodes(const std::vector<std::vector<std::size_t>>& CoreProcessors)
+    {
+        // 逻辑处理器所在的节点由 /sys/devices/system/cpu/cpuN/ 下的 nodeM 链接给出，没有该链接时视为单节点
+        std::vector<int> CoreNumaNodes;
+        CoreNumaNodes.reserve(CoreProcessors.size());
+        for (const auto& Processors : CoreProcessors)
+        {
+            int Node = 0;
+            if (!Processors.empty())
+            {
+                std::error_code Error;
+                std::filesystem::path CpuDirectory = "/sys/devices/system/cpu/cpu" + std::to_string(Processors.front());
+                for (const auto& Entry : std::filesystem::directory_iterator(CpuDirectory, Error))
+                {
+                    std::string Filename = Entry.path().filename().string();
+                    if (Filename.size() > 4 && Filename.starts_with("node") &&
+                        std::all_of(Filename.begin() + 4, Filename.end(), [](char Char) -> bool { return Char >= '0' && Char <= '9'; }))
+                    {
+                        Node = std::atoi(Filename.c_str() + 4);
+                        break;
+                    }
+                }
+            }
+
+            CoreNumaNodes.emplace_back(Node);
+        }
+
+        return CoreNumaNodes;
+    }
+
+    int GetCpuQuota()
+    {
+        // cgroup v2，"/proc/self/cgroup" 中形如 "0::/path" 的一行给出所在的控制组
+        std::ifstream CgroupFile("/proc/self/cgroup");
+        std::string Line;
+        std::string CgroupPath;
+        while (std::getline(CgroupFile, Line))
+        {
+            if (Line.starts_with("0::"))
+            {
+                CgroupPath = Line.substr(3);
+                break;
+            }
+        }
+
+        for (const std::string& Filename : { "/sys/fs/cgroup" + CgroupPath + "/cpu.max", std::string("/sys/fs/cgroup/cpu.max") })
+        {
+            std::string CpuMax = ReadFirstLine(Filename);
+            if (CpuMax.empty())
+            {
+                continue;
+            }
+
+            // 格式为 "$MAX $PERIOD"，$MAX 为 max 表示不限制
+            std::size_t Space = CpuMax.find(' ');
+            if (CpuMax.starts_with("max") || Space == std::string::npos)
+            {
+                return 0;
+            }
+
+            double Quota  = std::atof(CpuMax.substr(0, Space).c_str());
+            double Period = std::atof(CpuMax.substr(Space + 1).c_str());
+            return Period > 0.0 ? std::max(static_cast<int>(std::ceil(Quota / Period)), 1) : 0;
+        }
+
+        // cgroup v1，配额为 -1 表示不限制
+        for (const char* Directory : { "/sys/fs/cgroup/cpu/", "/sys/fs/cgroup/cpu,cpuacct/" })
+        {
+            std::string QuotaLine = ReadFirstLine(std::string(Directory) + "cpu.cfs_quota_us");
+            if (QuotaLine.empty())
+            {
+                continue;
+            }
+
+            double Quota  = std::atof(QuotaLine.c_str());
+            double Period = std::atof(ReadFirstLine(std::string(Directory) + "cpu.cfs_period_us").c_str());
+            return Quota > 0.0 && Period > 0.0 ? std::max(static_cast<int>(std::ceil(Quota / Period)), 1) : 0;
+        }
+
+        return 0;
     }
+#endif // _WIN64
 }
 
 _THREAD_END
@@ -1,18 +1,22 @@
 #pragma once
 
 #include <cstddef>
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
+#include <exception>
 #include <functional>
 #include <future>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "Engine/Core/Base/Base.h"
+#include "Engine/Core/Runtime/Threads/Task.h"
+#include "Engine/Core/Runtime/Threads/WorkStealingDeque.hpp"
 
 _NPGS_BEGIN
 _RUNTIME_BEGIN
@@ -24,12 +28,121 @@ public:
     template <typename Func, typename... Args>
     auto Submit(Func&& Pred, Args&&... Params);
 
-    void Terminate();
+    // 不需要返回值时使用，不创建 future
+    template <typename Func, typename... Args>
+    void SubmitDetached(Func&& Pred, Args&&... Params);
+
+    // 将 [Begin, End) 动态分块并行执行 Pred(ChunkBegin, ChunkEnd, Slot)，调用线程也参与执行
+    // 块大小随剩余数量递减（guided 调度），但不小于 Grain
+    // Slot 为参与者编号，取值在 [0, GetMaxThreadCount()) 内，同一编号的块不会并发执行，可用于索引线程私有的数据
+    template <typename Func>
+    void ParallelFor(std::size_t Begin, std::size_t End, std::size_t Grain, Func&& Pred);
+
+    // 将 [Begin, End) 均分为 ChunkCount 段，第 i 段由一次 Pred(ChunkBegin, ChunkEnd, i, Slot) 处理，各段动态分配给参与者
+    // 段的划分和编号只由 ChunkCount 决定，与线程数和调度无关，每段用编号播种有状态的对象（如随机数引擎）可以保持结果可复现
+    // Slot 的含义与 ParallelFor 相同
+    template <typename Func>
+    void ParallelForChunked(std::size_t Begin, std::size_t End, std::size_t ChunkCount, Func&& Pred);
+
+    // 每个参与者以 Identity 的副本为初值，按块调用 Reduce(ChunkBegin, ChunkEnd, Partial) 累积
+    // 结束后按参与者编号顺序调用 Combine(Result, Partial) 合并
+    // 块分给哪个参与者取决于调度，浮点求和等不满足结合律的运算结果不确定，需要确定的结果时应按块保存部分结果再按顺序合并
+    template <typename Ty, typename ReduceFunc, typename CombineFunc>
+    Ty ParallelReduce(std::size_t Begin, std::size_t End, std::size_t Grain, const Ty& Identity,
+                      ReduceFunc&& Reduce, CombineFunc&& Combine);
+
+    // 在每个工作线程上各执行一次 Pred(WorkerIndex)，这些任务不会被窃取，阻塞直到全部完成
+    template <typename Func>
+    void RunOnEachWorker(Func&& Pred);
+
+    // 将 [Begin, End) 按工作线程数静态均分，第 i 段固定由第 i 个工作线程执行 Pred(ChunkBegin, ChunkEnd, WorkerIndex)
+    // 数据由固定的线程首次写入（first-touch）时，内存页会分配在该线程所在的 NUMA 节点上
+    template <typename Func>
+    void ParallelForStatic(std::size_t Begin, std::size_t End, Func&& Pred);
+
+    // 先将 [First, Last) 分成不少于 Grain 个元素的块并行排序，再逐轮两两归并，不保证稳定
+    template <typename RandomIt, typename Compare = std::less<>>
+    void ParallelSort(RandomIt First, RandomIt Last, Compare Comp = Compare{}, std::size_t Grain = 4096);
+
+    // 生命周期管理，不能与其他线程的提交并发调用，也不能在工作线程中调用
+    // ThreadCount 不大于 0 时使用默认线程数（物理核心数，受 CPU 配额限制）
+    // 停止时会先执行完所有已提交的任务；停止期间提交的任务会在下次启动后执行
+    void Start(int ThreadCount = 0);
+    void Stop();
+    void Resize(int ThreadCount);
+    bool IsRunning() const;
+
+    // 在本线程池的工作线程中尝试取出并执行一个任务，用于等待时帮助执行，没有可执行的任务时返回 false
+    bool RunPendingTask();
+    bool IsWorkerThread() const;
+
     void ChangeHyperThread();
     int GetMaxThreadCount() const;
+    int GetNumaNodeCount() const;
+    int GetWorkerNumaNode(std::size_t WorkerIndex) const;
 
     static FThreadPool* GetInstance();
 
+private:
+    struct FParallelForState
+    {
+        std::atomic<std::size_t> NextIndex;
+        std::atomic<std::size_t> CompletedCount;
+        std::size_t              End;
+        std::size_t              TotalCount;
+        std::size_t              Grain;
+        std::size_t              SlotCount;
+        std::mutex               ExceptionMutex;
+        std::exception_ptr       Exception;
+    };
+
+    struct FBroadcastState
+    {
+        std::atomic<std::size_t> RemainingCount;
+        std::mutex               ExceptionMutex;
+        std::exception_ptr       Exception;
+    };
+
+    struct FTaskFreeList;
+
+    // 队列中保存的任务节点，执行后回到分配它的空闲链表中复用，提交小任务时不再分配内存
+    struct FTaskNode
+    {
+        FTask           Task;
+        FTaskNode*      Next{ nullptr };  // 在空闲链表或 FTaskQueue 中的下一个节点
+        FTaskFreeList*  Owner{ nullptr };
+    };
+
+    // 只有拥有者可以从 Local 取出节点，其他线程执行完任务后把节点压入 Returned，拥有者取空 Local 后整体取走
+    struct FTaskFreeList
+    {
+        FTaskNode*              Local{ nullptr };
+        std::atomic<FTaskNode*> Returned{ nullptr };
+
+        FTaskFreeList() = default;
+        FTaskFreeList(const FTaskFreeList&) = delete;
+        FTaskFreeList& operator=(const FTaskFreeList&) = delete;
+        ~FTaskFreeList();
+    };
+
+    // 通过 FTaskNode::Next 链接的先进先出队列，入队出队都不分配内存，由使用者加锁
+    struct FTaskQueue
+    {
+        FTaskNode* Head{ nullptr };
+        FTaskNode* Tail{ nullptr };
+
+        void Push(FTaskNode* Node);
+        FTaskNode* Pop();
+    };
+
+    struct FWorkerState
+    {
+        TWorkStealingDeque<FTaskNode*> Queue;          // 工作线程自己提交的任务
+        FTaskQueue                     PinnedTasks;    // 只能由该线程执行的任务，受 _GlobalMutex 保护
+        std::atomic<std::size_t>       PinnedTaskCount{ 0 };
+        FTaskFreeList                  FreeTasks;      // 该线程提交任务时使用的节点
+    };
+
 private:
     explicit FThreadPool();
     FThreadPool(const FThreadPool&) = delete;
@@ -39,17 +152,43 @@ private:
     FThreadPool& operator=(const FThreadPool&) = delete;
     FThreadPool& operator=(FThreadPool&&)      = delete;
 
+    template <typename Func>
+    static void RunParallelChunks(FParallelForState& State, Func& Pred, std::size_t Slot);
+
+    void StartImpl(int ThreadCount);
+    void StopImpl();
+    void Enqueue(FTask&& Task);
+    void EnqueuePinned(std::size_t WorkerIndex, FTask&& Task);
+    void WorkerLoop(std::size_t WorkerIndex);
+    FTaskNode* AcquireTask(std::size_t WorkerIndex);
+    FTaskNode* AllocateTaskNode(FTaskFreeList& FreeList, FTask&& Task);
+    void RunTask(FTaskNode* Node);
+    void ReleaseTaskNode(FTaskNode* Node);
     void SetThreadAffinity(std::thread& Thread, std::size_t CoreId) const;
 
 private:
-    std::vector<std::thread>          _Threads;
-    std::queue<std::function<void()>> _Tasks;
-    std::mutex                        _Mutex;
-    std::condition_variable           _Condition;
-    bool                              _Terminate;
-    int                               _kMaxThreadCount;
-    int                               _kPhysicalCoreCount;
-    int                               _kHyperThreadIndex;
+    std::vector<std::thread>                                  _Threads;
+    std::vector<std::unique_ptr<FWorkerState>>                _Workers;
+    FTaskQueue                                                _GlobalTasks;   // 外部线程提交的任务
+    FTaskFreeList                                             _ExternalFreeTasks; // 外部线程提交任务时使用的节点，Local 受 _GlobalMutex 保护
+    std::mutex                                                _GlobalMutex;
+    std::atomic<std::size_t>                                  _GlobalTaskCount;
+    std::atomic<std::size_t>                                  _PendingTaskCount;
+    std::atomic<std::size_t>                                  _SleepingCount;
+    std::mutex                                                _Mutex;         // 只用于休眠和唤醒
+    std::condition_variable                                   _Condition;
+    std::mutex                                                _LifecycleMutex;
+    bool                                                      _Terminate;
+    int                                                       _kDefaultThreadCount;
+    int                                                       _kMaxThreadCount;
+    int                                                       _kPhysicalCoreCount;
+    int                                                       _kHyperThreadIndex;
+    int                                                       _kNumaNodeCount;
+
+    // 每个物理核心包含的逻辑处理器编号，第二维下标为超线程序号
+    // 核心按 NUMA 节点交错排列，线程数少于核心数时各节点的线程数保持均衡
+    std::vector<std::vector<std::size_t>> _CoreProcessors;
+    std::vector<int>                      _CoreNumaNodes;
 };
 
 _THREAD_END
@@ -9,18 +9,305 @@ _THREAD_BEGIN
 template <typename Func, typename... Args>
 inline auto FThreadPool::Submit(Func&& Pred, Args&&... Params)
 {
-    using ReturnType = std::invoke_result_t<Func, Args...>;
-    auto Task = std::make_shared<std::packaged_task<ReturnType()>>(
-        std::bind(std::forward<Func>(Pred), std::forward<Args>(Params)...));
-    std::future<ReturnType> Future = Task->get_future();
+    using ReturnType = std::invoke_result_t<std::decay_t<Func>&, std::decay_t<Args>&...>;
+    std::promise<ReturnType> Promise;
+    std::future<ReturnType> Future = Promise.get_future();
+
+    Enqueue(FTask([Promise = std::move(Promise), Pred = std::forward<Func>(Pred),
+                   ...Params = std::forward<Args>(Params)]() mutable -> void
     {
-        std::unique_lock<std::mutex> Mutex(_Mutex);
-        _Tasks.emplace([Task]() -> void { (*Task)(); });
-    }
-    _Condition.notify_one();
+        try
+        {
+            if constexpr (std::is_void_v<ReturnType>)
+            {
+                std::invoke(Pred, Params...);
+                Promise.set_value();
+            }
+            else
+            {
+                Promise.set_value(std::invoke(Pred, Params...));
+            }
+        }
+        catch (...)
+        {
+            Promise.set_exception(std::current_exception());
+        }
+    }));
+
     return Future;
 }
 
+template <typename Func, typename... Args>
+inline void FThreadPool::SubmitDetached(Func&& Pred, Args&&... Params)
+{
+    Enqueue(FTask([Pred = std::forward<Func>(Pred), ...Params = std::forward<Args>(Params)]() mutable -> void
+    {
+        std::invoke(Pred, Params...);
+    }));
+}
+
+template <typename Func>
+inline void FThreadPool::ParallelFor(std::size_t Begin, std::size_t End, std::size_t Grain, Func&& Pred)
+{
+    if (Begin >= End)
+    {
+        return;
+    }
+
+    std::size_t TotalCount = End - Begin;
+    Grain = std::max<std::size_t>(Grain, 1);
+
+    auto State = std::make_shared<FParallelForState>();
+    State->NextIndex.store(Begin, std::memory_order_relaxed);
+    State->CompletedCount.store(0, std::memory_order_relaxed);
+    State->End        = End;
+    State->TotalCount = TotalCount;
+    State->Grain      = Grain;
+    State->SlotCount  = std::min<std::size_t>(std::max(_kMaxThreadCount, 1), (TotalCount + Grain - 1) / Grain);
+
+    // 未开始执行的辅助任务只持有共享状态，分不到块时不会访问 Pred，因此调用线程可以先于它们返回
+    for (std::size_t Slot = 1; Slot < State->SlotCount; ++Slot)
+    {
+        SubmitDetached([State, PredPtr = &Pred, Slot]() -> void
+        {
+            RunParallelChunks(*State, *PredPtr, Slot);
+        });
+    }
+
+    RunParallelChunks(*State, Pred, 0);
+
+    std::size_t CompletedCount = State->CompletedCount.load(std::memory_order_acquire);
+    while (CompletedCount != TotalCount)
+    {
+        State->CompletedCount.wait(CompletedCount, std::memory_order_acquire);
+        CompletedCount = State->CompletedCount.load(std::memory_order_acquire);
+    }
+
+    if (State->Exception != nullptr)
+    {
+        std::rethrow_exception(State->Exception);
+    }
+}
+
+template <typename Func>
+inline void FThreadPool::ParallelForChunked(std::size_t Begin, std::size_t End, std::size_t ChunkCount, Func&& Pred)
+{
+    if (Begin >= End || ChunkCount == 0)
+    {
+        return;
+    }
+
+    std::size_t TotalCount = End - Begin;
+    ParallelFor(0, ChunkCount, 1, [&](std::size_t FirstChunk, std::size_t LastChunk, std::size_t Slot) -> void
+    {
+        for (std::size_t ChunkIndex = FirstChunk; ChunkIndex != LastChunk; ++ChunkIndex)
+        {
+            std::size_t ChunkBegin = Begin + TotalCount * ChunkIndex / ChunkCount;
+            std::size_t ChunkEnd   = Begin + TotalCount * (ChunkIndex + 1) / ChunkCount;
+            if (ChunkBegin != ChunkEnd)
+            {
+                Pred(ChunkBegin, ChunkEnd, ChunkIndex, Slot);
+            }
+        }
+    });
+}
+
+template <typename Ty, typename ReduceFunc, typename CombineFunc>
+inline Ty FThreadPool::ParallelReduce(std::size_t Begin, std::size_t End, std::size_t Grain, const Ty& Identity,
+                                      ReduceFunc&& Reduce, CombineFunc&& Combine)
+{
+    std::vector<Ty> Partials(std::max(_kMaxThreadCount, 1), Identity);
+    ParallelFor(Begin, End, Grain, [&](std::size_t ChunkBegin, std::size_t ChunkEnd, std::size_t Slot) -> void
+    {
+        Reduce(ChunkBegin, ChunkEnd, Partials[Slot]);
+    });
+
+    Ty Result = Identity;
+    for (const Ty& Partial : Partials)
+    {
+        Combine(Result, Partial);
+    }
+
+    return Result;
+}
+
+template <typename Func>
+inline void FThreadPool::RunOnEachWorker(Func&& Pred)
+{
+    std::size_t WorkerCount = _Workers.size();
+    if (WorkerCount == 0)
+    {
+        return;
+    }
+
+    auto State = std::make_shared<FBroadcastState>();
+    State->RemainingCount.store(WorkerCount, std::memory_order_relaxed);
+
+    for (std::size_t WorkerIndex = 0; WorkerIndex != WorkerCount; ++WorkerIndex)
+    {
+        EnqueuePinned(WorkerIndex, FTask([State, PredPtr = &Pred, WorkerIndex]() -> void
+        {
+            try
+            {
+                (*PredPtr)(WorkerIndex);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> Lock(State->ExceptionMutex);
+                if (State->Exception == nullptr)
+                {
+                    State->Exception = std::current_exception();
+                }
+            }
+
+            if (State->RemainingCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                State->RemainingCount.notify_all();
+            }
+        }));
+    }
+
+    std::size_t RemainingCount = State->RemainingCount.load(std::memory_order_acquire);
+    while (RemainingCount != 0)
+    {
+        if (IsWorkerThread())
+        {
+            // 本线程的那一份也在等待执行，不能阻塞
+            if (!RunPendingTask())
+            {
+                std::this_thread::yield();
+            }
+        }
+        else
+        {
+            State->RemainingCount.wait(RemainingCount, std::memory_order_acquire);
+        }
+
+        RemainingCount = State->RemainingCount.load(std::memory_order_acquire);
+    }
+
+    if (State->Exception != nullptr)
+    {
+        std::rethrow_exception(State->Exception);
+    }
+}
+
+template <typename Func>
+inline void FThreadPool::ParallelForStatic(std::size_t Begin, std::size_t End, Func&& Pred)
+{
+    if (Begin >= End)
+    {
+        return;
+    }
+
+    std::size_t WorkerCount = _Workers.size();
+    if (WorkerCount == 0)
+    {
+        Pred(Begin, End, static_cast<std::size_t>(0));
+        return;
+    }
+
+    std::size_t TotalCount = End - Begin;
+    RunOnEachWorker([&](std::size_t WorkerIndex) -> void
+    {
+        std::size_t ChunkBegin = Begin + TotalCount * WorkerIndex / WorkerCount;
+        std::size_t ChunkEnd   = Begin + TotalCount * (WorkerIndex + 1) / WorkerCount;
+        if (ChunkBegin != ChunkEnd)
+        {
+            Pred(ChunkBegin, ChunkEnd, WorkerIndex);
+        }
+    });
+}
+
+template <typename RandomIt, typename Compare>
+inline void FThreadPool::ParallelSort(RandomIt First, RandomIt Last, Compare Comp, std::size_t Grain)
+{
+    std::size_t TotalCount = static_cast<std::size_t>(Last - First);
+    Grain = std::max<std::size_t>(Grain, 1);
+    std::size_t BlockCount = std::min<std::size_t>(std::max(_kMaxThreadCount, 1), (TotalCount + Grain - 1) / Grain);
+    if (BlockCount <= 1)
+    {
+        std::sort(First, Last, Comp);
+        return;
+    }
+
+    // 各块大小相差不超过 1
+    std::vector<std::size_t> Bounds(BlockCount + 1);
+    for (std::size_t i = 0; i <= BlockCount; ++i)
+    {
+        Bounds[i] = TotalCount * i / BlockCount;
+    }
+
+    ParallelFor(0, BlockCount, 1, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+    {
+        for (std::size_t i = Begin; i != End; ++i)
+        {
+            std::sort(First + Bounds[i], First + Bounds[i + 1], Comp);
+        }
+    });
+
+    // 每轮合并相邻的两个有序段，段数减半
+    for (std::size_t Width = 1; Width < BlockCount; Width *= 2)
+    {
+        std::size_t MergeCount = (BlockCount + 2 * Width - 1) / (2 * Width);
+        ParallelFor(0, MergeCount, 1, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+        {
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                std::size_t Low  = i * 2 * Width;
+                std::size_t Mid  = std::min(Low + Width, BlockCount);
+                std::size_t High = std::min(Low + 2 * Width, BlockCount);
+                if (Mid != High)
+                {
+                    std::inplace_merge(First + Bounds[Low], First + Bounds[Mid], First + Bounds[High], Comp);
+                }
+            }
+        });
+    }
+}
+
+template <typename Func>
+inline void FThreadPool::RunParallelChunks(FParallelForState& State, Func& Pred, std::size_t Slot)
+{
+    std::size_t Index = State.NextIndex.load(std::memory_order_relaxed);
+    while (Index < State.End)
+    {
+        std::size_t Remaining = State.End - Index;
+        std::size_t ChunkSize = std::min(Remaining, std::max(State.Grain, Remaining / (2 * State.SlotCount)));
+        if (!State.NextIndex.compare_exchange_weak(Index, Index + ChunkSize, std::memory_order_relaxed))
+        {
+            continue;
+        }
+
+        std::size_t FinishedCount = ChunkSize;
+        try
+        {
+            Pred(Index, Index + ChunkSize, Slot);
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> Lock(State.ExceptionMutex);
+                if (State.Exception == nullptr)
+                {
+                    State.Exception = std::current_exception();
+                }
+            }
+
+            // 放弃剩余的块，未分配的数量直接计入完成数
+            std::size_t Skipped = State.NextIndex.exchange(State.End, std::memory_order_relaxed);
+            FinishedCount += State.End - std::min(Skipped, State.End);
+        }
+
+        if (State.CompletedCount.fetch_add(FinishedCount, std::memory_order_acq_rel) + FinishedCount == State.TotalCount)
+        {
+            State.CompletedCount.notify_all();
+        }
+
+        Index = State.NextIndex.load(std::memory_order_relaxed);
+    }
+}
+
 NPGS_INLINE void FThreadPool::ChangeHyperThread()
 {
     _kHyperThreadIndex = 1 - _kHyperThreadIndex;
@@ -31,6 +318,16 @@ NPGS_INLINE int FThreadPool::GetMaxThreadCount() const
     return _kMaxThreadCount;
 }
 
+NPGS_INLINE int FThreadPool::GetNumaNodeCount() const
+{
+    return _kNumaNodeCount;
+}
+
+NPGS_INLINE int FThreadPool::GetWorkerNumaNode(std::size_t WorkerIndex) const
+{
+    return _CoreNumaNodes[WorkerIndex % _CoreNumaNodes.size()];
+}
+
 _THREAD_END
 _RUNTIME_END
 _NPGS_END
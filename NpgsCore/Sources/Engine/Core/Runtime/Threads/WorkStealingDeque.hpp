@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "Engine/Core/Base/Base.h"
+
+_NPGS_BEGIN
+_RUNTIME_BEGIN
+_THREAD_BEGIN
+
+// Chase-Lev 无锁双端队列（采用 Lê 等人给出的 C11 内存序版本）
+// 只有拥有者线程可以调用 Push 和 Pop，在底端进出；其他线程通过 Steal 从顶端窃取
+template <typename Ty>
+requires std::is_trivially_copyable_v<Ty>
+class TWorkStealingDeque
+{
+public:
+    explicit TWorkStealingDeque(std::int64_t Capacity = 256)
+        : _Top(0), _Bottom(0), _Array(new FRingBuffer(Capacity))
+    {
+        _RetiredBuffers.emplace_back(_Array.load(std::memory_order_relaxed));
+    }
+
+    TWorkStealingDeque(const TWorkStealingDeque&) = delete;
+    TWorkStealingDeque& operator=(const TWorkStealingDeque&) = delete;
+
+    void Push(Ty Item)
+    {
+        std::int64_t Bottom = _Bottom.load(std::memory_order_relaxed);
+        std::int64_t Top    = _Top.load(std::memory_order_acquire);
+        FRingBuffer* Array  = _Array.load(std::memory_order_relaxed);
+
+        if (Bottom - Top > Array->Capacity - 1)
+        {
+            Array = Grow(Array, Top, Bottom);
+        }
+
+        Array->Store(Bottom, Item);
+        std::atomic_thread_fence(std::memory_order_release);
+        _Bottom.store(Bottom + 1, std::memory_order_relaxed);
+    }
+
+    std::optional<Ty> Pop()
+    {
+        std::int64_t Bottom = _Bottom.load(std::memory_order_relaxed) - 1;
+        FRingBuffer* Array  = _Array.load(std::memory_order_relaxed);
+        _Bottom.store(Bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t Top = _Top.load(std::memory_order_relaxed);
+
+        std::optional<Ty> Result;
+        if (Top <= Bottom)
+        {
+            Result = Array->Load(Bottom);
+            if (Top == Bottom)
+            {
+                // 只剩最后一个元素，与窃取者竞争
+                if (!_Top.compare_exchange_strong(Top, Top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    Result.reset();
+                }
+
+                _Bottom.store(Bottom + 1, std::memory_order_relaxed);
+            }
+        }
+        else
+        {
+            _Bottom.store(Bottom + 1, std::memory_order_relaxed);
+        }
+
+        return Result;
+    }
+
+    std::optional<Ty> Steal()
+    {
+        std::int64_t Top = _Top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t Bottom = _Bottom.load(std::memory_order_acquire);
+
+        if (Top < Bottom)
+        {
+            FRingBuffer* Array = _Array.load(std::memory_order_acquire);
+            Ty Item = Array->Load(Top);
+            if (!_Top.compare_exchange_strong(Top, Top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return std::nullopt;
+            }
+
+            return Item;
+        }
+
+        return std::nullopt;
+    }
+
+    bool Empty() const
+    {
+        std::int64_t Bottom = _Bottom.load(std::memory_order_relaxed);
+        std::int64_t Top    = _Top.load(std::memory_order_relaxed);
+        return Bottom <= Top;
+    }
+
+private:
+    struct FRingBuffer
+    {
+        explicit FRingBuffer(std::int64_t Capacity)
+            : Capacity(Capacity), Mask(Capacity - 1), Data(std::make_unique<std::atomic<Ty>[]>(Capacity))
+        {
+        }
+
+        void Store(std::int64_t Index, Ty Item)
+        {
+            Data[Index & Mask].store(Item, std::memory_order_relaxed);
+        }
+
+        Ty Load(std::int64_t Index) const
+        {
+            return Data[Index & Mask].load(std::memory_order_relaxed);
+        }
+
+        std::int64_t                       Capacity; // 必须是 2 的幂
+        std::int64_t                       Mask;
+        std::unique_ptr<std::atomic<Ty>[]> Data;
+    };
+
+    FRingBuffer* Grow(FRingBuffer* Array, std::int64_t Top, std::int64_t Bottom)
+    {
+        auto* NewArray = new FRingBuffer(Array->Capacity * 2);
+        for (std::int64_t i = Top; i != Bottom; ++i)
+        {
+            NewArray->Store(i, Array->Load(i));
+        }
+
+        // 窃取者可能仍在读旧数组，旧数组保留到队列析构时再释放
+        _RetiredBuffers.emplace_back(NewArray);
+        _Array.store(NewArray, std::memory_order_release);
+        return NewArray;
+    }
+
+private:
+    alignas(64) std::atomic<std::int64_t> _Top;
+    alignas(64) std::atomic<std::int64_t> _Bottom;
+    alignas(64) std::atomic<FRingBuffer*> _Array;
+    std::vector<std::unique_ptr<FRingBuffer>> _RetiredBuffers; // 只由拥有者线程修改
+};
+
+_THREAD_END
+_RUNTIME_END
+_NPGS_END
@@ -7,8 +7,6 @@
 #include "Engine/Core/Math/NumericConstants.h"
 #include "Engine/Core/Types/Properties/Intelli/Civilization.h"
 
-#define DEBUG_OUTPUT
-
 _NPGS_BEGIN
 _SYSTEM_BEGIN
 _GENERATOR_BEGIN
@@ -60,6 +58,15 @@ void FCivilizationGenerator::GenerateCivilization(const Astro::AStar* Star, floa
 #endif // DEBUG_OUTPUT
 }
 
+void FCivilizationGenerator::Reseed(const Util::FCounterSeedSequence& SeedSequence)
+{
+    _RandomEngine.seed(SeedSequence);
+    _AsiFiltedProbability.Reset();
+    _DestroyedByDisasterProbability.Reset();
+    _LifeOccurrenceProbability.Reset();
+    _CommonGenerator.Reset();
+}
+
 void FCivilizationGenerator::GenerateLife(double StarAge, float PoyntingVector, Astro::APlanet* Planet)
 {
     // 计算生命演化阶段
@@ -23,6 +23,8 @@ public:
     ~FCivilizationGenerator() = default;
 
     void GenerateCivilization(const Astro::AStar* Star, float PoyntingVector, Astro::APlanet* Planet);
+    // 重新播种并清除各分布缓存的状态
+    void Reseed(const Util::FCounterSeedSequence& SeedSequence);
 
 private:
     void GenerateLife(double StarAge, float PoyntingVector, Astro::APlanet* Planet);
@@ -17,8 +17,6 @@
 #include "Engine/Core/Types/Properties/StellarClass.h"
 #include "Engine/Utils/Utils.h"
 
-#define DEBUG_OUTPUT
-
 _NPGS_BEGIN
 _SYSTEM_BEGIN
 _GENERATOR_BEGIN
@@ -61,7 +59,11 @@ FOrbitalGenerator::FOrbitalGenerator(const std::seed_seq& SeedSequence, float Un
 
     _AsteroidUpperLimit(AsteroidUpperLimit),
     _UniverseAge(UniverseAge),
-    _bContainUltravioletHabitableZone(bContainUltravioletHabitableZone)
+    _bContainUltravioletHabitableZone(bContainUltravioletHabitableZone),
+
+    _CounterSeedKey(0),
+    _SystemSeedCounter(0),
+    _bUseCounterSeed(false)
 {
     std::vector<std::uint32_t> Seeds(SeedSequence.size());
     SeedSequence.param(Seeds.begin());
@@ -74,6 +76,11 @@ FOrbitalGenerator::FOrbitalGenerator(const std::seed_seq& SeedSequence, float Un
 
 void FOrbitalGenerator::GenerateOrbitals(Astro::FStellarSystem& System)
 {
+    if (_bUseCounterSeed)
+    {
+        Reseed(_SystemSeedCounter, _kSystemStream);
+    }
+
     if (System.StarsData().size() == 2)
     {
         GenerateBinaryOrbit(System);
@@ -176,6 +183,50 @@ void FOrbitalGenerator::GenerateOrbitals(Astro::FStellarSystem& System)
     }
 }
 
+FOrbitalGenerator& FOrbitalGenerator::SetCounterSeedKey(std::uint64_t Key)
+{
+    _CounterSeedKey  = Key;
+    _bUseCounterSeed = true;
+    return *this;
+}
+
+FOrbitalGenerator& FOrbitalGenerator::SetSystemSeedCounter(std::uint64_t Counter)
+{
+    _SystemSeedCounter = Counter;
+    return *this;
+}
+
+FOrbitalGenerator& FOrbitalGenerator::SetSegmentSeedKey(std::uint64_t Key)
+{
+    _CounterSeedKey = Key;
+    return *this;
+}
+
+void FOrbitalGenerator::ReseedSegment(std::uint64_t SegmentIndex)
+{
+    Reseed(SegmentIndex, _kSegmentStream);
+}
+
+void FOrbitalGenerator::Reseed(std::uint64_t Counter, std::uint64_t Stream)
+{
+    Util::FCounterSeedSequence SeedSequence(_CounterSeedKey, Counter, Stream);
+    _RandomEngine.seed(SeedSequence);
+
+    for (auto& Probability : _RingsProbabilities)
+    {
+        Probability.Reset();
+    }
+
+    _AsteroidBeltProbability.Reset();
+    _MigrationProbability.Reset();
+    _ScatteringProbability.Reset();
+    _WalkInProbability.Reset();
+    _BinaryPeriodDistribution.Reset();
+    _CommonGenerator.Reset();
+
+    _CivilizationGenerator->Reseed(Util::FCounterSeedSequence(_CounterSeedKey, Counter, Stream + 1));
+}
+
 void FOrbitalGenerator::GenerateBinaryOrbit(Astro::FStellarSystem& System)
 {
     auto* SystemBaryCenter = System.GetBaryCenter();
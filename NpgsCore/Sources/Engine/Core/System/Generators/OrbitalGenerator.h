@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <array>
 #include <memory>
 #include <random>
@@ -51,7 +52,17 @@ public:
 
     void GenerateOrbitals(Astro::FStellarSystem& System);
 
+    // 开启计数器种子模式，每次生成前用 (Key, 恒星系编号) 重新播种，结果只取决于 Key 和编号
+    FOrbitalGenerator& SetCounterSeedKey(std::uint64_t Key);
+    // 指定下一次生成的恒星系编号
+    FOrbitalGenerator& SetSystemSeedCounter(std::uint64_t Counter);
+    // 非计数器种子模式下按固定的段播种，ReseedSegment 后的随机数只取决于 Key 和段编号，与由哪个生成器处理无关
+    FOrbitalGenerator& SetSegmentSeedKey(std::uint64_t Key);
+    void ReseedSegment(std::uint64_t SegmentIndex);
+
 private:
+    // 轨道使用 Stream，文明使用 Stream + 1
+    void Reseed(std::uint64_t Counter, std::uint64_t Stream);
     void GenerateBinaryOrbit(Astro::FStellarSystem& System);
     void GeneratePlanets(std::size_t StarIndex, Astro::FOrbit::FOrbitalDetails& ParentStar, Astro::FStellarSystem& System);
     void GenerateOrbitElements(Astro::FOrbit& Orbit);
@@ -107,6 +118,13 @@ private:
     float _RingsParentLowerLimit;
     float _UniverseAge;
     bool  _bContainUltravioletHabitableZone;
+
+    std::uint64_t _CounterSeedKey;
+    std::uint64_t _SystemSeedCounter;
+    bool          _bUseCounterSeed;
+
+    static constexpr std::uint64_t _kSystemStream  = 0; // 计数器种子模式和按段播种使用的随机数流
+    static constexpr std::uint64_t _kSegmentStream = 2;
 };
 
 _GENERATOR_END
@@ -0,0 +1,502 @@
+#include "SlotGenerator.h"
+
+#include <cmath>
+#include <algorithm>
+#include <bit>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include "Engine/Utils/Random.hpp"
+
+_NPGS_BEGIN
+_SYSTEM_BEGIN
+_GENERATOR_BEGIN
+
+// Tool functions
+// --------------
+namespace
+{
+    constexpr std::uint64_t kSplitStream  = 1; // 把节点的格子数分配给子节点
+    constexpr std::uint64_t kSampleStream = 2; // 叶子内的拒绝采样
+    constexpr int           kMaxAttempts  = 1 << 16;
+    constexpr int           kMassGridSize = 16;
+
+    glm::vec3 GetOctantOffset(int Octant)
+    {
+        return glm::vec3(Octant & 4 ? 1.0f : -1.0f, Octant & 2 ? 1.0f : -1.0f, Octant & 1 ? 1.0f : -1.0f);
+    }
+
+    int GetKeyLevel(std::uint64_t Key)
+    {
+        return (std::bit_width(Key) - 1) / 3;
+    }
+
+    // 把不同深度的路径编码对齐到最大深度，按它排序就是深度优先的遍历顺序
+    std::uint64_t GetTraversalKey(std::uint64_t Key)
+    {
+        return Key << (3 * (FSlotGenerator::kMaxDepth - GetKeyLevel(Key)));
+    }
+}
+
+// FSlotGenerator implementations
+// ------------------------------
+FSlotGenerator::FSlotGenerator(std::shared_ptr<const IStellarDensityModel> DensityModel, const glm::vec3& Center, float Radius,
+                               std::uint64_t SeedKey, std::size_t LeafCapacity)
+    :
+    _DensityModel(std::move(DensityModel)),
+    _ThreadPool(Runtime::Thread::FThreadPool::GetInstance()),
+    _SlotOffsets(1, 0),
+    _Center(Center),
+    _Anchor(0.0f),
+    _Radius(Radius),
+    _SeedKey(SeedKey),
+    _LeafCapacity(std::max<std::size_t>(LeafCapacity, 1)),
+    _AnchorLeaf(kInvalidIndex),
+    _bHasAnchor(false)
+{
+}
+
+void FSlotGenerator::Build(std::size_t SlotCount)
+{
+    _Leaves.clear();
+    _SlotOffsets.assign(1, 0);
+    _AnchorLeaf = kInvalidIndex;
+
+    if (SlotCount == 0)
+    {
+        return;
+    }
+
+    // 叶子的大小取决于归一化系数，先用粗网格估计总质量，建好树后按各叶子估计的质量复核，偏差超过一倍时重建一次
+    double TotalMass = EstimateTotalMass();
+    std::vector<std::vector<FNode>>  Levels;
+    std::vector<std::vector<double>> Masses;
+    for (int Pass = 0; Pass != 2; ++Pass)
+    {
+        if (TotalMass <= 0.0)
+        {
+            throw std::runtime_error("Stellar density is zero in the whole region.");
+        }
+
+        BuildTree(TotalMass * static_cast<double>(_LeafCapacity) / static_cast<double>(SlotCount), Levels);
+        Masses = EstimateMasses(Levels);
+
+        double TreeMass = Masses.front().front();
+        bool bAccurate  = TreeMass < 2.0 * TotalMass && 2.0 * TreeMass > TotalMass;
+        TotalMass = TreeMass;
+        if (bAccurate)
+        {
+            break;
+        }
+    }
+
+    if (TotalMass <= 0.0)
+    {
+        throw std::runtime_error("Stellar density is zero in the whole region.");
+    }
+
+    std::vector<std::vector<std::uint64_t>> Counts = DistributeSlots(SlotCount, Levels, Masses);
+    Masses.clear();
+
+    // 只保留含有格子的叶子
+    std::vector<std::pair<FLeaf, std::uint64_t>> Leaves;
+    for (std::size_t Level = 0; Level != Levels.size(); ++Level)
+    {
+        for (std::size_t i = 0; i != Levels[Level].size(); ++i)
+        {
+            const FNode& Node = Levels[Level][i];
+            if (Node.FirstChild == kInvalidIndex && Counts[Level][i] != 0)
+            {
+                Leaves.emplace_back(FLeaf{ Node.Center, Node.Radius, Node.MaxDensity, Node.Key }, Counts[Level][i]);
+            }
+        }
+    }
+
+    Levels.clear();
+    Counts.clear();
+
+    _ThreadPool->ParallelSort(Leaves.begin(), Leaves.end(),
+                              [](const std::pair<FLeaf, std::uint64_t>& Lhs, const std::pair<FLeaf, std::uint64_t>& Rhs) -> bool
+    {
+        return GetTraversalKey(Lhs.first.Key) < GetTraversalKey(Rhs.first.Key);
+    });
+
+    _Leaves.reserve(Leaves.size());
+    _SlotOffsets.reserve(Leaves.size() + 1);
+    for (const auto& [Leaf, Count] : Leaves)
+    {
+        _Leaves.emplace_back(Leaf);
+        _SlotOffsets.emplace_back(_SlotOffsets.back() + static_cast<std::size_t>(Count));
+    }
+
+    // 锚点落在叶子的边界上时与 FindLeaf 选择同一个叶子，按位置查询时能找到它
+    if (_bHasAnchor)
+    {
+        _AnchorLeaf = FindLeaf(_Anchor);
+    }
+}
+
+void FSlotGenerator::GenerateSlots(std::size_t FirstLeaf, std::size_t LastLeaf, std::vector<glm::vec3>& Slots) const
+{
+    std::size_t FirstSlot = Slots.size();
+    Slots.resize(FirstSlot + _SlotOffsets[LastLeaf] - _SlotOffsets[FirstLeaf]);
+
+    glm::vec3* Output = Slots.data() + FirstSlot;
+    _ThreadPool->ParallelFor(FirstLeaf, LastLeaf, 16, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+    {
+        for (std::size_t i = Begin; i != End; ++i)
+        {
+            SampleLeaf(i, Output + (_SlotOffsets[i] - _SlotOffsets[FirstLeaf]));
+        }
+    });
+}
+
+std::vector<std::pair<std::size_t, std::size_t>> FSlotGenerator::Partition(std::size_t MaxSlotCount) const
+{
+    std::vector<std::pair<std::size_t, std::size_t>> Ranges;
+    std::size_t First = 0;
+    for (std::size_t i = 0; i != _Leaves.size(); ++i)
+    {
+        if (i != First && _SlotOffsets[i + 1] - _SlotOffsets[First] > MaxSlotCount)
+        {
+            Ranges.emplace_back(First, i);
+            First = i;
+        }
+    }
+
+    if (First != _Leaves.size())
+    {
+        Ranges.emplace_back(First, _Leaves.size());
+    }
+
+    return Ranges;
+}
+
+std::size_t FSlotGenerator::FindLeaf(const glm::vec3& Point) const
+{
+    if (!glm::all(glm::lessThanEqual(glm::abs(Point - _Center), glm::vec3(_Radius))))
+    {
+        return kInvalidIndex;
+    }
+
+    // 计算 Point 在最大深度上的路径编码，包含它的叶子是遍历键不大于它的最后一个叶子
+    std::uint64_t Key    = 1;
+    glm::vec3     Center = _Center;
+    float         Radius = _Radius;
+    for (int Level = 0; Level != kMaxDepth; ++Level)
+    {
+        int Octant = (Point.x >= Center.x ? 4 : 0) | (Point.y >= Center.y ? 2 : 0) | (Point.z >= Center.z ? 1 : 0);
+        Radius *= 0.5f;
+        Center += GetOctantOffset(Octant) * Radius;
+        Key = (Key << 3) | static_cast<std::uint64_t>(Octant);
+    }
+
+    auto it = std::upper_bound(_Leaves.begin(), _Leaves.end(), Key, [](std::uint64_t PointKey, const FLeaf& Leaf) -> bool
+    {
+        return PointKey < GetTraversalKey(Leaf.Key);
+    });
+
+    if (it == _Leaves.begin())
+    {
+        return kInvalidIndex;
+    }
+
+    --it;
+    bool bContains = (Key >> (3 * (kMaxDepth - GetKeyLevel(it->Key)))) == it->Key;
+    return bContains ? static_cast<std::size_t>(it - _Leaves.begin()) : kInvalidIndex;
+}
+
+std::vector<std::size_t> FSlotGenerator::CollectLeavesInRadius(const glm::vec3& Point, float Radius) const
+{
+    struct FRange
+    {
+        glm::vec3     Center;
+        float         Radius;
+        std::uint64_t Key;
+        std::size_t   FirstLeaf;
+        std::size_t   LastLeaf;
+    };
+
+    // 从根开始下降，子树中的叶子在 _Leaves 中是连续的一段，没有叶子或与球不相交的子树直接跳过
+    std::vector<std::size_t> LeafIndices;
+    std::vector<FRange> Stack{ { _Center, _Radius, 1, 0, _Leaves.size() } };
+    while (!Stack.empty())
+    {
+        FRange Range = Stack.back();
+        Stack.pop_back();
+
+        glm::vec3 Distance = glm::max(glm::abs(Point - Range.Center) - glm::vec3(Range.Radius), glm::vec3(0.0f));
+        if (Range.FirstLeaf == Range.LastLeaf || glm::dot(Distance, Distance) > Radius * Radius)
+        {
+            continue;
+        }
+
+        if (_Leaves[Range.FirstLeaf].Key == Range.Key)
+        {
+            LeafIndices.emplace_back(Range.FirstLeaf);
+            continue;
+        }
+
+        // 逆序压栈，出栈时按遍历顺序处理
+        float NextRadius = Range.Radius * 0.5f;
+        std::size_t LastLeaf = Range.LastLeaf;
+        for (int Octant = 7; Octant >= 0; --Octant)
+        {
+            std::uint64_t NextKey = (Range.Key << 3) | static_cast<std::uint64_t>(Octant);
+            std::uint64_t TraversalKey = GetTraversalKey(NextKey);
+            auto First = std::lower_bound(_Leaves.begin() + Range.FirstLeaf, _Leaves.begin() + LastLeaf, TraversalKey,
+                                          [](const FLeaf& Leaf, std::uint64_t Key) -> bool
+            {
+                return GetTraversalKey(Leaf.Key) < Key;
+            });
+
+            std::size_t FirstLeaf = static_cast<std::size_t>(First - _Leaves.begin());
+            Stack.emplace_back(Range.Center + GetOctantOffset(Octant) * NextRadius, NextRadius, NextKey, FirstLeaf, LastLeaf);
+            LastLeaf = FirstLeaf;
+        }
+    }
+
+    return LeafIndices;
+}
+
+void FSlotGenerator::SetAnchor(const glm::vec3& Point)
+{
+    _Anchor     = Point;
+    _bHasAnchor = true;
+}
+
+std::size_t FSlotGenerator::GetLeafCount() const
+{
+    return _Leaves.size();
+}
+
+std::size_t FSlotGenerator::GetSlotCount() const
+{
+    return _SlotOffsets.back();
+}
+
+std::size_t FSlotGenerator::GetSlotOffset(std::size_t LeafIndex) const
+{
+    return _SlotOffsets[LeafIndex];
+}
+
+double FSlotGenerator::EstimateTotalMass() const
+{
+    float  CellRadius = _Radius / kMassGridSize;
+    double CellVolume = std::pow(2.0 * CellRadius, 3.0);
+
+    // 各格子的质量并行计算，再按下标顺序求和，浮点结果与线程数和调度无关
+    std::vector<double> CellMasses(kMassGridSize * kMassGridSize * kMassGridSize);
+    _ThreadPool->ParallelFor(0, CellMasses.size(), 64, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+    {
+        for (std::size_t i = Begin; i != End; ++i)
+        {
+            glm::vec3 Cell(static_cast<float>(i / (kMassGridSize * kMassGridSize)),
+                           static_cast<float>(i / kMassGridSize % kMassGridSize),
+                           static_cast<float>(i % kMassGridSize));
+
+            glm::vec3 Position = _Center - glm::vec3(_Radius) + (2.0f * Cell + glm::vec3(1.0f)) * CellRadius;
+            CellMasses[i] = _DensityModel->GetDensity(Position) * CellVolume;
+        }
+    });
+
+    return std::accumulate(CellMasses.begin(), CellMasses.end(), 0.0);
+}
+
+double FSlotGenerator::EstimateNodeMass(const FNode& Node) const
+{
+    if (Node.MaxDensity <= 0.0f)
+    {
+        return 0.0;
+    }
+
+    // 在 8 个子立方体的中心取样
+    double Density = 0.0;
+    for (int Octant = 0; Octant != 8; ++Octant)
+    {
+        Density += _DensityModel->GetDensity(Node.Center + GetOctantOffset(Octant) * (0.5f * Node.Radius));
+    }
+
+    return Density / 8.0 * std::pow(2.0 * Node.Radius, 3.0);
+}
+
+void FSlotGenerator::BuildTree(double MaxLeafMass, std::vector<std::vector<FNode>>& Levels) const
+{
+    Levels.assign(1, { FNode{ _Center, _Radius, _DensityModel->GetMaxDensity(_Center, _Radius), 1, kInvalidIndex } });
+
+    // 逐层建立，每层先并行判断哪些节点需要细分，再按前缀和给子节点分配连续的下标
+    for (int Level = 0; Level != kMaxDepth; ++Level)
+    {
+        std::vector<FNode>& Nodes = Levels[Level];
+        std::vector<std::size_t> ChildOffsets(Nodes.size() + 1);
+        _ThreadPool->ParallelFor(0, Nodes.size(), 4096, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+        {
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                double BoundMass = Nodes[i].MaxDensity * std::pow(2.0 * Nodes[i].Radius, 3.0);
+                ChildOffsets[i + 1] = BoundMass > MaxLeafMass ? 8 : 0;
+            }
+        });
+
+        std::partial_sum(ChildOffsets.begin(), ChildOffsets.end(), ChildOffsets.begin());
+        if (ChildOffsets.back() == 0)
+        {
+            break;
+        }
+
+        std::vector<FNode> Children(ChildOffsets.back());
+        _ThreadPool->ParallelFor(0, Nodes.size(), 1024, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+        {
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                FNode& Node = Nodes[i];
+                if (ChildOffsets[i + 1] == ChildOffsets[i])
+                {
+                    continue;
+                }
+
+                Node.FirstChild  = ChildOffsets[i];
+                float NextRadius = Node.Radius * 0.5f;
+                for (int Octant = 0; Octant != 8; ++Octant)
+                {
+                    glm::vec3 NextCenter = Node.Center + GetOctantOffset(Octant) * NextRadius;
+                    Children[Node.FirstChild + Octant] =
+                    {
+                        NextCenter, NextRadius, _DensityModel->GetMaxDensity(NextCenter, NextRadius),
+                        (Node.Key << 3) | static_cast<std::uint64_t>(Octant), kInvalidIndex
+                    };
+                }
+            }
+        });
+
+        Levels.emplace_back(std::move(Children));
+    }
+}
+
+std::vector<std::vector<double>> FSlotGenerator::EstimateMasses(const std::vector<std::vector<FNode>>& Levels) const
+{
+    // 叶子取样估计，内部节点自下而上求和
+    std::vector<std::vector<double>> Masses(Levels.size());
+    for (std::size_t Level = Levels.size(); Level-- != 0;)
+    {
+        const std::vector<FNode>& Nodes = Levels[Level];
+        Masses[Level].resize(Nodes.size());
+        _ThreadPool->ParallelFor(0, Nodes.size(), 256, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+        {
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                const FNode& Node = Nodes[i];
+                if (Node.FirstChild == kInvalidIndex)
+                {
+                    Masses[Level][i] = EstimateNodeMass(Node);
+                    continue;
+                }
+
+                double Mass = 0.0;
+                for (int Octant = 0; Octant != 8; ++Octant)
+                {
+                    Mass += Masses[Level + 1][Node.FirstChild + Octant];
+                }
+
+                Masses[Level][i] = Mass;
+            }
+        });
+    }
+
+    return Masses;
+}
+
+std::vector<std::vector<std::uint64_t>>
+FSlotGenerator::DistributeSlots(std::size_t SlotCount, const std::vector<std::vector<FNode>>& Levels,
+                                const std::vector<std::vector<double>>& Masses) const
+{
+    // 自上而下把每个节点的格子数按子节点的质量做多项分布（依次取条件二项分布），总数恰好为 SlotCount
+    std::vector<std::vector<std::uint64_t>> Counts(Levels.size());
+    Counts[0].assign(1, SlotCount);
+    for (std::size_t Level = 0; Level + 1 < Levels.size(); ++Level)
+    {
+        const std::vector<FNode>& Nodes = Levels[Level];
+        Counts[Level + 1].assign(Levels[Level + 1].size(), 0);
+        _ThreadPool->ParallelFor(0, Nodes.size(), 256, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+        {
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                const FNode& Node = Nodes[i];
+                std::uint64_t RemainingCount = Counts[Level][i];
+                if (Node.FirstChild == kInvalidIndex || RemainingCount == 0)
+                {
+                    continue;
+                }
+
+                // 剩下的格子都交给最后一个有质量的子节点，不会落到密度为 0 的叶子中
+                int LastOctant = 7;
+                while (LastOctant != 0 && Masses[Level + 1][Node.FirstChild + LastOctant] <= 0.0)
+                {
+                    --LastOctant;
+                }
+
+                Util::FCounterSeedSequence SeedSequence(_SeedKey, Node.Key, kSplitStream);
+                std::mt19937 RandomEngine(SeedSequence);
+                double RemainingMass = Masses[Level][i];
+                for (int Octant = 0; Octant <= LastOctant && RemainingCount != 0; ++Octant)
+                {
+                    std::size_t ChildIndex = Node.FirstChild + Octant;
+                    double ChildMass = Masses[Level + 1][ChildIndex];
+
+                    std::uint64_t ChildCount = RemainingCount;
+                    if (Octant != LastOctant && ChildMass < RemainingMass)
+                    {
+                        double Probability = RemainingMass > 0.0 ? std::clamp(ChildMass / RemainingMass, 0.0, 1.0) : 0.0;
+                        std::binomial_distribution<std::uint64_t> Distribution(RemainingCount, Probability);
+                        ChildCount = Distribution(RandomEngine);
+                    }
+
+                    Counts[Level + 1][ChildIndex] = ChildCount;
+                    RemainingCount -= ChildCount;
+                    RemainingMass  -= ChildMass;
+                }
+            }
+        });
+    }
+
+    return Counts;
+}
+
+void FSlotGenerator::SampleLeaf(std::size_t LeafIndex, glm::vec3* Output) const
+{
+    const FLeaf& Leaf = _Leaves[LeafIndex];
+    std::size_t  SlotCount = _SlotOffsets[LeafIndex + 1] - _SlotOffsets[LeafIndex];
+    std::size_t  FirstSlot = 0;
+    if (LeafIndex == _AnchorLeaf)
+    {
+        Output[0] = _Anchor;
+        FirstSlot = 1;
+    }
+
+    Util::FCounterSeedSequence SeedSequence(_SeedKey, Leaf.Key, kSampleStream);
+    std::mt19937 RandomEngine(SeedSequence);
+    Util::TUniformRealDistribution<float> Offset(-Leaf.Radius, Leaf.Radius);
+    Util::TUniformRealDistribution<float> Threshold(0.0f, Leaf.MaxDensity);
+
+    // 以密度与上界之比接受候选点。叶子的上界质量不超过 LeafCapacity 个格子，每个叶子的尝试次数期望上不超过 LeafCapacity
+    // 上界被错误地估计得过小或叶子几乎没有密度时，超过 kMaxAttempts 次后直接使用最后一个候选点
+    for (std::size_t i = FirstSlot; i != SlotCount; ++i)
+    {
+        glm::vec3 Candidate(0.0f);
+        for (int Attempt = 0; Attempt != kMaxAttempts; ++Attempt)
+        {
+            Candidate = Leaf.Center + glm::vec3(Offset(RandomEngine), Offset(RandomEngine), Offset(RandomEngine));
+            if (_DensityModel->GetDensity(Candidate) > Threshold(RandomEngine))
+            {
+                break;
+            }
+        }
+
+        Output[i] = Candidate;
+    }
+}
+
+_GENERATOR_END
+_SYSTEM_END
+_NPGS_END
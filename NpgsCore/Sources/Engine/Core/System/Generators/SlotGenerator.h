@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Engine/Core/Base/Base.h"
+#include "Engine/Core/Runtime/Threads/ThreadPool.h"
+#include "Engine/Core/System/Generators/StellarDensityModel.h"
+
+_NPGS_BEGIN
+_SYSTEM_BEGIN
+_GENERATOR_BEGIN
+
+// 按密度模型生成恒星系位置（格子）。区域是以 Center 为中心、半边长为 Radius 的立方体
+// 自适应八叉树只在密度需要的地方细分：节点内密度上界乘体积（按目标数量归一化后）不超过 LeafCapacity 时成为叶子
+// 格子数按叶子的质量用多项分布自上而下精确分配到各叶子，叶子内用密度上界做拒绝采样
+// 只保存含有格子的叶子，内存与格子数 / LeafCapacity 成正比，位置可以按叶子区间分批生成
+// 每个节点的随机数只由种子和节点在树中的路径决定，结果与线程数和生成顺序无关
+class FSlotGenerator
+{
+public:
+    static constexpr std::size_t kInvalidIndex = std::numeric_limits<std::size_t>::max();
+    static constexpr int         kMaxDepth     = 20; // 路径编码不超过 61 位
+
+public:
+    FSlotGenerator() = delete;
+    explicit FSlotGenerator(std::shared_ptr<const IStellarDensityModel> DensityModel, const glm::vec3& Center, float Radius,
+                            std::uint64_t SeedKey, std::size_t LeafCapacity = 256);
+
+    ~FSlotGenerator() = default;
+
+    // 建立自适应八叉树并把 SlotCount 个格子分配到叶子中，不生成位置
+    void Build(std::size_t SlotCount);
+    // 生成 [FirstLeaf, LastLeaf) 中叶子的全部位置，按叶子顺序追加到 Slots
+    void GenerateSlots(std::size_t FirstLeaf, std::size_t LastLeaf, std::vector<glm::vec3>& Slots) const;
+    // 把叶子按遍历顺序切成格子数不超过 MaxSlotCount 的连续区间，格子数超过 MaxSlotCount 的叶子单独成为一个区间
+    std::vector<std::pair<std::size_t, std::size_t>> Partition(std::size_t MaxSlotCount) const;
+
+    // 包含 Point 的叶子的第一个格子固定放在 Point 上，叶子中没有格子时不起作用。在 Build 之前调用
+    void SetAnchor(const glm::vec3& Point);
+
+    // 包含 Point 的含格子叶子，Point 不在任何含格子的叶子中时返回 kInvalidIndex。在 Build 之后调用
+    std::size_t FindLeaf(const glm::vec3& Point) const;
+    // 与以 Point 为中心、半径为 Radius 的球相交的全部含格子叶子，按遍历顺序排列。叶子的格子都在叶子的立方体内
+    std::vector<std::size_t> CollectLeavesInRadius(const glm::vec3& Point, float Radius) const;
+
+    std::size_t GetLeafCount() const;
+    std::size_t GetSlotCount() const;
+    // 叶子中第一个格子在全部格子中的序号
+    std::size_t GetSlotOffset(std::size_t LeafIndex) const;
+
+private:
+    struct FNode
+    {
+        glm::vec3     Center;
+        float         Radius;
+        float         MaxDensity;
+        std::uint64_t Key;        // 根为 1，每层在末尾追加 3 位卦限，同时作为随机数的计数器
+        std::size_t   FirstChild; // 下一层中第一个子节点的下标，叶子为 kInvalidIndex
+    };
+
+    struct FLeaf
+    {
+        glm::vec3     Center;
+        float         Radius;
+        float         MaxDensity;
+        std::uint64_t Key;
+    };
+
+private:
+    double EstimateTotalMass() const;
+    double EstimateNodeMass(const FNode& Node) const;
+    void BuildTree(double MaxLeafMass, std::vector<std::vector<FNode>>& Levels) const;
+    std::vector<std::vector<double>> EstimateMasses(const std::vector<std::vector<FNode>>& Levels) const;
+    std::vector<std::vector<std::uint64_t>> DistributeSlots(std::size_t SlotCount, const std::vector<std::vector<FNode>>& Levels,
+                                                            const std::vector<std::vector<double>>& Masses) const;
+
+    void SampleLeaf(std::size_t LeafIndex, glm::vec3* Output) const;
+
+private:
+    std::shared_ptr<const IStellarDensityModel> _DensityModel;
+    Runtime::Thread::FThreadPool*               _ThreadPool;
+    std::vector<FLeaf>                          _Leaves;      // 只有含格子的叶子，按深度优先的遍历顺序排列
+    std::vector<std::size_t>                    _SlotOffsets; // 前缀和，比 _Leaves 多一个元素
+    glm::vec3                                   _Center;
+    glm::vec3                                   _Anchor;
+    float                                       _Radius;
+    std::uint64_t                               _SeedKey;
+    std::size_t                                 _LeafCapacity;
+    std::size_t                                 _AnchorLeaf;
+    bool                                        _bHasAnchor;
+};
+
+_GENERATOR_END
+_SYSTEM_END
+_NPGS_END
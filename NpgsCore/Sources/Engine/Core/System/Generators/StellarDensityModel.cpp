@@ -0,0 +1,92 @@
+#include "StellarDensityModel.h"
+
+#include <cmath>
+
+_NPGS_BEGIN
+_SYSTEM_BEGIN
+_GENERATOR_BEGIN
+
+// Tool functions
+// --------------
+namespace
+{
+    // 点到以 Center 为中心、半边长为 Radius 的立方体在各轴上的最近距离，点在立方体内的轴上为 0
+    glm::vec3 GetDistanceToCube(const glm::vec3& Point, const glm::vec3& Center, float Radius)
+    {
+        return glm::max(glm::abs(Point - Center) - glm::vec3(Radius), glm::vec3(0.0f));
+    }
+}
+
+// FUniformDensityModel implementations
+// ------------------------------------
+FUniformDensityModel::FUniformDensityModel(float Radius, const glm::vec3& Center)
+    : _Center(Center), _Radius(Radius)
+{
+}
+
+float FUniformDensityModel::GetDensity(const glm::vec3& Position) const
+{
+    glm::vec3 Offset = Position - _Center;
+    return glm::dot(Offset, Offset) <= _Radius * _Radius ? 1.0f : 0.0f;
+}
+
+float FUniformDensityModel::GetMaxDensity(const glm::vec3& Center, float Radius) const
+{
+    glm::vec3 Distance = GetDistanceToCube(_Center, Center, Radius);
+    return glm::dot(Distance, Distance) <= _Radius * _Radius ? 1.0f : 0.0f;
+}
+
+// FGalacticDensityModel implementations
+// -------------------------------------
+FGalacticDensityModel::FGalacticDensityModel(const FParameters& Parameters)
+    :
+    _Parameters(Parameters),
+    _ArmWinding(1.0f / std::tan(Parameters.ArmPitchAngle))
+{
+}
+
+float FGalacticDensityModel::GetDensity(const glm::vec3& Position) const
+{
+    glm::vec3 Offset   = Position - _Parameters.GalacticCenter;
+    float AxisDistance = std::sqrt(Offset.x * Offset.x + Offset.z * Offset.z);
+
+    float Density = _Parameters.BulgeDensityRatio * std::exp(-glm::length(Offset) / _Parameters.BulgeScaleRadius);
+    if (AxisDistance <= _Parameters.DiskTruncationRadius)
+    {
+        float ArmFactor = 1.0f;
+        if (AxisDistance > 0.0f)
+        {
+            float Phase = std::atan2(Offset.z, Offset.x) - std::log(AxisDistance / _Parameters.DiskScaleLength) * _ArmWinding;
+            ArmFactor += _Parameters.ArmAmplitude * std::cos(static_cast<float>(_Parameters.ArmCount) * Phase);
+        }
+
+        Density += ArmFactor * std::exp(-AxisDistance / _Parameters.DiskScaleLength -
+                                        std::abs(Offset.y) / _Parameters.DiskScaleHeight);
+    }
+
+    return Density;
+}
+
+float FGalacticDensityModel::GetMaxDensity(const glm::vec3& Center, float Radius) const
+{
+    glm::vec3 Distance    = GetDistanceToCube(_Parameters.GalacticCenter, Center, Radius);
+    float MinAxisDistance = std::sqrt(Distance.x * Distance.x + Distance.z * Distance.z);
+
+    float MaxDensity = _Parameters.BulgeDensityRatio * std::exp(-glm::length(Distance) / _Parameters.BulgeScaleRadius);
+    if (MinAxisDistance <= _Parameters.DiskTruncationRadius)
+    {
+        MaxDensity += (1.0f + _Parameters.ArmAmplitude) * std::exp(-MinAxisDistance / _Parameters.DiskScaleLength -
+                                                                   Distance.y / _Parameters.DiskScaleHeight);
+    }
+
+    return MaxDensity;
+}
+
+const FGalacticDensityModel::FParameters& FGalacticDensityModel::GetParameters() const
+{
+    return _Parameters;
+}
+
+_GENERATOR_END
+_SYSTEM_END
+_NPGS_END
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Engine/Core/Base/Base.h"
+
+_NPGS_BEGIN
+_SYSTEM_BEGIN
+_GENERATOR_BEGIN
+
+// 恒星数密度模型，只需要给出相对密度，生成时按目标恒星数归一化。单位为光年
+// 生成时会在多个线程中并发调用，实现必须是只读的
+class IStellarDensityModel
+{
+public:
+    IStellarDensityModel()          = default;
+    virtual ~IStellarDensityModel() = default;
+
+    // Position 处的相对密度，不小于 0
+    virtual float GetDensity(const glm::vec3& Position) const = 0;
+    // 以 Center 为中心、半边长为 Radius 的立方体内密度的上界，不能小于立方体内的真实最大值
+    // 上界越紧，自适应八叉树的叶子越少，拒绝采样的效率越高
+    virtual float GetMaxDensity(const glm::vec3& Center, float Radius) const = 0;
+};
+
+// 球内均匀分布，与原来的均匀栅格采样等价
+class FUniformDensityModel : public IStellarDensityModel
+{
+public:
+    FUniformDensityModel() = delete;
+    explicit FUniformDensityModel(float Radius, const glm::vec3& Center = glm::vec3(0.0f));
+    ~FUniformDensityModel() override = default;
+
+    float GetDensity(const glm::vec3& Position) const override;
+    float GetMaxDensity(const glm::vec3& Center, float Radius) const override;
+
+private:
+    glm::vec3 _Center;
+    float     _Radius;
+};
+
+// 星系模型，由指数盘、指数核球和对数螺旋臂组成，盘面垂直于 y 轴
+// 盘：exp(-R / DiskScaleLength - |h| / DiskScaleHeight)，R 为到自转轴的距离，h 为到盘面的距离，超出 DiskTruncationRadius 为 0
+// 核球：BulgeDensityRatio * exp(-r / BulgeScaleRadius)，r 为到星系中心的距离
+// 旋臂只调制盘的密度，系数为 1 + ArmAmplitude * cos(ArmCount * (θ - ln(R / DiskScaleLength) / tan(ArmPitchAngle)))
+class FGalacticDensityModel : public IStellarDensityModel
+{
+public:
+    struct FParameters
+    {
+        glm::vec3 GalacticCenter{ 0.0f };           // 星系中心在宇宙中的位置，初始恒星系位于原点
+        float     DiskScaleLength{ 8500.0f };
+        float     DiskScaleHeight{ 1000.0f };
+        float     DiskTruncationRadius{ 50000.0f };
+        float     BulgeScaleRadius{ 1500.0f };
+        float     BulgeDensityRatio{ 5.0f };        // 核球中心与盘中心的密度之比
+        int       ArmCount{ 2 };
+        float     ArmPitchAngle{ 0.2f };            // 弧度
+        float     ArmAmplitude{ 0.6f };             // 0 到 1 之间，0 为没有旋臂
+    };
+
+public:
+    FGalacticDensityModel() = delete;
+    explicit FGalacticDensityModel(const FParameters& Parameters);
+    ~FGalacticDensityModel() override = default;
+
+    float GetDensity(const glm::vec3& Position) const override;
+    // 盘和核球都随距离单调递减，分别取立方体内离中心、盘面最近的点，旋臂取最大的调制系数
+    float GetMaxDensity(const glm::vec3& Center, float Radius) const override;
+
+    const FParameters& GetParameters() const;
+
+private:
+    FParameters _Parameters;
+    float       _ArmWinding; // 1 / tan(ArmPitchAngle)
+};
+
+_GENERATOR_END
+_SYSTEM_END
+_NPGS_END
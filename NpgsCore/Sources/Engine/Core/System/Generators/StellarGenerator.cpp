@@ -6,18 +6,19 @@
 #include <charconv>
 #include <filesystem>
 #include <format>
-#include <iomanip>
 #include <iterator>
 #include <limits>
 #include <print>
-#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <tuple>
+#include <type_traits>
 
 #include <glm/glm.hpp>
 
 #include "Engine/Core/Base/Base.h"
 #include "Engine/Core/Math/NumericConstants.h"
+#include "Engine/Core/Math/SimdKernels.h"
 #include "Engine/Core/Runtime/Assets/AssetManager.h"
 #include "Engine/Core/Runtime/Assets/CommaSeparatedValues.hpp"
 #include "Engine/Core/Runtime/Assets/GetAssetFullPath.h"
@@ -28,24 +29,6 @@ _NPGS_BEGIN
 _SYSTEM_BEGIN
 _GENERATOR_BEGIN
 
-// Tool macros
-// -----------
-#define GenerateDeathStarPlaceholder(Lifetime)                                                                               \
-{                                                                                                                            \
-    Astro::FStellarClass::FSpectralType DeathStarClass                                                                       \
-	{                                                                                                                        \
-        Astro::FStellarClass::ESpectralClass::kSpectral_Unknown,                                                             \
-        Astro::FStellarClass::ESpectralClass::kSpectral_Unknown,                                                             \
-        Astro::FStellarClass::ELuminosityClass::kLuminosity_Unknown,                                                         \
-        0, 0.0f, 0.0f, false                                                                                                 \
-    };                                                                                                                       \
-                                                                                                                             \
-    Astro::AStar DeathStar;                                                                                                  \
-    DeathStar.SetStellarClass(Astro::FStellarClass(Astro::FStellarClass::EStarType::kDeathStarPlaceholder, DeathStarClass)); \
-    DeathStar.SetLifetime(Lifetime);                                                                                         \
-    throw DeathStar;                                                                                                         \
-}
-
 // Tool functions
 // --------------
 namespace
@@ -118,7 +101,9 @@ FStellarGenerator::FStellarGenerator(const std::seed_seq& SeedSequence, EGenerat
     _CoilTemperatureLimit(CoilTemperatureLimit),
     _dEpdM(dEpdM),
 
-    _AgeDistribution(AgeDistribution), _FeHDistribution(FeHDistribution), _MassDistribution(MassDistribution), _Option(Option)
+    _AgeDistribution(AgeDistribution), _FeHDistribution(FeHDistribution), _MassDistribution(MassDistribution), _Option(Option),
+
+    _CounterSeedKey(0), _StarSeedCounter(0), _bUseCounterSeed(false)
 {
     InitMistData();
     InitPdfs();
@@ -131,8 +116,14 @@ FStellarGenerator::FBasicProperties FStellarGenerator::GenerateBasicProperties()
 
 FStellarGenerator::FBasicProperties FStellarGenerator::GenerateBasicProperties(float Age, float FeH)
 {
+    if (_bUseCounterSeed)
+    {
+        Reseed(_StarSeedCounter, _kBasicPropertiesStream);
+    }
+
     FBasicProperties Properties{};
-    Properties.TypeOption = _Option;
+    Properties.TypeOption  = _Option;
+    Properties.SeedCounter = _StarSeedCounter;
 
     if (Properties.TypeOption == EGenerateOption::kBinarySecondStar)
     {
@@ -312,35 +303,141 @@ Astro::AStar FStellarGenerator::GenerateStar(FBasicProperties&& Properties)
 {
     if (Util::Equal(Properties.InitialMassSol, -1.0f))
     {
+        _StarSeedCounter = Properties.SeedCounter;
         Properties = GenerateBasicProperties(Properties.Age, Properties.FeH);
     }
 
+    if (_bUseCounterSeed)
+    {
+        Reseed(Properties.SeedCounter, _kStarDataStream);
+    }
+
+    return GenerateStarImpl(Properties, nullptr);
+}
+
+void FStellarGenerator::GenerateStars(std::span<const FBasicProperties> PropertiesList, std::span<Astro::AStar> Stars)
+{
+    if (PropertiesList.size() != Stars.size())
+    {
+        throw std::invalid_argument("Properties and stars size mismatch.");
+    }
+
+    std::vector<FBasicProperties> Properties(PropertiesList.begin(), PropertiesList.end());
+    std::vector<std::pair<FTrackBracket, std::size_t>> Buckets;
+    Buckets.reserve(Properties.size());
+
+    // 计数器种子模式下每颗恒星单独播种，分桶打乱的生成顺序不影响结果
+    auto ReseedStarData = [this](const FBasicProperties& StarProperties) -> void
+    {
+        if (_bUseCounterSeed)
+        {
+            Reseed(StarProperties.SeedCounter, _kStarDataStream);
+        }
+    };
+
+    // 先按输入顺序补全属性，不需要 MIST 轨迹的恒星直接生成，其余的记下所在的轨迹区间
+    for (std::size_t i = 0; i != Properties.size(); ++i)
+    {
+        if (Util::Equal(Properties[i].InitialMassSol, -1.0f))
+        {
+            _StarSeedCounter = Properties[i].SeedCounter;
+            Properties[i] = GenerateBasicProperties(Properties[i].Age, Properties[i].FeH);
+        }
+
+        if (Properties[i].TypeOption == EGenerateOption::kNormal || Properties[i].TypeOption == EGenerateOption::kGiant)
+        {
+            Buckets.emplace_back(FindMistTrackBracket(Properties[i].FeH, Properties[i].InitialMassSol), i);
+        }
+        else
+        {
+            ReseedStarData(Properties[i]);
+            Stars[i] = GenerateStarImpl(Properties[i], nullptr);
+        }
+    }
+
+    // 按 ([Fe/H] 格点, 质量区间) 排序，同一区间的恒星连续插值，每次只访问少数几条轨迹
+    std::sort(Buckets.begin(), Buckets.end(), [](const auto& Lhs, const auto& Rhs) -> bool
+    {
+        return std::tie(Lhs.first.FeHIndex, Lhs.first.LowerIndex, Lhs.first.UpperIndex, Lhs.second) <
+               std::tie(Rhs.first.FeHIndex, Rhs.first.LowerIndex, Rhs.first.UpperIndex, Rhs.second);
+    });
+
+    std::vector<FMistStarData> Rows;
+    std::vector<std::size_t>   RowIndices;
+    Rows.reserve(Buckets.size());
+    RowIndices.reserve(Buckets.size());
+
+    for (const auto& [Bracket, Index] : Buckets)
+    {
+        FBasicProperties& StarProperties = Properties[Index];
+        if (StarProperties.TypeOption == EGenerateOption::kGiant)
+        {
+            StarProperties.Age = -1.0f;
+        }
+
+        auto MistData = GetFullMistData(StarProperties, Bracket);
+        if (MistData.has_value())
+        {
+            Rows.emplace_back(*MistData);
+            RowIndices.emplace_back(Index);
+        }
+        else if (StarProperties.TypeOption == EGenerateOption::kNormal)
+        {
+            ReseedStarData(StarProperties);
+            Stars[Index] = GenerateEndOfTrackStar(StarProperties, MistData.error());
+        }
+        else
+        {
+            Stars[Index] = {};
+        }
+    }
+
+    // 对数列按 SoA 布局排列后用向量化的 exp10 一次性换算
+    const std::array<int, 5> kLogColumnIndices{ _kLogTeffIndex, _kLogRIndex, _kLogSurfZIndex, _kLogCenterTIndex, _kLogCenterRhoIndex };
+    std::array<std::vector<double>, 5> LinearColumns;
+    for (std::size_t c = 0; c != LinearColumns.size(); ++c)
+    {
+        LinearColumns[c].resize(Rows.size());
+        for (std::size_t j = 0; j != Rows.size(); ++j)
+        {
+            LinearColumns[c][j] = Rows[j][kLogColumnIndices[c]];
+        }
+
+        Math::Exp10Array(LinearColumns[c].data(), LinearColumns[c].data(), Rows.size());
+    }
+
+    for (std::size_t j = 0; j != Rows.size(); ++j)
+    {
+        FLinearMistData LinearData
+        {
+            LinearColumns[0][j], LinearColumns[1][j], LinearColumns[2][j], LinearColumns[3][j], LinearColumns[4][j]
+        };
+
+        const FBasicProperties& StarProperties = Properties[RowIndices[j]];
+        Astro::AStar Star(StarProperties);
+        ReseedStarData(StarProperties);
+        FillStarData(Rows[j], LinearData, StarProperties, Star);
+        Stars[RowIndices[j]] = std::move(Star);
+    }
+}
+
+Astro::AStar FStellarGenerator::GenerateStarImpl(FBasicProperties& Properties, const FTrackBracket* Bracket)
+{
     Astro::AStar Star(Properties);
-    std::vector<double> StarData;
+    FMistStarData StarData{};
 
     switch (Properties.TypeOption)
     {
     case EGenerateOption::kNormal:
     {
-        try
+        auto MistData = Bracket != nullptr ? GetFullMistData(Properties, *Bracket) : GetFullMistData(Properties);
+        if (MistData.has_value())
         {
-            StarData = GetFullMistData(Properties, false, true);
+            StarData = *MistData;
         }
-        catch (Astro::AStar& DeathStar)
+        else
         {
-            DeathStar.SetAge(Properties.Age);
-            DeathStar.SetFeH(Properties.FeH);
-            DeathStar.SetInitialMass(Properties.InitialMassSol);
-            DeathStar.SetIsSingleStar(Properties.bIsSingleStar);
-            ProcessDeathStar(DeathStar);
-            if (DeathStar.GetEvolutionPhase() == Astro::AStar::EEvolutionPhase::kNull)
-            {
-                // 对于双星，二者年龄和金属丰度要保持一致
-                Properties.InitialMassSol /= 2;
-                DeathStar = GenerateStar(Properties);
-            }
-
-            return DeathStar;
+            return GenerateEndOfTrackStar(Properties, MistData.error());
         }
 
         break;
@@ -348,7 +445,13 @@ Astro::AStar FStellarGenerator::GenerateStar(FBasicProperties&& Properties)
     case EGenerateOption::kGiant:
     {
         Properties.Age = -1.0f; // 使用 -1.0，在计算年龄的时候根据寿命赋值一个濒死年龄
-        StarData = GetFullMistData(Properties, false, true);
+        auto MistData = Bracket != nullptr ? GetFullMistData(Properties, *Bracket) : GetFullMistData(Properties);
+        if (!MistData.has_value())
+        {
+            return {};
+        }
+
+        StarData = *MistData;
         break;
     }
     case EGenerateOption::kDeathStar:
@@ -361,7 +464,7 @@ Astro::AStar FStellarGenerator::GenerateStar(FBasicProperties&& Properties)
         if (Star.GetEvolutionPhase() == Astro::AStar::EEvolutionPhase::kNull)
         { // 炸没了，再生成个新的
             Properties.InitialMassSol /= 2;
-            Star = GenerateStar(Properties);
+            Star = GenerateStarImpl(Properties, nullptr);
         }
 
         return Star;
@@ -376,25 +479,66 @@ Astro::AStar FStellarGenerator::GenerateStar(FBasicProperties&& Properties)
         break;
     }
     default:
-        break;
+        return {};
     }
 
-    if (StarData.empty())
+    // 单颗恒星只有 5 个值，逐个调用 std::pow 比分派到向量版本的 Exp10Array 更快
+    FLinearMistData LinearData
     {
-        return {};
+        std::pow(10.0, StarData[_kLogTeffIndex]),
+        std::pow(10.0, StarData[_kLogRIndex]),
+        std::pow(10.0, StarData[_kLogSurfZIndex]),
+        std::pow(10.0, StarData[_kLogCenterTIndex]),
+        std::pow(10.0, StarData[_kLogCenterRhoIndex])
+    };
+
+    FillStarData(StarData, LinearData, Properties, Star);
+
+    return Star;
+}
+
+Astro::AStar FStellarGenerator::GenerateEndOfTrackStar(FBasicProperties& Properties, const FEndOfTrack& EndOfTrack)
+{
+    Astro::FStellarClass::FSpectralType DeathStarClass
+    {
+        Astro::FStellarClass::ESpectralClass::kSpectral_Unknown,
+        Astro::FStellarClass::ESpectralClass::kSpectral_Unknown,
+        Astro::FStellarClass::ELuminosityClass::kLuminosity_Unknown,
+        0, 0.0f, 0.0f, false
+    };
+
+    Astro::AStar DeathStar;
+    DeathStar.SetStellarClass(Astro::FStellarClass(Astro::FStellarClass::EStarType::kDeathStarPlaceholder, DeathStarClass));
+    DeathStar.SetLifetime(EndOfTrack.Lifetime);
+    DeathStar.SetAge(Properties.Age);
+    DeathStar.SetFeH(Properties.FeH);
+    DeathStar.SetInitialMass(Properties.InitialMassSol);
+    DeathStar.SetIsSingleStar(Properties.bIsSingleStar);
+    ProcessDeathStar(DeathStar);
+    if (DeathStar.GetEvolutionPhase() == Astro::AStar::EEvolutionPhase::kNull)
+    {
+        // 对于双星，二者年龄和金属丰度要保持一致
+        Properties.InitialMassSol /= 2;
+        DeathStar = GenerateStar(Properties);
     }
 
+    return DeathStar;
+}
+
+void FStellarGenerator::FillStarData(const FMistStarData& StarData, const FLinearMistData& LinearData,
+                                     const FBasicProperties& Properties, Astro::AStar& Star)
+{
     double Lifetime          = StarData[_kLifetimeIndex];
     double EvolutionProgress = StarData[_kXIndex];
     float  Age               = static_cast<float>(StarData[_kStarAgeIndex]);
-    float  RadiusSol         = static_cast<float>(std::pow(10.0, StarData[_kLogRIndex]));
+    float  RadiusSol         = static_cast<float>(LinearData.RadiusSol);
     float  MassSol           = static_cast<float>(StarData[_kStarMassIndex]);
-    float  Teff              = static_cast<float>(std::pow(10.0, StarData[_kLogTeffIndex]));
-    float  SurfaceZ          = static_cast<float>(std::pow(10.0, StarData[_kLogSurfZIndex]));
+    float  Teff              = static_cast<float>(LinearData.Teff);
+    float  SurfaceZ          = static_cast<float>(LinearData.SurfaceZ);
     float  SurfaceH1         = static_cast<float>(StarData[_kSurfaceH1Index]);
     float  SurfaceHe3        = static_cast<float>(StarData[_kSurfaceHe3Index]);
-    float  CoreTemp          = static_cast<float>(std::pow(10.0, StarData[_kLogCenterTIndex]));
-    float  CoreDensity       = static_cast<float>(std::pow(10.0, StarData[_kLogCenterRhoIndex]));
+    float  CoreTemp          = static_cast<float>(LinearData.CoreTemp);
+    float  CoreDensity       = static_cast<float>(LinearData.CoreDensity);
     float  MassLossRate      = static_cast<float>(StarData[_kStarMdotIndex]);
 
     float LuminositySol  = std::pow(RadiusSol, 2.0f) * std::pow((Teff / kSolarTeff), 4.0f);
@@ -433,7 +577,7 @@ Astro::AStar FStellarGenerator::GenerateStar(FBasicProperties&& Properties)
     Star.SetEvolutionPhase(EvolutionPhase);
     Star.SetNormal(glm::vec2(Theta, Phi));
 
-    CalculateSpectralType(static_cast<float>(StarData.back()), Star);
+    CalculateSpectralType(static_cast<float>(StarData[_kFeHIndex]), Star);
     GenerateMagnetic(Star);
     GenerateSpin(Star);
 
@@ -448,8 +592,6 @@ Astro::AStar FStellarGenerator::GenerateStar(FBasicProperties&& Properties)
     ));
 
     Star.SetMinCoilMass(MinCoilMass);
-
-    return Star;
 }
 
 template <typename CsvType>
@@ -466,11 +608,160 @@ CsvType* FStellarGenerator::LoadCsvAsset(const std::string& Filename, const std:
     }
 
     std::unique_lock Lock(_kCacheMutex);
+    auto* Asset = AssetManager->GetAsset<CsvType>(Filename);
+    if (Asset != nullptr)
+    {
+        return Asset;
+    }
+
+    if constexpr (std::is_same_v<CsvType, FMistData>)
+    {
+        Asset = LoadTrackFromPack<FMistData>(_kMistPacks, Filename, Headers);
+    }
+    else if constexpr (std::is_same_v<CsvType, FWdMistData>)
+    {
+        Asset = LoadTrackFromPack<FWdMistData>(_kWdMistPacks, Filename, Headers);
+    }
+
+    if (Asset != nullptr)
+    {
+        return Asset;
+    }
+
     AssetManager->AddAsset<CsvType>(Filename, CsvType(Filename, Headers));
 
     return AssetManager->GetAsset<CsvType>(Filename);
 }
 
+template <typename CsvType, typename PackType>
+std::vector<float> FStellarGenerator::LoadTrackPack(const std::string& PrefixDirectory, const std::string& PackFilename,
+                                                    const std::vector<std::string>& Headers,
+                                                    std::unordered_map<std::string, std::unique_ptr<PackType>>& Packs)
+{
+    // 数据包比目录或目录中任意 csv 旧时视为过期，csv 始终是数据的来源
+    auto IsPackOutdated = [&]() -> bool
+    {
+        if (!std::filesystem::exists(PackFilename))
+        {
+            return true;
+        }
+
+        auto PackTime = std::filesystem::last_write_time(PackFilename);
+        if (std::filesystem::last_write_time(PrefixDirectory) > PackTime)
+        {
+            return true;
+        }
+
+        for (const auto& Entry : std::filesystem::directory_iterator(PrefixDirectory))
+        {
+            if (Entry.last_write_time() > PackTime)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    if (!IsPackOutdated())
+    {
+        try
+        {
+            auto Pack = std::make_unique<PackType>(PackFilename);
+            std::vector<float> Masses = Pack->GetMasses();
+            Packs.emplace(PrefixDirectory, std::move(Pack));
+            return Masses;
+        }
+        catch (const std::exception& e)
+        {
+            NpgsCoreWarn("Failed to load track pack \"{}\": {} Regenerating from csv files.", PackFilename, e.what());
+        }
+    }
+
+    std::vector<std::pair<float, const CsvType*>> Tracks;
+    for (const auto& Entry : std::filesystem::directory_iterator(PrefixDirectory))
+    {
+        std::string Filename = Entry.path().filename().string();
+
+        float Mass = 0.0f;
+        std::from_chars(Filename.data(), Filename.data() + Filename.find("Ms_track.csv"), Mass);
+
+        Tracks.emplace_back(Mass, LoadCsvAsset<CsvType>(PrefixDirectory + "/" + Filename, Headers));
+    }
+
+    std::sort(Tracks.begin(), Tracks.end(), [](const auto& Lhs, const auto& Rhs) -> bool
+    {
+        return Lhs.first < Rhs.first;
+    });
+
+    try
+    {
+        PackType::Build(PackFilename, Tracks);
+        NpgsCoreInfo("Generated track pack \"{}\" from {} csv files.", PackFilename, Tracks.size());
+    }
+    catch (const std::exception& e)
+    {
+        NpgsCoreWarn("Failed to generate track pack \"{}\": {}", PackFilename, e.what());
+    }
+
+    std::vector<float> Masses;
+    Masses.reserve(Tracks.size());
+    for (const auto& [Mass, Csv] : Tracks)
+    {
+        Masses.emplace_back(Mass);
+    }
+
+    return Masses;
+}
+
+template <typename CsvType, typename PackType>
+CsvType* FStellarGenerator::LoadTrackFromPack(const std::unordered_map<std::string, std::unique_ptr<PackType>>& Packs,
+                                              const std::string& Filename, const std::vector<std::string>& Headers)
+{
+    std::size_t Separator = Filename.rfind('/');
+    if (Separator == std::string::npos)
+    {
+        return nullptr;
+    }
+
+    auto it = Packs.find(Filename.substr(0, Separator));
+    if (it == Packs.end())
+    {
+        return nullptr;
+    }
+
+    float Mass = 0.0f;
+    std::from_chars(Filename.data() + Separator + 1, Filename.data() + Filename.find("Ms_track.csv"), Mass);
+
+    const auto& Masses = it->second->GetMasses();
+    auto MassIt = std::lower_bound(Masses.begin(), Masses.end(), Mass);
+    if (MassIt == Masses.end() || *MassIt != Mass)
+    {
+        return nullptr;
+    }
+
+    auto Track = it->second->GetTrack(std::distance(Masses.begin(), MassIt));
+    auto* AssetManager = Runtime::Asset::FAssetManager::GetInstance();
+    AssetManager->AddAsset<CsvType>(Filename, CsvType(Filename, Headers, Track.Data, Track.RowCount));
+
+    return AssetManager->GetAsset<CsvType>(Filename);
+}
+
+template <typename CsvType>
+FStellarGenerator::TTrackIndex<CsvType> FStellarGenerator::BuildTrackIndex(const std::string& PrefixDirectory, std::vector<float> Masses,
+                                                                           const std::vector<std::string>& Headers)
+{
+    TTrackIndex<CsvType> Index;
+    Index.Tracks.reserve(Masses.size());
+    for (float Mass : Masses)
+    {
+        Index.Tracks.emplace_back(LoadCsvAsset<CsvType>(std::format("{}/{:06.2f}0Ms_track.csv", PrefixDirectory, Mass), Headers));
+    }
+
+    Index.Masses = std::move(Masses);
+    return Index;
+}
+
 void FStellarGenerator::InitMistData()
 {
     if (_kbMistDataInitiated)
@@ -492,31 +783,38 @@ void FStellarGenerator::InitMistData()
         Runtime::Asset::GetAssetFullPath(Runtime::Asset::EAssetType::kDataTable, "StellarParameters/MIST/WhiteDwarfs/Thick")
     };
 
-    std::vector<float> Masses;
+    const std::string kDataTableRoot =
+        Runtime::Asset::GetAssetFullPath(Runtime::Asset::EAssetType::kDataTable, "");
 
-    for (const auto& PrefixDirectory : kPresetPrefix)
+    // 每个目录对应一个二进制数据包，轨迹只在插值用到时才从映射的数据包中读取
+    // 前 8 个目录按金属丰度升序对应 _kMistTrackIndices，后 2 个对应 _kWdMistTrackIndices
+    for (std::size_t i = 0; i != kPresetPrefix.size(); ++i)
     {
-        for (const auto& Entry : std::filesystem::directory_iterator(PrefixDirectory))
-        {
-            std::string Filename = Entry.path().filename().string();
+        const std::string& PrefixDirectory = kPresetPrefix[i];
+        std::string PackFilename = Runtime::Asset::GetAssetFullPath(
+            Runtime::Asset::EAssetType::kBinaryDataTable, PrefixDirectory.substr(kDataTableRoot.size()) + ".pack");
 
-            float Mass = 0.0f;
-            std::from_chars(Filename.data(), Filename.data() + Filename.find("Ms_track.csv"), Mass);
-
-            Masses.emplace_back(Mass);
-
-            if (PrefixDirectory.find("WhiteDwarfs") != std::string::npos)
-            {
-                LoadCsvAsset<FWdMistData>(PrefixDirectory + "/" + Filename, _kWdMistHeaders);
-            }
-            else
-            {
-                LoadCsvAsset<FMistData>(PrefixDirectory + "/" + Filename, _kMistHeaders);
-            }
+        if (i >= _kMistTrackIndices.size())
+        {
+            std::vector<float> Masses = LoadTrackPack<FWdMistData>(PrefixDirectory, PackFilename, _kWdMistHeaders, _kWdMistPacks);
+            _kWdMistTrackIndices[i - _kMistTrackIndices.size()] =
+                BuildTrackIndex<FWdMistData>(PrefixDirectory, std::move(Masses), _kWdMistHeaders);
         }
+        else
+        {
+            std::vector<float> Masses = LoadTrackPack<FMistData>(PrefixDirectory, PackFilename, _kMistHeaders, _kMistPacks);
+            _kMistTrackIndices[i] = BuildTrackIndex<FMistData>(PrefixDirectory, std::move(Masses), _kMistHeaders);
+        }
+    }
 
-        _kMassFilesCache.emplace(PrefixDirectory, Masses);
-        Masses.clear();
+    // 预先计算所有轨迹的相变点，初始化后只读，插值时无需加锁也无需拷贝
+    for (auto& TrackIndex : _kMistTrackIndices)
+    {
+        TrackIndex.PhaseChanges.reserve(TrackIndex.Tracks.size());
+        for (const FMistData* Track : TrackIndex.Tracks)
+        {
+            TrackIndex.PhaseChanges.emplace_back(BuildPhaseChanges(Track));
+        }
     }
 
     _kbMistDataInitiated = true;
@@ -576,56 +874,77 @@ float FStellarGenerator::GenerateMass(float MaxPdf, auto& LogMassPdf)
     return std::pow(10.0f, LogMass);
 }
 
-std::vector<double> FStellarGenerator::GetFullMistData(const FBasicProperties& Properties, bool bIsWhiteDwarf, bool bIsSingleWhiteDwarf)
+FStellarGenerator::TMistResult<FStellarGenerator::FMistStarData> FStellarGenerator::GetFullMistData(const FBasicProperties& Properties)
 {
-    float TargetAge  = Properties.Age;
-    float TargetFeH  = Properties.FeH;
-    float TargetMass = Properties.InitialMassSol;
+    return GetFullMistData(Properties, FindMistTrackBracket(Properties.FeH, Properties.InitialMassSol));
+}
 
-    std::string PrefixDirectory;
-    std::string MassString;
-    std::stringstream MassStream;
-    std::pair<std::string, std::string> Files;
+FStellarGenerator::TMistResult<FStellarGenerator::FMistStarData>
+FStellarGenerator::GetFullMistData(const FBasicProperties& Properties, const FTrackBracket& Bracket)
+{
+    double TargetAge  = Properties.Age;
+    double TargetMass = Properties.InitialMassSol;
 
-    if (!bIsWhiteDwarf)
-    {
-        const std::array<float, 8> kPresetFeH{ -4.0f, -3.0f, -2.0f, -1.5f, -1.0f, -0.5f, 0.0f, 0.5f };
+    const auto& TrackIndex = _kMistTrackIndices[Bracket.FeHIndex];
+    float  LowerMass       = TrackIndex.Masses[Bracket.LowerIndex];
+    float  UpperMass       = TrackIndex.Masses[Bracket.UpperIndex];
+    double MassCoefficient = (TargetMass - LowerMass) / (UpperMass - LowerMass);
 
-        float ClosestFeH = *std::min_element(kPresetFeH.begin(), kPresetFeH.end(), [TargetFeH](float Lhs, float Rhs) -> bool
-        {
-            return std::abs(Lhs - TargetFeH) < std::abs(Rhs - TargetFeH);
-        });
+    std::pair<FMistData*, FMistData*> Tracks{ TrackIndex.Tracks[Bracket.LowerIndex], TrackIndex.Tracks[Bracket.UpperIndex] };
+    std::pair<std::span<const FMistRow>, std::span<const FMistRow>> PhaseChanges
+    {
+        TrackIndex.PhaseChanges[Bracket.LowerIndex], TrackIndex.PhaseChanges[Bracket.UpperIndex]
+    };
 
-        TargetFeH = ClosestFeH;
+    auto Result = InterpolateMistData(Tracks, PhaseChanges, TargetAge, TargetMass, MassCoefficient);
+    if (Result.has_value())
+    {
+        (*Result)[_kFeHIndex] = _kPresetFeH[Bracket.FeHIndex]; // 加入插值使用的金属丰度，用于计算光谱类型
+    }
 
-        MassStream << std::fixed << std::setfill('0') << std::setw(6) << std::setprecision(2) << TargetMass;
-        MassString = MassStream.str() + "0";
+    return Result;
+}
 
-        std::stringstream FeHStream;
-        FeHStream << std::fixed << std::setprecision(1) << TargetFeH;
-        PrefixDirectory = FeHStream.str();
-        if (TargetFeH >= 0.0f)
-        {
-            PrefixDirectory.insert(PrefixDirectory.begin(), '+');
-        }
-        PrefixDirectory.insert(0, Runtime::Asset::GetAssetFullPath(Runtime::Asset::EAssetType::kDataTable, "StellarParameters/MIST/[Fe_H]="));
-    }
-    else
+FStellarGenerator::FTrackBracket FStellarGenerator::FindMistTrackBracket(float TargetFeH, float TargetMass)
+{
+    auto ClosestFeH = std::min_element(_kPresetFeH.begin(), _kPresetFeH.end(), [TargetFeH](float Lhs, float Rhs) -> bool
     {
-        if (bIsSingleWhiteDwarf)
-        {
-            PrefixDirectory = Runtime::Asset::GetAssetFullPath(Runtime::Asset::EAssetType::kDataTable, "StellarParameters/MIST/WhiteDwarfs/Thin");
-        }
-        else
-        {
-            PrefixDirectory = Runtime::Asset::GetAssetFullPath(Runtime::Asset::EAssetType::kDataTable, "StellarParameters/MIST/WhiteDwarfs/Thick");
-        }
-    }
+        return std::abs(Lhs - TargetFeH) < std::abs(Rhs - TargetFeH);
+    });
 
-    std::vector<float> Masses;
+    FTrackBracket Bracket{};
+    Bracket.FeHIndex = std::distance(_kPresetFeH.begin(), ClosestFeH);
+    std::tie(Bracket.LowerIndex, Bracket.UpperIndex) = FindMassBracket(_kMistTrackIndices[Bracket.FeHIndex].Masses, TargetMass, false);
+
+    return Bracket;
+}
+
+FStellarGenerator::FWdMistRow FStellarGenerator::GetFullWdMistData(const FBasicProperties& Properties, bool bIsSingleWhiteDwarf)
+{
+    const auto& TrackIndex = _kWdMistTrackIndices[bIsSingleWhiteDwarf ? 0 : 1];
+    const auto& [Tracks, MassCoefficient] = FindTracks(TrackIndex, Properties.InitialMassSol, true);
+
+    return InterpolateWdMistData(Tracks, Properties.Age, MassCoefficient);
+}
+
+template <typename CsvType>
+std::pair<std::pair<CsvType*, CsvType*>, double>
+FStellarGenerator::FindTracks(const TTrackIndex<CsvType>& TrackIndex, float TargetMass, bool bIsWhiteDwarf)
+{
+    const auto& [LowerIndex, UpperIndex] = FindMassBracket(TrackIndex.Masses, TargetMass, bIsWhiteDwarf);
+
+    float LowerMass = TrackIndex.Masses[LowerIndex];
+    float UpperMass = TrackIndex.Masses[UpperIndex];
+    double MassCoefficient = (TargetMass - LowerMass) / (UpperMass - LowerMass);
+
+    return { { TrackIndex.Tracks[LowerIndex], TrackIndex.Tracks[UpperIndex] }, MassCoefficient };
+}
+
+std::pair<std::size_t, std::size_t> FStellarGenerator::FindMassBracket(const std::vector<float>& Masses, float TargetMass, bool bIsWhiteDwarf)
+{
+    if (Masses.empty())
     {
-        std::shared_lock Lock(_kCacheMutex);
-        Masses = _kMassFilesCache[PrefixDirectory];
+        throw std::out_of_range("No track loaded.");
     }
 
     auto it = std::lower_bound(Masses.begin(), Masses.end(), TargetMass);
@@ -641,195 +960,161 @@ std::vector<double> FStellarGenerator::GetFullMistData(const FBasicProperties& P
         }
     }
 
-    float LowerMass = 0.0f;
-    float UpperMass = 0.0f;
+    std::size_t LowerIndex = 0;
+    std::size_t UpperIndex = std::distance(Masses.begin(), it);
 
     if (*it == TargetMass)
     {
-        LowerMass = UpperMass = *it;
+        LowerIndex = UpperIndex;
     }
     else
     {
-        LowerMass = it == Masses.begin() ? *it : *(it - 1);
-        UpperMass = *it;
+        LowerIndex = it == Masses.begin() ? UpperIndex : UpperIndex - 1;
     }
 
-    float MassCoefficient = (TargetMass - LowerMass) / (UpperMass - LowerMass);
+    return { LowerIndex, UpperIndex };
+}
 
-    MassString.clear();
-    MassStream.str("");
-    MassStream.clear();
+FStellarGenerator::TMistResult<FStellarGenerator::FMistStarData> FStellarGenerator::InterpolateMistData(const std::pair<FMistData*, FMistData*>& Tracks, const std::pair<std::span<const FMistRow>, std::span<const FMistRow>>& PhaseChanges, double TargetAge, double TargetMass, double MassCoefficient)
+{
+    FMistStarData Result{};
 
-    MassStream << std::fixed << std::setfill('0') << std::setw(6) << std::setprecision(2) << LowerMass;
-    MassString = MassStream.str() + "0";
-    std::string LowerMassFile = PrefixDirectory + "/" + MassString + "Ms_track.csv";
+    if (Tracks.first != Tracks.second) [[likely]]
+    {
+        FMistData* LowerData = Tracks.first;
+        FMistData* UpperData = Tracks.second;
 
-    MassString.clear();
-    MassStream.str("");
-    MassStream.clear();
+        std::span<const FMistRow> LowerPhaseChanges = PhaseChanges.first;
+        std::span<const FMistRow> UpperPhaseChanges = PhaseChanges.second;
 
-    MassStream << std::fixed << std::setfill('0') << std::setw(6) << std::setprecision(2) << UpperMass;
-    MassString = MassStream.str() + "0";
-    std::string UpperMassFile = PrefixDirectory + "/" + MassString + "Ms_track.csv";
+        if (Util::Equal(TargetAge, -1.0)) // 年龄为 -1.0 代表要生成濒死恒星
+        {
+            double LowerLifetime = LowerPhaseChanges.back()[_kStarAgeIndex];
+            double UpperLifetime = UpperPhaseChanges.back()[_kStarAgeIndex];
+            double Lifetime = LowerLifetime + (UpperLifetime - LowerLifetime) * MassCoefficient;
+            TargetAge = Lifetime - 500000;
+        }
 
-    Files.first  = LowerMassFile;
-    Files.second = UpperMassFile;
+        auto EvolutionProgressResult = CalculateEvolutionProgress({ LowerPhaseChanges, UpperPhaseChanges }, TargetAge, MassCoefficient);
+        if (!EvolutionProgressResult.has_value())
+        {
+            return std::unexpected(EvolutionProgressResult.error());
+        }
 
-    std::vector<double> Result = InterpolateMistData(Files, TargetAge, TargetMass, MassCoefficient);
-    Result.emplace_back(TargetFeH); // 加入插值使用的金属丰度，用于计算光谱类型
+        double EvolutionProgress = *EvolutionProgressResult;
 
-    return Result;
-}
+        double LowerLifetime = LowerPhaseChanges.back()[_kStarAgeIndex];
+        double UpperLifetime = UpperPhaseChanges.back()[_kStarAgeIndex];
 
-std::vector<double> FStellarGenerator::InterpolateMistData(const std::pair<std::string, std::string>& Files, double TargetAge, double TargetMass, double MassCoefficient)
-{
-    std::vector<double> Result;
+        FMistRow LowerRow = InterpolateStarData(LowerData, EvolutionProgress);
+        FMistRow UpperRow = InterpolateStarData(UpperData, EvolutionProgress);
+        FMistRow FinalRow = InterpolateFinalData(std::pair{ LowerRow, UpperRow }, MassCoefficient, false);
 
-    if (Files.first.find("WhiteDwarfs") == std::string::npos)
+        std::copy(FinalRow.begin(), FinalRow.end(), Result.begin());
+        Result[_kLifetimeIndex] = LowerLifetime + (UpperLifetime - LowerLifetime) * MassCoefficient;
+    }
+    else [[unlikely]]
     {
-        if (Files.first != Files.second) [[likely]]
-        {
-            FMistData* LowerData = LoadCsvAsset<FMistData>(Files.first, _kMistHeaders);
-            FMistData* UpperData = LoadCsvAsset<FMistData>(Files.second, _kMistHeaders);
+        FMistData* StarData = Tracks.first;
+        std::span<const FMistRow> StarPhaseChanges = PhaseChanges.first;
 
-            auto LowerPhaseChanges = FindPhaseChanges(LowerData);
-            auto UpperPhaseChanges = FindPhaseChanges(UpperData);
+        if (Util::Equal(TargetAge, -1.0))
+        { // 年龄为 -1.0 代表要生成濒死恒星
+            double Lifetime = StarPhaseChanges.back()[_kStarAgeIndex];
+            TargetAge = Lifetime - 500000;
+        }
 
-            if (Util::Equal(TargetAge, -1.0)) // 年龄为 -1.0 代表要生成濒死恒星
+        double EvolutionProgress = 0.0;
+        double Lifetime = 0.0;
+        if (TargetMass >= 0.1)
+        {
+            auto EvolutionProgressResult = CalculateEvolutionProgress({ StarPhaseChanges, {} }, TargetAge, MassCoefficient);
+            if (!EvolutionProgressResult.has_value())
             {
-                double LowerLifetime = LowerPhaseChanges.back()[_kStarAgeIndex];
-                double UpperLifetime = UpperPhaseChanges.back()[_kStarAgeIndex];
-                double Lifetime = LowerLifetime + (UpperLifetime - LowerLifetime) * MassCoefficient;
-                TargetAge = Lifetime - 500000;
+                return std::unexpected(EvolutionProgressResult.error());
             }
 
-            std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>> PhaseChangePair
-            {
-                LowerPhaseChanges,
-                UpperPhaseChanges
-            };
+            EvolutionProgress = *EvolutionProgressResult;
+            Lifetime = StarPhaseChanges.back()[_kStarAgeIndex];
 
-            double EvolutionProgress = CalculateEvolutionProgress(PhaseChangePair, TargetAge, MassCoefficient);
-
-            double LowerLifetime = PhaseChangePair.first.back()[_kStarAgeIndex];
-            double UpperLifetime = PhaseChangePair.second.back()[_kStarAgeIndex];
-
-            std::vector<double> LowerRows = InterpolateStarData(LowerData, EvolutionProgress);
-            std::vector<double> UpperRows = InterpolateStarData(UpperData, EvolutionProgress);
-
-            LowerRows.emplace_back(LowerLifetime);
-            UpperRows.emplace_back(UpperLifetime);
-
-            Result = InterpolateFinalData({ LowerRows, UpperRows }, MassCoefficient, false);
+            FMistRow Row = InterpolateStarData(StarData, EvolutionProgress);
+            std::copy(Row.begin(), Row.end(), Result.begin());
+            Result[_kLifetimeIndex] = Lifetime;
         }
-        else [[unlikely]]
-        {
-            FMistData* StarData = LoadCsvAsset<FMistData>(Files.first, _kMistHeaders);
-            auto PhaseChanges = FindPhaseChanges(StarData);
-
-            if (Util::Equal(TargetAge, -1.0))
-            { // 年龄为 -1.0 代表要生成濒死恒星
-                double Lifetime = PhaseChanges.back()[_kStarAgeIndex];
-                TargetAge = Lifetime - 500000;
+        else
+        { // 外推小质量恒星的数据
+            double OriginalLowerPhaseChangePoint = StarPhaseChanges[1][_kStarAgeIndex];
+            double OriginalUpperPhaseChangePoint = StarPhaseChanges[2][_kStarAgeIndex];
+            double LowerPhaseChangePoint = OriginalLowerPhaseChangePoint * std::pow(TargetMass / 0.1, -1.3);
+            double UpperPhaseChangePoint = OriginalUpperPhaseChangePoint * std::pow(TargetMass / 0.1, -1.3);
+            Lifetime = UpperPhaseChangePoint;
+            if (TargetAge < LowerPhaseChangePoint)
+            {
+                EvolutionProgress = TargetAge / LowerPhaseChangePoint - 1;
             }
-
-            double EvolutionProgress = 0.0;
-            double Lifetime = 0.0;
-            if (TargetMass >= 0.1)
+            else if (LowerPhaseChangePoint <= TargetAge && TargetAge <= UpperPhaseChangePoint)
             {
-                std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>> PhaseChangePair{ PhaseChanges, {} };
-                EvolutionProgress = CalculateEvolutionProgress(PhaseChangePair, TargetAge, MassCoefficient);
-                Lifetime = PhaseChanges.back()[_kStarAgeIndex];
-                Result = InterpolateStarData(StarData, EvolutionProgress);
-                Result.emplace_back(Lifetime);
+                EvolutionProgress = (TargetAge - LowerPhaseChangePoint) / (UpperPhaseChangePoint - LowerPhaseChangePoint);
             }
-            else
-            { // 外推小质量恒星的数据
-                double OriginalLowerPhaseChangePoint = PhaseChanges[1][_kStarAgeIndex];
-                double OriginalUpperPhaseChangePoint = PhaseChanges[2][_kStarAgeIndex];
-                double LowerPhaseChangePoint = OriginalLowerPhaseChangePoint * std::pow(TargetMass / 0.1, -1.3);
-                double UpperPhaseChangePoint = OriginalUpperPhaseChangePoint * std::pow(TargetMass / 0.1, -1.3);
-                Lifetime = UpperPhaseChangePoint;
-                if (TargetAge < LowerPhaseChangePoint)
-                {
-                    EvolutionProgress = TargetAge / LowerPhaseChangePoint - 1;
-                }
-                else if (LowerPhaseChangePoint <= TargetAge && TargetAge <= UpperPhaseChangePoint)
-                {
-                    EvolutionProgress = (TargetAge - LowerPhaseChangePoint) / (UpperPhaseChangePoint - LowerPhaseChangePoint);
-                }
-                else if (TargetAge > UpperPhaseChangePoint)
-                {
-                    GenerateDeathStarPlaceholder(Lifetime);
-                }
-
-                Result = InterpolateStarData(StarData, EvolutionProgress);
-                Result.emplace_back(Lifetime);
-                ExpandMistData(TargetMass, Result);
+            else if (TargetAge > UpperPhaseChangePoint)
+            {
+                return std::unexpected(FEndOfTrack{ Lifetime });
             }
-        }
-    }
-    else
-    {
-        if (Files.first != Files.second) [[likely]]
-        {
-            FWdMistData* LowerData = LoadCsvAsset<FWdMistData>(Files.first,  _kWdMistHeaders);
-            FWdMistData* UpperData = LoadCsvAsset<FWdMistData>(Files.second, _kWdMistHeaders);
-
-            std::vector<double> LowerRows = InterpolateStarData(LowerData, TargetAge);
-            std::vector<double> UpperRows = InterpolateStarData(UpperData, TargetAge);
 
-            Result = InterpolateFinalData({ LowerRows, UpperRows }, MassCoefficient, true);
-        }
-        else [[unlikely]]
-        {
-            FWdMistData* StarData = LoadCsvAsset<FWdMistData>(Files.first, _kWdMistHeaders);
-            Result = InterpolateStarData(StarData, TargetAge);
+            FMistRow Row = InterpolateStarData(StarData, EvolutionProgress);
+            std::copy(Row.begin(), Row.end(), Result.begin());
+            Result[_kLifetimeIndex] = Lifetime;
+            ExpandMistData(TargetMass, Result);
         }
     }
 
     return Result;
 }
 
-std::vector<std::vector<double>> FStellarGenerator::FindPhaseChanges(const FMistData* DataCsv)
+FStellarGenerator::FWdMistRow FStellarGenerator::InterpolateWdMistData(const std::pair<FWdMistData*, FWdMistData*>& Tracks, double TargetAge, double MassCoefficient)
 {
-    std::vector<std::vector<double>> Result;
+    if (Tracks.first != Tracks.second) [[likely]]
+    {
+        FWdMistData* LowerData = Tracks.first;
+        FWdMistData* UpperData = Tracks.second;
+
+        FWdMistRow LowerRow = InterpolateStarData(LowerData, TargetAge);
+        FWdMistRow UpperRow = InterpolateStarData(UpperData, TargetAge);
 
+        return InterpolateFinalData(std::pair{ LowerRow, UpperRow }, MassCoefficient, true);
+    }
+    else [[unlikely]]
     {
-        std::shared_lock Lock(_kCacheMutex);
-        if (_kPhaseChangesCache.contains(DataCsv))
-        {
-            return _kPhaseChangesCache[DataCsv];
-        }
+        FWdMistData* StarData = Tracks.first;
+        return InterpolateStarData(StarData, TargetAge);
     }
+}
+
+std::vector<FStellarGenerator::FMistRow> FStellarGenerator::BuildPhaseChanges(const FMistData* DataCsv)
+{
+    std::vector<FMistRow> Result;
 
-    const auto* const DataArray = DataCsv->Data();
+    auto PhaseColumn = DataCsv->GetColumn(_kPhaseIndex);
+    auto XColumn     = DataCsv->GetColumn(_kXIndex);
     int CurrentPhase = -2;
-    for (const auto& Row : *DataArray)
+    for (std::size_t i = 0; i != PhaseColumn.size(); ++i)
     {
-        if (Row[_kPhaseIndex] != CurrentPhase || Row[_kXIndex] == 10.0)
+        if (PhaseColumn[i] != CurrentPhase || XColumn[i] == 10.0)
         {
-            CurrentPhase = static_cast<int>(Row[_kPhaseIndex]);
-            Result.emplace_back(Row);
+            CurrentPhase = static_cast<int>(PhaseColumn[i]);
+            Result.emplace_back(DataCsv->GetRow(i).ToArray());
         }
     }
 
+    if (Result.size() > _kMaxPhaseChanges)
     {
-        std::unique_lock Lock(_kCacheMutex);
-        if (!_kPhaseChangesCache.contains(DataCsv))
-        {
-            _kPhaseChangesCache.emplace(DataCsv, Result);
-        }
-        else
-        {
-            Result = _kPhaseChangesCache[DataCsv];
-        }
+        throw std::runtime_error(std::format("Too many phase changes in track: {}.", Result.size()));
     }
 
     return Result;
 }
 
-double FStellarGenerator::CalculateEvolutionProgress(std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>>& PhaseChanges, double TargetAge, double MassCoefficient)
+FStellarGenerator::TMistResult<double> FStellarGenerator::CalculateEvolutionProgress(const std::pair<std::span<const FMistRow>, std::span<const FMistRow>>& PhaseChanges, double TargetAge, double MassCoefficient)
 {
     double Result = 0.0;
     double Phase  = 0.0;
@@ -841,7 +1126,7 @@ double FStellarGenerator::CalculateEvolutionProgress(std::pair<std::vector<std::
         const auto& TimePoints = TimePointResults.second;
         if (TargetAge > TimePoints.second)
         {
-            GenerateDeathStarPlaceholder(TimePoints.second);
+            return std::unexpected(FEndOfTrack{ TimePoints.second });
         }
 
         Result = (TargetAge - TimePoints.first) / (TimePoints.second - TimePoints.first) + Phase;
@@ -851,10 +1136,14 @@ double FStellarGenerator::CalculateEvolutionProgress(std::pair<std::vector<std::
         if (PhaseChanges.first.size() == PhaseChanges.second.size() &&
             (*std::prev(PhaseChanges.first.end(), 2))[_kPhaseIndex] == (*std::prev(PhaseChanges.second.end(), 2))[_kPhaseIndex])
         {
-            const auto& TimePointResults = FindSurroundingTimePoints(PhaseChanges, TargetAge, MassCoefficient);
+            auto TimePointResults = FindSurroundingTimePoints(PhaseChanges, TargetAge, MassCoefficient);
+            if (!TimePointResults.has_value())
+            {
+                return std::unexpected(TimePointResults.error());
+            }
 
-            Phase = TimePointResults.first;
-            std::size_t Index = TimePointResults.second;
+            Phase = TimePointResults->first;
+            std::size_t Index = TimePointResults->second;
 
             if (Index + 1 != PhaseChanges.first.size())
             {
@@ -890,6 +1179,18 @@ double FStellarGenerator::CalculateEvolutionProgress(std::pair<std::vector<std::
         }
         else
         {
+            // 只在需要对齐时才把相变点拷贝到栈上的临时数组中修改
+            std::array<FMistRow, _kMaxPhaseChanges> LowerScratch;
+            std::array<FMistRow, _kMaxPhaseChanges> UpperScratch;
+            std::copy(PhaseChanges.first.begin(),  PhaseChanges.first.end(),  LowerScratch.begin());
+            std::copy(PhaseChanges.second.begin(), PhaseChanges.second.end(), UpperScratch.begin());
+
+            std::pair<std::span<FMistRow>, std::span<FMistRow>> AlignedPhaseChanges
+            {
+                std::span<FMistRow>(LowerScratch.data(), PhaseChanges.first.size()),
+                std::span<FMistRow>(UpperScratch.data(), PhaseChanges.second.size())
+            };
+
             if (PhaseChanges.first.back()[_kPhaseIndex] == PhaseChanges.second.back()[_kPhaseIndex])
             {
                 double FirstDiscardTimePoint = 0.0;
@@ -906,17 +1207,23 @@ double FStellarGenerator::CalculateEvolutionProgress(std::pair<std::vector<std::
                 }
 
                 double DeltaTimePoint = FirstCommonTimePoint - FirstDiscardTimePoint;
-                (*std::prev(PhaseChanges.first.end(), 2))[_kStarAgeIndex] -= DeltaTimePoint;
-                PhaseChanges.first.back()[_kStarAgeIndex] -= DeltaTimePoint;
+                (*std::prev(AlignedPhaseChanges.first.end(), 2))[_kStarAgeIndex] -= DeltaTimePoint;
+                AlignedPhaseChanges.first.back()[_kStarAgeIndex] -= DeltaTimePoint;
             }
 
-            AlignArrays(PhaseChanges);
+            AlignArrays(AlignedPhaseChanges);
+
+            auto AlignedResult = CalculateEvolutionProgress(AlignedPhaseChanges, TargetAge, MassCoefficient);
+            if (!AlignedResult.has_value())
+            {
+                return AlignedResult;
+            }
 
-            Result = CalculateEvolutionProgress(PhaseChanges, TargetAge, MassCoefficient);
+            Result = *AlignedResult;
             double IntegerPart = 0.0;
             double FractionalPart = std::modf(Result, &IntegerPart);
-            if (PhaseChanges.second.back()[_kPhaseIndex] == 9 && FractionalPart > 0.99 && Result < 9.0 &&
-                IntegerPart >= (*std::prev(PhaseChanges.first.end(), 3))[_kPhaseIndex])
+            if (AlignedPhaseChanges.second.back()[_kPhaseIndex] == 9 && FractionalPart > 0.99 && Result < 9.0 &&
+                IntegerPart >= (*std::prev(AlignedPhaseChanges.first.end(), 3))[_kPhaseIndex])
             {
                 Result = 9.0;
             }
@@ -926,21 +1233,21 @@ double FStellarGenerator::CalculateEvolutionProgress(std::pair<std::vector<std::
     return Result;
 }
 
-std::pair<double, std::pair<double, double>> FStellarGenerator::FindSurroundingTimePoints(const std::vector<std::vector<double>>& PhaseChanges, double TargetAge)
+std::pair<double, std::pair<double, double>> FStellarGenerator::FindSurroundingTimePoints(std::span<const FMistRow> PhaseChanges, double TargetAge)
 {
-    std::vector<std::vector<double>>::const_iterator LowerTimePoint;
-    std::vector<std::vector<double>>::const_iterator UpperTimePoint;
+    std::span<const FMistRow>::iterator LowerTimePoint;
+    std::span<const FMistRow>::iterator UpperTimePoint;
 
     if (PhaseChanges.size() != 2 || PhaseChanges.front()[_kPhaseIndex] != PhaseChanges.back()[_kPhaseIndex])
     {
         LowerTimePoint = std::lower_bound(PhaseChanges.begin(), PhaseChanges.end(), TargetAge,
-        [](const std::vector<double>& Lhs, double Rhs) -> bool
+        [](const FMistRow& Lhs, double Rhs) -> bool
         {
             return Lhs[0] < Rhs;
         });
 
         UpperTimePoint = std::upper_bound(PhaseChanges.begin(), PhaseChanges.end(), TargetAge,
-        [](double Lhs, const std::vector<double>& Rhs) -> bool
+        [](double Lhs, const FMistRow& Rhs) -> bool
         {
             return Lhs < Rhs[0];
         });
@@ -968,38 +1275,34 @@ std::pair<double, std::pair<double, double>> FStellarGenerator::FindSurroundingT
     return { (*LowerTimePoint)[_kXIndex], { (*LowerTimePoint)[_kStarAgeIndex], (*UpperTimePoint)[_kStarAgeIndex] } };
 }
 
-std::pair<double, std::size_t> FStellarGenerator::FindSurroundingTimePoints(const std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>>& PhaseChanges, double TargetAge, double MassCoefficient)
+FStellarGenerator::TMistResult<std::pair<double, std::size_t>> FStellarGenerator::FindSurroundingTimePoints(const std::pair<std::span<const FMistRow>, std::span<const FMistRow>>& PhaseChanges, double TargetAge, double MassCoefficient)
 {
-    std::vector<double> LowerPhaseChangeTimePoints;
-    std::vector<double> UpperPhaseChangeTimePoints;
-    for (std::size_t i = 0; i != PhaseChanges.first.size(); ++i)
+    if (PhaseChanges.first.size() != PhaseChanges.second.size())
     {
-        LowerPhaseChangeTimePoints.emplace_back(PhaseChanges.first[i][_kStarAgeIndex]);
-        UpperPhaseChangeTimePoints.emplace_back(PhaseChanges.second[i][_kStarAgeIndex]);
+        throw std::runtime_error("Data arrays size mismatch.");
     }
 
-    std::vector<double> PhaseChangeTimePoints =
-        InterpolateArray({ LowerPhaseChangeTimePoints, UpperPhaseChangeTimePoints }, MassCoefficient);
-
-    if (TargetAge > PhaseChangeTimePoints.back())
+    // 按质量插值相变时间点，逐点计算，不生成中间数组
+    auto InterpolateTimePoint = [&](std::size_t Index) -> double
     {
-        double Lifetime = LowerPhaseChangeTimePoints.back() +
-            (UpperPhaseChangeTimePoints.back() - LowerPhaseChangeTimePoints.back()) * MassCoefficient;
-        GenerateDeathStarPlaceholder(Lifetime);
-    }
+        double LowerTimePoint = PhaseChanges.first[Index][_kStarAgeIndex];
+        double UpperTimePoint = PhaseChanges.second[Index][_kStarAgeIndex];
+        return LowerTimePoint + (UpperTimePoint - LowerTimePoint) * MassCoefficient;
+    };
 
-    std::vector<std::pair<double, double>> TimePointPairs;
-    for (std::size_t i = 0; i != PhaseChanges.first.size(); ++i)
+    std::size_t Size = PhaseChanges.first.size();
+    if (TargetAge > InterpolateTimePoint(Size - 1))
     {
-        TimePointPairs.emplace_back(PhaseChanges.first[i][_kPhaseIndex], PhaseChangeTimePoints[i]);
+        double Lifetime = InterpolateTimePoint(Size - 1);
+        return std::unexpected(FEndOfTrack{ Lifetime });
     }
 
     std::pair<double, std::size_t> Result;
-    for (std::size_t i = 0; i != TimePointPairs.size(); ++i)
+    for (std::size_t i = 0; i != Size; ++i)
     {
-        if (TimePointPairs[i].second >= TargetAge)
+        if (InterpolateTimePoint(i) >= TargetAge)
         {
-            Result.first = TimePointPairs[i == 0 ? 0 : i - 1].first;
+            Result.first = PhaseChanges.first[i == 0 ? 0 : i - 1][_kPhaseIndex];
             Result.second = i == 0 ? 0 : i - 1;
             break;
         }
@@ -1008,67 +1311,68 @@ std::pair<double, std::size_t> FStellarGenerator::FindSurroundingTimePoints(cons
     return Result;
 }
 
-void FStellarGenerator::AlignArrays(std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>>& Arrays)
+void FStellarGenerator::AlignArrays(std::pair<std::span<FMistRow>, std::span<FMistRow>>& Arrays)
 {
+    // 对齐只会截短数组，末尾元素保存后再写回截短后的位置
     if (Arrays.first.back()[_kPhaseIndex] != 9 && Arrays.second.back()[_kPhaseIndex] != 9)
     {
         std::size_t MinSize = std::min(Arrays.first.size(), Arrays.second.size());
-        Arrays.first.resize(MinSize);
-        Arrays.second.resize(MinSize);
+        Arrays.first  = Arrays.first.first(MinSize);
+        Arrays.second = Arrays.second.first(MinSize);
     }
     else if (Arrays.first.back()[_kPhaseIndex] != 9 && Arrays.second.back()[_kPhaseIndex] == 9)
     {
         if (Arrays.first.size() + 1 == Arrays.second.size())
         {
-            Arrays.second.pop_back();
+            Arrays.second = Arrays.second.first(Arrays.second.size() - 1);
             Arrays.second.back()[_kPhaseIndex] = Arrays.first.back()[_kPhaseIndex];
             Arrays.second.back()[_kXIndex] = Arrays.first.back()[_kXIndex];
         }
         else
         {
             std::size_t MinSize = std::min(Arrays.first.size(), Arrays.second.size());
-            Arrays.first.resize(MinSize - 1);
-            Arrays.second.resize(MinSize - 1);
+            Arrays.first  = Arrays.first.first(MinSize - 1);
+            Arrays.second = Arrays.second.first(MinSize - 1);
             Arrays.second.back()[_kPhaseIndex] = Arrays.first.back()[_kPhaseIndex];
             Arrays.second.back()[_kXIndex] = Arrays.first.back()[_kXIndex];
         }
     }
     else if (Arrays.first.back()[_kPhaseIndex] == 9 && Arrays.second.back()[_kPhaseIndex] == 9)
     {
-        std::vector<double> LastArray1 = Arrays.first.back();
-        std::vector<double> LastArray2 = Arrays.second.back();
-        std::vector<double> SubLastArray1 = *std::prev(Arrays.first.end(), 2);
-        std::vector<double> SubLastArray2 = *std::prev(Arrays.second.end(), 2);
+        FMistRow LastArray1 = Arrays.first.back();
+        FMistRow LastArray2 = Arrays.second.back();
+        FMistRow SubLastArray1 = *std::prev(Arrays.first.end(), 2);
+        FMistRow SubLastArray2 = *std::prev(Arrays.second.end(), 2);
 
         std::size_t MinSize = std::min(Arrays.first.size(), Arrays.second.size());
 
-        Arrays.first.resize(MinSize - 2);
-        Arrays.second.resize(MinSize - 2);
-        Arrays.first.emplace_back(SubLastArray1);
-        Arrays.first.emplace_back(LastArray1);
-        Arrays.second.emplace_back(SubLastArray2);
-        Arrays.second.emplace_back(LastArray2);
+        Arrays.first  = Arrays.first.first(MinSize);
+        Arrays.second = Arrays.second.first(MinSize);
+        Arrays.first[MinSize - 2]  = SubLastArray1;
+        Arrays.first[MinSize - 1]  = LastArray1;
+        Arrays.second[MinSize - 2] = SubLastArray2;
+        Arrays.second[MinSize - 1] = LastArray2;
     }
     else
     {
-        std::vector<double> LastArray1 = Arrays.first.back();
-        std::vector<double> LastArray2 = Arrays.second.back();
+        FMistRow LastArray1 = Arrays.first.back();
+        FMistRow LastArray2 = Arrays.second.back();
         std::size_t MinSize = std::min(Arrays.first.size(), Arrays.second.size());
-        Arrays.first.resize(MinSize - 1);
-        Arrays.second.resize(MinSize - 1);
-        Arrays.first.emplace_back(LastArray1);
-        Arrays.second.emplace_back(LastArray2);
+        Arrays.first  = Arrays.first.first(MinSize);
+        Arrays.second = Arrays.second.first(MinSize);
+        Arrays.first[MinSize - 1]  = LastArray1;
+        Arrays.second[MinSize - 1] = LastArray2;
     }
 }
 
-std::vector<double> FStellarGenerator::InterpolateHrDiagram(FStellarGenerator::FHrDiagram* Data, double BvColorIndex)
+FStellarGenerator::FHrDiagramRow FStellarGenerator::InterpolateHrDiagram(FStellarGenerator::FHrDiagram* Data, double BvColorIndex)
 {
-    std::vector<double> Result;
-
-    std::pair<std::vector<double>, std::vector<double>> SurroundingRows;
+    std::pair<FHrDiagramRow, FHrDiagramRow> SurroundingRows{};
     try
     {
-        SurroundingRows = Data->FindSurroundingValues("B-V", BvColorIndex);
+        auto SurroundingRowViews = Data->FindSurroundingValues("B-V", BvColorIndex);
+        SurroundingRows.first  = SurroundingRowViews.first.ToArray();
+        SurroundingRows.second = SurroundingRowViews.second.ToArray();
     }
     catch (std::out_of_range& e)
     {
@@ -1077,38 +1381,33 @@ std::vector<double> FStellarGenerator::InterpolateHrDiagram(FStellarGenerator::F
 
     double Coefficient = (BvColorIndex - SurroundingRows.first[0]) / (SurroundingRows.second[0] - SurroundingRows.first[0]);
 
-    auto& Array1 = SurroundingRows.first;
-    auto& Array2 = SurroundingRows.second;
+    const auto& Array1 = SurroundingRows.first;
+    const auto& Array2 = SurroundingRows.second;
 
-    while (!Array1.empty() && !Array2.empty() && (Array1.back() == -1 || Array2.back() == -1))
+    // -1 表示该光度级在此色指数下没有数据，从末尾剔除并保留 -1 标记
+    std::size_t ValidSize = Array1.size();
+    while (ValidSize != 0 && (Array1[ValidSize - 1] == -1 || Array2[ValidSize - 1] == -1))
     {
-        Array1.pop_back();
-        Array2.pop_back();
+        --ValidSize;
     }
 
-    Result = InterpolateArray(SurroundingRows, Coefficient);
+    FHrDiagramRow Result = InterpolateArray(SurroundingRows, Coefficient);
+    std::fill(Result.begin() + ValidSize, Result.end(), -1.0);
 
     return Result;
 }
 
-std::vector<double> FStellarGenerator::InterpolateStarData(FStellarGenerator::FMistData* Data, double EvolutionProgress)
-{
-    return InterpolateStarData(Data, EvolutionProgress, "x", FStellarGenerator::_kXIndex, false);
-}
-
-std::vector<double> FStellarGenerator::InterpolateStarData(FStellarGenerator::FWdMistData* Data, double TargetAge)
-{
-    return InterpolateStarData(Data, TargetAge, "star_age", FStellarGenerator::_kWdStarAgeIndex, true);
-}
-
-std::vector<double> FStellarGenerator::InterpolateStarData(auto* Data, double Target, const std::string& Header, int Index, bool bIsWhiteDwarf)
+auto FStellarGenerator::InterpolateStarData(auto* Data, double Target, const std::string& Header, int Index, bool bIsWhiteDwarf)
 {
-    std::vector<double> Result;
+    using FRowType = decltype(Data->GetRow(0).ToArray());
 
-    std::pair<std::vector<double>, std::vector<double>> SurroundingRows;
+    FRowType Result{};
+    std::pair<FRowType, FRowType> SurroundingRows{};
     try
     {
-        SurroundingRows = Data->FindSurroundingValues(Header, Target);
+        auto SurroundingRowViews = Data->FindSurroundingValues(static_cast<std::size_t>(Index), Target);
+        SurroundingRows.first  = SurroundingRowViews.first.ToArray();
+        SurroundingRows.second = SurroundingRowViews.second.ToArray();
     }
     catch (std::out_of_range& e)
     {
@@ -1119,8 +1418,8 @@ std::vector<double> FStellarGenerator::InterpolateStarData(auto* Data, double Ta
         }
         else
         {
-            SurroundingRows.first  = Data->Data()->back();
-            SurroundingRows.second = Data->Data()->back();
+            SurroundingRows.first  = Data->GetRow(Data->GetRowCount() - 1).ToArray();
+            SurroundingRows.second = SurroundingRows.first;
         }
     }
 
@@ -1148,15 +1447,20 @@ std::vector<double> FStellarGenerator::InterpolateStarData(auto* Data, double Ta
     return Result;
 }
 
-std::vector<double> FStellarGenerator::InterpolateArray(const std::pair<std::vector<double>, std::vector<double>>& DataArrays, double Coefficient)
+FStellarGenerator::FMistRow FStellarGenerator::InterpolateStarData(FStellarGenerator::FMistData* Data, double EvolutionProgress)
 {
-    if (DataArrays.first.size() != DataArrays.second.size())
-    {
-        throw std::runtime_error("Data arrays size mismatch.");
-    }
+    return InterpolateStarData(Data, EvolutionProgress, "x", FStellarGenerator::_kXIndex, false);
+}
 
-    std::size_t Size = DataArrays.first.size();
-    std::vector<double> Result(Size);
+FStellarGenerator::FWdMistRow FStellarGenerator::InterpolateStarData(FStellarGenerator::FWdMistData* Data, double TargetAge)
+{
+    return InterpolateStarData(Data, TargetAge, "star_age", FStellarGenerator::_kWdStarAgeIndex, true);
+}
+
+template <std::size_t Size>
+std::array<double, Size> FStellarGenerator::InterpolateArray(const std::pair<std::array<double, Size>, std::array<double, Size>>& DataArrays, double Coefficient)
+{
+    std::array<double, Size> Result{};
     for (std::size_t i = 0; i != Size; ++i)
     {
         Result[i] = DataArrays.first[i] + (DataArrays.second[i] - DataArrays.first[i]) * Coefficient;
@@ -1165,14 +1469,10 @@ std::vector<double> FStellarGenerator::InterpolateArray(const std::pair<std::vec
     return Result;
 }
 
-std::vector<double> FStellarGenerator::InterpolateFinalData(const std::pair<std::vector<double>, std::vector<double>>& DataArrays, double Coefficient, bool bIsWhiteDwarf)
+template <std::size_t Size>
+std::array<double, Size> FStellarGenerator::InterpolateFinalData(const std::pair<std::array<double, Size>, std::array<double, Size>>& DataArrays, double Coefficient, bool bIsWhiteDwarf)
 {
-    if (DataArrays.first.size() != DataArrays.second.size())
-    {
-        throw std::runtime_error("Data arrays size mismatch.");
-    }
-
-    std::vector<double> Result = InterpolateArray(DataArrays, Coefficient);
+    std::array<double, Size> Result = InterpolateArray(DataArrays, Coefficient);
 
     if (!bIsWhiteDwarf)
     {
@@ -1499,23 +1799,19 @@ Astro::FStellarClass::ELuminosityClass FStellarGenerator::CalculateLuminosityCla
         }
     }
 
-    std::vector<double> LuminosityData = InterpolateHrDiagram(HrDiagramData, BvColorIndex);
+    FHrDiagramRow LuminosityData = InterpolateHrDiagram(HrDiagramData, BvColorIndex);
     if (LuminositySol > LuminosityData[1])
     {
         return Astro::FStellarClass::ELuminosityClass::kLuminosity_Ia;
     }
 
-    double ClosestValue = *std::min_element(LuminosityData.begin() + 1, LuminosityData.end(),
+    auto ValidEnd = std::find(LuminosityData.begin() + 1, LuminosityData.end(), -1.0);
+    double ClosestValue = *std::min_element(LuminosityData.begin() + 1, ValidEnd,
     [LuminositySol](double Lhs, double Rhs) -> bool
     {
         return std::abs(Lhs - LuminositySol) < std::abs(Rhs - LuminositySol);
     });
 
-    while (LuminosityData.size() < 7)
-    {
-        LuminosityData.emplace_back(-1);
-    }
-
     if (LuminositySol <= LuminosityData[1] && LuminositySol >= LuminosityData[2] &&
         (ClosestValue == LuminosityData[1] || ClosestValue == LuminosityData[2]))
     {
@@ -1570,7 +1866,7 @@ void FStellarGenerator::ProcessDeathStar(Astro::AStar& DeathStar, EGenerateOptio
         Properties.InitialMassSol = InputMassSol;
         Properties.TypeOption = EGenerateOption::kNormal;
 
-        auto GiantStar = GenerateStar(Properties);
+        auto GiantStar = GenerateStarImpl(Properties, nullptr);
 
         return static_cast<float>(GiantStar.GetMass() / kSolarMass * 0.8);
     };
@@ -1796,8 +2092,8 @@ void FStellarGenerator::ProcessDeathStar(Astro::AStar& DeathStar, EGenerateOptio
     {
     case Astro::FStellarClass::EStarType::kWhiteDwarf:
     {
-        std::vector<double> WhiteDwarfData =
-            GetFullMistData({ static_cast<float>(DeathStarAge), 0.0f, DeathStarMassSol }, true, true);
+        FWdMistRow WhiteDwarfData =
+            GetFullWdMistData({ static_cast<float>(DeathStarAge), 0.0f, DeathStarMassSol }, true);
 
         StarAge      = static_cast<float>(WhiteDwarfData[_kWdStarAgeIndex]);
         LogR         = static_cast<float>(WhiteDwarfData[_kWdLogRIndex]);
@@ -2071,7 +2367,7 @@ void FStellarGenerator::GenerateSpin(Astro::AStar& StarData)
     StarData.SetSpin(Spin);
 }
 
-void FStellarGenerator::ExpandMistData(double TargetMass, std::vector<double>& StarData)
+void FStellarGenerator::ExpandMistData(double TargetMass, FMistStarData& StarData)
 {
     double RadiusSol     = std::pow(10.0, StarData[_kLogRIndex]);
     double Teff          = std::pow(10.0, StarData[_kLogTeffIndex]);
@@ -2096,6 +2392,32 @@ void FStellarGenerator::ExpandMistData(double TargetMass, std::vector<double>& S
     LogR = std::log10(RadiusSol);
 }
 
+void FStellarGenerator::Reseed(std::uint64_t Counter, std::uint64_t Stream)
+{
+    Util::FCounterSeedSequence SeedSequence(_CounterSeedKey, Counter, Stream);
+    _RandomEngine.seed(SeedSequence);
+
+    // 正态分布等会缓存上一次多生成的值，需要一并清除
+    for (auto& Generator : _MagneticGenerators)
+    {
+        Generator.Reset();
+    }
+
+    for (auto& Generator : _FeHGenerators)
+    {
+        Generator->Reset();
+    }
+
+    for (auto& Generator : _SpinGenerators)
+    {
+        Generator.Reset();
+    }
+
+    _LogMassGenerator->Reset();
+    _AgeGenerator.Reset();
+    _CommonGenerator.Reset();
+}
+
 const int FStellarGenerator::_kStarAgeIndex        = 0;
 const int FStellarGenerator::_kStarMassIndex       = 1;
 const int FStellarGenerator::_kStarMdotIndex       = 2;
@@ -2109,6 +2431,7 @@ const int FStellarGenerator::_kLogCenterRhoIndex   = 9;
 const int FStellarGenerator::_kPhaseIndex          = 10;
 const int FStellarGenerator::_kXIndex              = 11;
 const int FStellarGenerator::_kLifetimeIndex       = 12;
+const int FStellarGenerator::_kFeHIndex            = 13;
 
 const int FStellarGenerator::_kWdStarAgeIndex      = 0;
 const int FStellarGenerator::_kWdLogRIndex         = 1;
@@ -2128,8 +2451,10 @@ const std::vector<std::string> FStellarGenerator::_kWdMistHeaders
 };
 
 const std::vector<std::string> FStellarGenerator::_kHrDiagramHeaders{ "B-V", "Ia", "Ib", "II", "III", "IV", "V" };
-std::unordered_map<std::string, std::vector<float>> FStellarGenerator::_kMassFilesCache;
-std::unordered_map<const FStellarGenerator::FMistData*, std::vector<std::vector<double>>> FStellarGenerator::_kPhaseChangesCache;
+std::array<FStellarGenerator::TTrackIndex<FStellarGenerator::FMistData>, 8> FStellarGenerator::_kMistTrackIndices;
+std::array<FStellarGenerator::TTrackIndex<FStellarGenerator::FWdMistData>, 2> FStellarGenerator::_kWdMistTrackIndices;
+std::unordered_map<std::string, std::unique_ptr<FStellarGenerator::FMistPack>> FStellarGenerator::_kMistPacks;
+std::unordered_map<std::string, std::unique_ptr<FStellarGenerator::FWdMistPack>> FStellarGenerator::_kWdMistPacks;
 std::shared_mutex FStellarGenerator::_kCacheMutex;
 bool FStellarGenerator::_kbMistDataInitiated = false;
 
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <array>
+#include <expected>
 #include <functional>
 #include <memory>
 #include <random>
 #include <shared_mutex>
+#include <span>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -14,6 +17,7 @@
 
 #include "Engine/Core/Base/Base.h"
 #include "Engine/Core/Runtime/Assets/CommaSeparatedValues.hpp"
+#include "Engine/Core/Runtime/Assets/TrackPack.hpp"
 #include "Engine/Core/Types/Entries/Astro/Star.h"
 #include "Engine/Core/Types/Properties/StellarClass.h"
 #include "Engine/Utils/Random.hpp"
@@ -25,9 +29,52 @@ _GENERATOR_BEGIN
 class FStellarGenerator
 {
 public:
-    using FMistData   = Runtime::Asset::TCommaSeparatedValues<double, 12>;
-    using FWdMistData = Runtime::Asset::TCommaSeparatedValues<double, 5>;
-    using FHrDiagram  = Runtime::Asset::TCommaSeparatedValues<double, 7>;
+    using FMistData   = Runtime::Asset::TCommaSeparatedValues<double, 12, Runtime::Asset::EStorageMode::kColumnMajor>;
+    using FWdMistData = Runtime::Asset::TCommaSeparatedValues<double, 5,  Runtime::Asset::EStorageMode::kColumnMajor>;
+    using FHrDiagram  = Runtime::Asset::TCommaSeparatedValues<double, 7,  Runtime::Asset::EStorageMode::kColumnMajor>;
+    using FMistPack   = Runtime::Asset::TTrackPack<double, 12>;
+    using FWdMistPack = Runtime::Asset::TTrackPack<double, 5>;
+
+    using FMistRow      = std::array<double, 12>;
+    using FWdMistRow    = std::array<double, 5>;
+    using FHrDiagramRow = std::array<double, 7>;
+    using FMistStarData = std::array<double, 14>; // MIST 行数据、寿命和插值使用的金属丰度
+
+    // 目标年龄超出演化轨迹末端，恒星已经死亡，携带插值得到的寿命
+    struct FEndOfTrack
+    {
+        double Lifetime{};
+    };
+
+    template <typename Ty>
+    using TMistResult = std::expected<Ty, FEndOfTrack>;
+
+    // 一个金属丰度格点（或白矮星目录）下按质量升序排列的轨迹
+    template <typename CsvType>
+    struct TTrackIndex
+    {
+        std::vector<float>    Masses;
+        std::vector<CsvType*> Tracks;
+        std::vector<std::vector<FMistRow>> PhaseChanges; // 与 Tracks 一一对应的相变点，仅 MIST 轨迹使用
+    };
+
+    // 恒星所在的 [Fe/H] 格点和上下两条质量轨迹在 TTrackIndex 中的下标
+    struct FTrackBracket
+    {
+        std::size_t FeHIndex{};
+        std::size_t LowerIndex{};
+        std::size_t UpperIndex{};
+    };
+
+    // MIST 中以对数存储的列换算后的线性值
+    struct FLinearMistData
+    {
+        double Teff{};
+        double RadiusSol{};
+        double SurfaceZ{};
+        double CoreTemp{};
+        double CoreDensity{};
+    };
 
     enum class EGenerateDistribution
     {
@@ -57,6 +104,8 @@ public:
         EGenerateOption MultiOption;
         EGenerateOption TypeOption;
 
+        std::uint64_t SeedCounter{}; // 计数器种子模式下该恒星随机数流的编号，由 SetStarSeedCounter 写入
+
         explicit operator Astro::AStar() const
         {
             Astro::AStar Star;
@@ -98,6 +147,9 @@ public:
     Astro::AStar GenerateStar(FBasicProperties& Properties);
     Astro::AStar GenerateStar(FBasicProperties&& Properties);
 
+    // 批量生成，按轨迹区间分桶后连续插值，Stars 的大小必须与 PropertiesList 相同
+    void GenerateStars(std::span<const FBasicProperties> PropertiesList, std::span<Astro::AStar> Stars);
+
     FStellarGenerator& SetLogMassSuggestDistribution(std::unique_ptr<Util::TDistribution<>> Distribution);
     FStellarGenerator& SetUniverseAge(float Age);
     FStellarGenerator& SetAgeLowerLimit(float Limit);
@@ -117,33 +169,73 @@ public:
     FStellarGenerator& SetMassDistribution(EGenerateDistribution Distribution);
     FStellarGenerator& SetGenerateOption(EGenerateOption Option);
 
+    // 开启计数器种子模式，生成基础属性和完整数据前都用 (Key, 恒星编号) 重新播种
+    // 每颗恒星的结果只取决于 Key 和编号，与使用哪个生成器、线程数和生成顺序无关
+    FStellarGenerator& SetCounterSeedKey(std::uint64_t Key);
+    // 指定下一次生成基础属性的恒星编号，生成的属性会记下该编号，供生成完整数据时再次播种
+    FStellarGenerator& SetStarSeedCounter(std::uint64_t Counter);
+    // 非计数器种子模式下按固定的段播种，ReseedSegment 后的随机数只取决于 Key 和段编号，与由哪个生成器处理无关
+    FStellarGenerator& SetSegmentSeedKey(std::uint64_t Key);
+    void ReseedSegment(std::uint64_t SegmentIndex);
+
 private:
     template <typename CsvType>
     CsvType* LoadCsvAsset(const std::string& Filename, const std::vector<std::string>& Headers);
 
+    template <typename CsvType, typename PackType>
+    std::vector<float> LoadTrackPack(const std::string& PrefixDirectory, const std::string& PackFilename,
+                                     const std::vector<std::string>& Headers,
+                                     std::unordered_map<std::string, std::unique_ptr<PackType>>& Packs);
+
+    template <typename CsvType>
+    TTrackIndex<CsvType> BuildTrackIndex(const std::string& PrefixDirectory, std::vector<float> Masses,
+                                         const std::vector<std::string>& Headers);
+
+    template <typename CsvType, typename PackType>
+    CsvType* LoadTrackFromPack(const std::unordered_map<std::string, std::unique_ptr<PackType>>& Packs,
+                               const std::string& Filename, const std::vector<std::string>& Headers);
+
     void InitMistData();
     void InitPdfs();
     float GenerateAge(float MaxPdf);
     float GenerateMass(float MaxPdf, auto& LogMassPdf);
-    std::vector<double> GetFullMistData(const FBasicProperties& Properties, bool bIsWhiteDwarf, bool bIsSingleWhiteDwarf);
-    std::vector<double> InterpolateMistData(const std::pair<std::string, std::string>& Files, double TargetAge, double TargetMass, double MassCoefficient);
-    std::vector<std::vector<double>> FindPhaseChanges(const FMistData* DataCsv);
-    double CalculateEvolutionProgress(std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>>& PhaseChanges, double TargetAge, double MassCoefficient);
-    std::pair<double, std::pair<double, double>> FindSurroundingTimePoints(const std::vector<std::vector<double>>& PhaseChanges, double TargetAge);
-    std::pair<double, std::size_t> FindSurroundingTimePoints(const std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>>& PhaseChanges, double TargetAge, double MassCoefficient);
-    void AlignArrays(std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>>& Arrays);
-    std::vector<double> InterpolateHrDiagram(FHrDiagram* Data, double BvColorIndex);
-    std::vector<double> InterpolateStarData(FMistData* Data, double EvolutionProgress);
-    std::vector<double> InterpolateStarData(FWdMistData* Data, double TargetAge);
-    std::vector<double> InterpolateStarData(auto* Data, double Target, const std::string& Header, int Index, bool bIsWhiteDwarf);
-    std::vector<double> InterpolateArray(const std::pair<std::vector<double>, std::vector<double>>& DataArrays, double Coefficient);
-    std::vector<double> InterpolateFinalData(const std::pair<std::vector<double>, std::vector<double>>& DataArrays, double Coefficient, bool bIsWhiteDwarf);
+    Astro::AStar GenerateStarImpl(FBasicProperties& Properties, const FTrackBracket* Bracket);
+    Astro::AStar GenerateEndOfTrackStar(FBasicProperties& Properties, const FEndOfTrack& EndOfTrack);
+    void FillStarData(const FMistStarData& StarData, const FLinearMistData& LinearData, const FBasicProperties& Properties, Astro::AStar& Star);
+    TMistResult<FMistStarData> GetFullMistData(const FBasicProperties& Properties);
+    TMistResult<FMistStarData> GetFullMistData(const FBasicProperties& Properties, const FTrackBracket& Bracket);
+    FTrackBracket FindMistTrackBracket(float TargetFeH, float TargetMass);
+    std::pair<std::size_t, std::size_t> FindMassBracket(const std::vector<float>& Masses, float TargetMass, bool bIsWhiteDwarf);
+    FWdMistRow GetFullWdMistData(const FBasicProperties& Properties, bool bIsSingleWhiteDwarf);
+
+    template <typename CsvType>
+    std::pair<std::pair<CsvType*, CsvType*>, double> FindTracks(const TTrackIndex<CsvType>& TrackIndex, float TargetMass, bool bIsWhiteDwarf);
+
+    TMistResult<FMistStarData> InterpolateMistData(const std::pair<FMistData*, FMistData*>& Tracks, const std::pair<std::span<const FMistRow>, std::span<const FMistRow>>& PhaseChanges, double TargetAge, double TargetMass, double MassCoefficient);
+    FWdMistRow InterpolateWdMistData(const std::pair<FWdMistData*, FWdMistData*>& Tracks, double TargetAge, double MassCoefficient);
+    std::vector<FMistRow> BuildPhaseChanges(const FMistData* DataCsv);
+    TMistResult<double> CalculateEvolutionProgress(const std::pair<std::span<const FMistRow>, std::span<const FMistRow>>& PhaseChanges, double TargetAge, double MassCoefficient);
+    std::pair<double, std::pair<double, double>> FindSurroundingTimePoints(std::span<const FMistRow> PhaseChanges, double TargetAge);
+    TMistResult<std::pair<double, std::size_t>> FindSurroundingTimePoints(const std::pair<std::span<const FMistRow>, std::span<const FMistRow>>& PhaseChanges, double TargetAge, double MassCoefficient);
+    void AlignArrays(std::pair<std::span<FMistRow>, std::span<FMistRow>>& Arrays);
+    FHrDiagramRow InterpolateHrDiagram(FHrDiagram* Data, double BvColorIndex);
+    FMistRow InterpolateStarData(FMistData* Data, double EvolutionProgress);
+    FWdMistRow InterpolateStarData(FWdMistData* Data, double TargetAge);
+    auto InterpolateStarData(auto* Data, double Target, const std::string& Header, int Index, bool bIsWhiteDwarf);
+
+    template <std::size_t Size>
+    std::array<double, Size> InterpolateArray(const std::pair<std::array<double, Size>, std::array<double, Size>>& DataArrays, double Coefficient);
+
+    template <std::size_t Size>
+    std::array<double, Size> InterpolateFinalData(const std::pair<std::array<double, Size>, std::array<double, Size>>& DataArrays, double Coefficient, bool bIsWhiteDwarf);
+
     void CalculateSpectralType(float FeH, Astro::AStar& StarData);
     Astro::FStellarClass::ELuminosityClass CalculateLuminosityClass(const Astro::AStar& StarData);
     void ProcessDeathStar(Astro::AStar& DeathStar, EGenerateOption Option = EGenerateOption::kNormal);
     void GenerateMagnetic(Astro::AStar& StarData);
     void GenerateSpin(Astro::AStar& StarData);
-    void ExpandMistData(double TargetMass, std::vector<double>& StarData);
+    void ExpandMistData(double TargetMass, FMistStarData& StarData);
+    void Reseed(std::uint64_t Counter, std::uint64_t Stream);
 
 public:
     static const int _kStarAgeIndex;
@@ -159,6 +251,7 @@ public:
     static const int _kPhaseIndex;
     static const int _kXIndex;
     static const int _kLifetimeIndex;
+    static const int _kFeHIndex;
 
     static const int _kWdStarAgeIndex;
     static const int _kWdLogRIndex;
@@ -196,11 +289,23 @@ private:
     EGenerateDistribution _MassDistribution;
     EGenerateOption       _Option;
 
+    std::uint64_t _CounterSeedKey;
+    std::uint64_t _StarSeedCounter;
+    bool          _bUseCounterSeed;
+
+    static constexpr std::array<float, 8> _kPresetFeH{ -4.0f, -3.0f, -2.0f, -1.5f, -1.0f, -0.5f, 0.0f, 0.5f };
+    static constexpr std::uint64_t _kBasicPropertiesStream = 0; // 计数器种子模式下各阶段和按段播种使用的随机数流
+    static constexpr std::uint64_t _kStarDataStream        = 1;
+    static constexpr std::uint64_t _kSegmentStream         = 2;
+    static constexpr std::size_t _kMaxPhaseChanges = 16; // 单条轨迹相变点数的上限，用于对齐时的栈上临时数组
+
     static const std::vector<std::string> _kMistHeaders;
     static const std::vector<std::string> _kWdMistHeaders;
     static const std::vector<std::string> _kHrDiagramHeaders;
-    static std::unordered_map<std::string, std::vector<float>> _kMassFilesCache;
-    static std::unordered_map<const FMistData*, std::vector<std::vector<double>>> _kPhaseChangesCache;
+    static std::array<TTrackIndex<FMistData>, 8> _kMistTrackIndices;
+    static std::array<TTrackIndex<FWdMistData>, 2> _kWdMistTrackIndices;
+    static std::unordered_map<std::string, std::unique_ptr<FMistPack>> _kMistPacks;
+    static std::unordered_map<std::string, std::unique_ptr<FWdMistPack>> _kWdMistPacks;
     static std::shared_mutex _kCacheMutex;
     static bool _kbMistDataInitiated;
 };
@@ -114,6 +114,30 @@ NPGS_INLINE FStellarGenerator& FStellarGenerator::SetGenerateOption(EGenerateOpt
     return *this;
 }
 
+NPGS_INLINE FStellarGenerator& FStellarGenerator::SetCounterSeedKey(std::uint64_t Key)
+{
+    _CounterSeedKey  = Key;
+    _bUseCounterSeed = true;
+    return *this;
+}
+
+NPGS_INLINE FStellarGenerator& FStellarGenerator::SetStarSeedCounter(std::uint64_t Counter)
+{
+    _StarSeedCounter = Counter;
+    return *this;
+}
+
+NPGS_INLINE FStellarGenerator& FStellarGenerator::SetSegmentSeedKey(std::uint64_t Key)
+{
+    _CounterSeedKey = Key;
+    return *this;
+}
+
+NPGS_INLINE void FStellarGenerator::ReseedSegment(std::uint64_t SegmentIndex)
+{
+    Reseed(SegmentIndex, _kSegmentStream);
+}
+
 _GENERATOR_END
 _SYSTEM_END
 _NPGS_END
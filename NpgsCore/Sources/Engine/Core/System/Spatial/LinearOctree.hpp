@@ -0,0 +1,514 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Engine/Core/Base/Base.h"
+#include "Engine/Core/Runtime/Threads/ThreadPool.h"
+
+_NPGS_BEGIN
+_SYSTEM_BEGIN
+_SPATIAL_BEGIN
+
+// 线性八叉树的叶子，对应一个格子，最多存放一个点和一个链接
+template <typename LinkTarget>
+class TLinearOctreeLeaf
+{
+public:
+    TLinearOctreeLeaf()
+        : _Point(0.0f), _Link(nullptr), _bIsValid(true), _bHasPoint(false)
+    {
+    }
+
+    bool GetValidation() const
+    {
+        return _bIsValid;
+    }
+
+    void SetValidation(bool bValidation)
+    {
+        _bIsValid = bValidation;
+    }
+
+    bool HasPoint() const
+    {
+        return _bHasPoint;
+    }
+
+    const glm::vec3& GetPoint() const
+    {
+        return _Point;
+    }
+
+    void SetPoint(const glm::vec3& Point)
+    {
+        _Point     = Point;
+        _bHasPoint = true;
+    }
+
+    void RemoveStorage()
+    {
+        _bHasPoint = false;
+    }
+
+    LinkTarget* GetLink() const
+    {
+        return _Link;
+    }
+
+    void SetLink(LinkTarget* Target)
+    {
+        _Link = Target;
+    }
+
+    void RemoveLink()
+    {
+        _Link = nullptr;
+    }
+
+private:
+    glm::vec3   _Point;
+    LinkTarget* _Link;
+    bool        _bIsValid;
+    bool        _bHasPoint;
+};
+
+// 完整八叉树的线性存储，只保存最深一层的叶子，叶子在数组中的下标就是它的 Morton 码
+// 第 Level 层（根为第 0 层）节点的编号为其下叶子编号右移 3 * (Depth - Level) 位，父子节点由移位得到，
+// 一个节点的全部叶子在数组中连续，因此建树、标记和遍历都是线性扫描，没有逐节点的堆分配
+// Morton 码中每 3 位的顺序与 TOctreeNode::CalculateOctant 相同，x 为高位，z 为低位
+template <typename LinkTarget>
+class TLinearOctree
+{
+public:
+    using FLeafType = TLinearOctreeLeaf<LinkTarget>;
+
+    static constexpr std::size_t kInvalidIndex = std::numeric_limits<std::size_t>::max();
+    static constexpr int         kMaxDepth     = 21; // 每个坐标 21 位，Morton 码不超过 63 位
+
+public:
+    TLinearOctree(const glm::vec3& Center, float Radius)
+        :
+        _Center(Center), _Radius(Radius), _LeafRadius(Radius), _Depth(0), _Leaves(1),
+        _ThreadPool(Runtime::Thread::FThreadPool::GetInstance())
+    {
+    }
+
+    // 一次分配全部叶子，叶子半径为不大于 LeafRadius 的 Radius / 2^n
+    void BuildEmptyTree(float LeafRadius)
+    {
+        int Depth = std::max(0, static_cast<int>(std::ceil(std::log2(_Radius / LeafRadius))));
+        if (Depth > kMaxDepth)
+        {
+            throw std::invalid_argument("Linear octree depth exceeds the range of Morton code.");
+        }
+
+        _Depth      = Depth;
+        _LeafRadius = _Radius / static_cast<float>(std::size_t{ 1 } << Depth);
+        _Leaves.assign(std::size_t{ 1 } << (3 * Depth), FLeafType());
+    }
+
+    // 返回包含 Point 的叶子的下标，Point 不在树的范围内时返回 kInvalidIndex
+    std::size_t FindLeaf(const glm::vec3& Point) const
+    {
+        glm::vec3 Offset = (Point - _Center + glm::vec3(_Radius)) / (2.0f * _LeafRadius);
+        float MaxCoord = static_cast<float>(std::size_t{ 1 } << _Depth);
+        if (Offset.x < 0.0f || Offset.y < 0.0f || Offset.z < 0.0f ||
+            Offset.x > MaxCoord || Offset.y > MaxCoord || Offset.z > MaxCoord)
+        {
+            return kInvalidIndex;
+        }
+
+        // 与 TOctreeNode::Contains 一样包含上边界
+        std::uint32_t MaxCell = (std::uint32_t{ 1 } << _Depth) - 1;
+        return static_cast<std::size_t>(EncodeMorton(std::min(static_cast<std::uint32_t>(Offset.x), MaxCell),
+                                                     std::min(static_cast<std::uint32_t>(Offset.y), MaxCell),
+                                                     std::min(static_cast<std::uint32_t>(Offset.z), MaxCell)));
+    }
+
+    // 包含 Point 的有效叶子链接的对象，没有时返回 nullptr，只需要一次 Morton 编码
+    LinkTarget* FindLink(const glm::vec3& Point) const
+    {
+        std::size_t LeafIndex = FindLeaf(Point);
+        if (LeafIndex == kInvalidIndex || !_Leaves[LeafIndex].GetValidation())
+        {
+            return nullptr;
+        }
+
+        return _Leaves[LeafIndex].GetLink();
+    }
+
+    glm::vec3 GetLeafCenter(std::size_t LeafIndex) const
+    {
+        return GetNodeCenter(_Depth, LeafIndex);
+    }
+
+    // 第 Level 层编号为 NodeIndex 的节点的中心
+    glm::vec3 GetNodeCenter(int Level, std::size_t NodeIndex) const
+    {
+        std::uint32_t X = 0, Y = 0, Z = 0;
+        DecodeMorton(NodeIndex, X, Y, Z);
+
+        float NodeRadius = GetNodeRadius(Level);
+        glm::vec3 Cell(static_cast<float>(X), static_cast<float>(Y), static_cast<float>(Z));
+        return _Center - glm::vec3(_Radius) + (2.0f * Cell + glm::vec3(1.0f)) * NodeRadius;
+    }
+
+    float GetNodeRadius(int Level) const
+    {
+        return _Radius / static_cast<float>(std::size_t{ 1 } << Level);
+    }
+
+    // 第 Level 层编号为 NodeIndex 的节点下全部叶子的下标范围 [First, Last)
+    std::pair<std::size_t, std::size_t> GetLeafRange(int Level, std::size_t NodeIndex) const
+    {
+        int Shift = 3 * (_Depth - Level);
+        return { NodeIndex << Shift, (NodeIndex + 1) << Shift };
+    }
+
+    static std::size_t GetParentIndex(std::size_t NodeIndex)
+    {
+        return NodeIndex >> 3;
+    }
+
+    static std::size_t GetChildIndex(std::size_t NodeIndex, int Octant)
+    {
+        return (NodeIndex << 3) | static_cast<std::size_t>(Octant);
+    }
+
+    template <typename Func>
+    void ForEachLeaf(Func&& Pred)
+    {
+        ForEachLeaf(0, _Leaves.size(), std::forward<Func>(Pred));
+    }
+
+    // 按 Morton 码顺序对 [First, Last) 中的叶子调用 Pred(LeafIndex, Leaf)
+    template <typename Func>
+    void ForEachLeaf(std::size_t First, std::size_t Last, Func&& Pred)
+    {
+        for (std::size_t i = First; i != Last; ++i)
+        {
+            Pred(i, _Leaves[i]);
+        }
+    }
+
+    // 把叶子按 Morton 码切成连续的区间交给线程池处理，返回时所有叶子都已处理完
+    // 不同叶子可能在不同线程中同时处理，Pred 只能修改传入的叶子，访问其他共享数据需要自行同步
+    template <typename Func>
+    void ParallelForEachLeaf(Func&& Pred, std::size_t Grain = 4096)
+    {
+        _ThreadPool->ParallelFor(0, _Leaves.size(), Grain, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+        {
+            ForEachLeaf(Begin, End, Pred);
+        });
+    }
+
+    // 并行筛选出 Pred(LeafIndex, Leaf) 为 true 的叶子，按 Morton 码升序返回下标，结果与线程数无关
+    template <typename Func>
+    std::vector<std::size_t> CollectLeaves(Func&& Pred, std::size_t MaxLeafCount = 32768) const
+    {
+        std::vector<std::pair<std::size_t, std::size_t>> Ranges = Partition(MaxLeafCount);
+        std::vector<std::vector<std::size_t>> RangeResults(Ranges.size());
+        _ThreadPool->ParallelFor(0, Ranges.size(), 1, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+        {
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                for (std::size_t LeafIndex = Ranges[i].first; LeafIndex != Ranges[i].second; ++LeafIndex)
+                {
+                    if (Pred(LeafIndex, static_cast<const FLeafType&>(_Leaves[LeafIndex])))
+                    {
+                        RangeResults[i].emplace_back(LeafIndex);
+                    }
+                }
+            }
+        });
+
+        std::vector<std::size_t> LeafIndices;
+        for (const auto& Result : RangeResults)
+        {
+            LeafIndices.insert(LeafIndices.end(), Result.begin(), Result.end());
+        }
+
+        return LeafIndices;
+    }
+
+    // 按距离升序返回离 Point 最近的 Count 个链接，只考虑有效、存有点并且有链接的叶子
+    // 节点按到 Point 的最小平方距离出入优先队列（best-first），距离超过当前第 Count 近的候选的节点不再入队
+    // 要求每个点都位于所在叶子的范围内。只读，可以在多个线程中并发调用
+    std::vector<LinkTarget*> KNearest(const glm::vec3& Point, std::size_t Count) const
+    {
+        struct FQueueEntry
+        {
+            float       SquaredDistance;
+            int         Level;           // kPointLevel 表示叶子中的点，SquaredDistance 为精确距离
+            std::size_t Index;
+        };
+
+        constexpr int kPointLevel = -1;
+
+        auto Greater = [](const FQueueEntry& Lhs, const FQueueEntry& Rhs) -> bool
+        {
+            return Lhs.SquaredDistance > Rhs.SquaredDistance;
+        };
+
+        std::vector<LinkTarget*> Results;
+        if (Count == 0)
+        {
+            return Results;
+        }
+
+        Results.reserve(Count);
+        std::priority_queue<FQueueEntry, std::vector<FQueueEntry>, decltype(Greater)> Queue(Greater);
+        std::priority_queue<float> Candidates; // 已入队的点中最近的 Count 个距离，堆顶为剪枝的上界
+        float Bound = std::numeric_limits<float>::max();
+
+        Queue.push({ GetSquaredDistanceToNode(Point, 0, 0), 0, 0 });
+        while (!Queue.empty() && Results.size() != Count)
+        {
+            FQueueEntry Entry = Queue.top();
+            Queue.pop();
+
+            if (Entry.Level == kPointLevel)
+            {
+                Results.emplace_back(_Leaves[Entry.Index].GetLink());
+                continue;
+            }
+
+            if (Entry.SquaredDistance > Bound)
+            {
+                continue;
+            }
+
+            if (Entry.Level == _Depth)
+            {
+                const FLeafType& Leaf = _Leaves[Entry.Index];
+                if (Leaf.GetValidation() && Leaf.HasPoint() && Leaf.GetLink() != nullptr)
+                {
+                    glm::vec3 Delta = Leaf.GetPoint() - Point;
+                    float SquaredDistance = glm::dot(Delta, Delta);
+                    if (SquaredDistance <= Bound)
+                    {
+                        Queue.push({ SquaredDistance, kPointLevel, Entry.Index });
+                        Candidates.push(SquaredDistance);
+                        if (Candidates.size() > Count)
+                        {
+                            Candidates.pop();
+                        }
+
+                        if (Candidates.size() == Count)
+                        {
+                            Bound = Candidates.top();
+                        }
+                    }
+                }
+
+                continue;
+            }
+
+            for (int i = 0; i != 8; ++i)
+            {
+                std::size_t ChildIndex = GetChildIndex(Entry.Index, i);
+                float SquaredDistance = GetSquaredDistanceToNode(Point, Entry.Level + 1, ChildIndex);
+                if (SquaredDistance <= Bound)
+                {
+                    Queue.push({ SquaredDistance, Entry.Level + 1, ChildIndex });
+                }
+            }
+        }
+
+        return Results;
+    }
+
+    // 对与 Point 距离不超过 Radius 的每个有效且有链接的叶子调用 Pred(Link)，顺序不定
+    // 完全落在球内的节点直接线性扫描其连续的叶子，不再逐个判断距离。只读，可以在多个线程中并发调用
+    template <typename Func>
+    void ForEachInRadius(const glm::vec3& Point, float Radius, Func&& Pred) const
+    {
+        float SquaredRadius = Radius * Radius;
+        std::vector<std::pair<int, std::size_t>> Stack{ { 0, 0 } };
+
+        while (!Stack.empty())
+        {
+            auto [Level, NodeIndex] = Stack.back();
+            Stack.pop_back();
+
+            if (GetSquaredDistanceToNode(Point, Level, NodeIndex) > SquaredRadius)
+            {
+                continue;
+            }
+
+            bool bInside = GetMaxSquaredDistanceToNode(Point, Level, NodeIndex) <= SquaredRadius;
+            if (bInside || Level == _Depth)
+            {
+                auto [First, Last] = GetLeafRange(Level, NodeIndex);
+                for (std::size_t i = First; i != Last; ++i)
+                {
+                    const FLeafType& Leaf = _Leaves[i];
+                    if (!Leaf.GetValidation() || !Leaf.HasPoint() || Leaf.GetLink() == nullptr)
+                    {
+                        continue;
+                    }
+
+                    glm::vec3 Delta = Leaf.GetPoint() - Point;
+                    if (bInside || glm::dot(Delta, Delta) <= SquaredRadius)
+                    {
+                        Pred(Leaf.GetLink());
+                    }
+                }
+
+                continue;
+            }
+
+            for (int i = 0; i != 8; ++i)
+            {
+                Stack.emplace_back(Level + 1, GetChildIndex(NodeIndex, i));
+            }
+        }
+    }
+
+    // 把叶子按顺序划分为若干个完整子树的下标范围，每段的叶子数为不超过 MaxLeafCount 的最大的 8 的幂
+    std::vector<std::pair<std::size_t, std::size_t>> Partition(std::size_t MaxLeafCount) const
+    {
+        int Level = _Depth;
+        while (Level > 0 && (std::size_t{ 1 } << (3 * (_Depth - Level + 1))) <= MaxLeafCount)
+        {
+            --Level;
+        }
+
+        std::size_t NodeCount = std::size_t{ 1 } << (3 * Level);
+        std::vector<std::pair<std::size_t, std::size_t>> Ranges;
+        Ranges.reserve(NodeCount);
+        for (std::size_t i = 0; i != NodeCount; ++i)
+        {
+            Ranges.emplace_back(GetLeafRange(Level, i));
+        }
+
+        return Ranges;
+    }
+
+    const FLeafType& GetLeaf(std::size_t LeafIndex) const
+    {
+        return _Leaves[LeafIndex];
+    }
+
+    FLeafType& GetLeafMutable(std::size_t LeafIndex)
+    {
+        return _Leaves[LeafIndex];
+    }
+
+    std::size_t GetLeafCount() const
+    {
+        return _Leaves.size();
+    }
+
+    // 有效叶子的数量
+    std::size_t GetCapacity() const
+    {
+        return static_cast<std::size_t>(std::count_if(_Leaves.begin(), _Leaves.end(), [](const FLeafType& Leaf) -> bool
+        {
+            return Leaf.GetValidation();
+        }));
+    }
+
+    // 存放的点的数量
+    std::size_t GetSize() const
+    {
+        return static_cast<std::size_t>(std::count_if(_Leaves.begin(), _Leaves.end(), [](const FLeafType& Leaf) -> bool
+        {
+            return Leaf.HasPoint();
+        }));
+    }
+
+    const glm::vec3& GetCenter() const
+    {
+        return _Center;
+    }
+
+    float GetRadius() const
+    {
+        return _Radius;
+    }
+
+    float GetLeafRadius() const
+    {
+        return _LeafRadius;
+    }
+
+    int GetDepth() const
+    {
+        return _Depth;
+    }
+
+    static std::uint64_t EncodeMorton(std::uint32_t X, std::uint32_t Y, std::uint32_t Z)
+    {
+        return (SpreadBits(X) << 2) | (SpreadBits(Y) << 1) | SpreadBits(Z);
+    }
+
+    static void DecodeMorton(std::uint64_t Code, std::uint32_t& X, std::uint32_t& Y, std::uint32_t& Z)
+    {
+        X = CompactBits(Code >> 2);
+        Y = CompactBits(Code >> 1);
+        Z = CompactBits(Code);
+    }
+
+private:
+    // Point 到节点包围盒的最小平方距离，Point 在盒内时为 0
+    float GetSquaredDistanceToNode(const glm::vec3& Point, int Level, std::size_t NodeIndex) const
+    {
+        glm::vec3 Center = GetNodeCenter(Level, NodeIndex);
+        glm::vec3 Extent(GetNodeRadius(Level));
+        glm::vec3 Delta = Point - glm::clamp(Point, Center - Extent, Center + Extent);
+        return glm::dot(Delta, Delta);
+    }
+
+    // Point 到节点包围盒最远顶点的平方距离
+    float GetMaxSquaredDistanceToNode(const glm::vec3& Point, int Level, std::size_t NodeIndex) const
+    {
+        glm::vec3 Delta = glm::abs(Point - GetNodeCenter(Level, NodeIndex)) + glm::vec3(GetNodeRadius(Level));
+        return glm::dot(Delta, Delta);
+    }
+
+    // 把低 21 位分散到每 3 位中的最低位
+    static std::uint64_t SpreadBits(std::uint64_t Value)
+    {
+        Value &= 0x1FFFFF;
+        Value = (Value | Value << 32) & 0x001F00000000FFFF;
+        Value = (Value | Value << 16) & 0x001F0000FF0000FF;
+        Value = (Value | Value << 8)  & 0x100F00F00F00F00F;
+        Value = (Value | Value << 4)  & 0x10C30C30C30C30C3;
+        Value = (Value | Value << 2)  & 0x1249249249249249;
+        return Value;
+    }
+
+    static std::uint32_t CompactBits(std::uint64_t Value)
+    {
+        Value &= 0x1249249249249249;
+        Value = (Value ^ (Value >> 2))  & 0x10C30C30C30C30C3;
+        Value = (Value ^ (Value >> 4))  & 0x100F00F00F00F00F;
+        Value = (Value ^ (Value >> 8))  & 0x001F0000FF0000FF;
+        Value = (Value ^ (Value >> 16)) & 0x001F00000000FFFF;
+        Value = (Value ^ (Value >> 32)) & 0x1FFFFF;
+        return static_cast<std::uint32_t>(Value);
+    }
+
+private:
+    glm::vec3                     _Center;
+    float                         _Radius;
+    float                         _LeafRadius;
+    int                           _Depth;
+    std::vector<FLeafType>        _Leaves;
+    Runtime::Thread::FThreadPool* _ThreadPool;
+};
+
+_SPATIAL_END
+_SYSTEM_END
+_NPGS_END
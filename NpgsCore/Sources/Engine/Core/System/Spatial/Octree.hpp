@@ -1,9 +1,9 @@
 #pragma once
 
 #include <cmath>
+#include <cstddef>
 #include <array>
 #include <functional>
-#include <future>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -11,6 +11,7 @@
 #include <glm/glm.hpp>
 
 #include "Engine/Core/Base/Base.h"
+#include "Engine/Core/Runtime/Threads/TaskGroup.h"
 #include "Engine/Core/Runtime/Threads/ThreadPool.h"
 
 _NPGS_BEGIN
@@ -49,10 +50,8 @@ public:
         glm::vec3 MinBound = _Center - glm::vec3(_Radius);
         glm::vec3 MaxBound = _Center + glm::vec3(_Radius);
 
-        glm::vec3 ClosestPoint = glm::clamp(Point, MinBound, MaxBound);
-        float Distance = glm::distance(Point, ClosestPoint);
-
-        return Distance <= Radius;
+        glm::vec3 Delta = Point - glm::clamp(Point, MinBound, MaxBound);
+        return glm::dot(Delta, Delta) <= Radius * Radius;
     }
 
     const bool GetValidation() const
@@ -242,19 +241,19 @@ private:
             return;
         }
 
-        std::vector<std::future<void>> Futures;
+        // 子节点的编号与 CalculateOctant 一致，按卦限下降的查找和删除才能找到正确的子节点
+        Runtime::Thread::FTaskGroup TaskGroup(_ThreadPool);
         float NextRadius = Node->GetRadius() * 0.5f;
         for (int i = 0; i != 8; ++i)
         {
-            glm::vec3 Offset((i & 1 ? 1 : -1) * NextRadius,
+            glm::vec3 Offset((i & 4 ? 1 : -1) * NextRadius,
                              (i & 2 ? 1 : -1) * NextRadius,
-                             (i & 4 ? 1 : -1) * NextRadius);
+                             (i & 1 ? 1 : -1) * NextRadius);
 
             Node->GetNextMutable(i) = std::make_unique<FNodeType>(Node->GetCenter() + Offset, NextRadius, Node);
             if (Depth == static_cast<int>(std::ceil(std::log2(_Root->GetRadius() / LeafRadius))))
             {
-                Futures.emplace_back(_ThreadPool->Submit(
-                    &TOctree::BuildEmptyTreeImpl, this, Node->GetNextMutable(i).get(), LeafRadius, Depth - 1));
+                TaskGroup.Run(&TOctree::BuildEmptyTreeImpl, this, Node->GetNextMutable(i).get(), LeafRadius, Depth - 1);
             }
             else
             {
@@ -262,10 +261,7 @@ private:
             }
         }
 
-        for (auto& Future : Futures)
-        {
-            Future.get();
-        }
+        TaskGroup.Wait();
     }
 
     void InsertImpl(FNodeType* Node, const glm::vec3& Point, int Depth)
@@ -336,14 +332,17 @@ private:
 
     void QueryImpl(FNodeType* Node, const glm::vec3& Point, float Radius, std::vector<glm::vec3>& Results) const
     {
-        if (Node == nullptr || Node->GetNext(0) == nullptr)
+        // 点存放在叶子中，叶子也必须检查
+        if (Node == nullptr)
         {
             return;
         }
 
+        float SquaredRadius = Radius * Radius;
         for (const auto& StoredPoint : Node->GetPoints())
         {
-            if (glm::distance(StoredPoint, Point) <= Radius && StoredPoint != Point)
+            glm::vec3 Delta = StoredPoint - Point;
+            if (glm::dot(Delta, Delta) <= SquaredRadius && StoredPoint != Point)
             {
                 Results.emplace_back(StoredPoint);
             }
@@ -362,17 +361,15 @@ private:
     template <typename Func>
     FNodeType* FindImpl(FNodeType* Node, const glm::vec3& Point, Func&& Pred) const
     {
-        if (Node == nullptr)
+        // 子节点包含在父节点中，不包含 Point 的子树可以整个跳过
+        if (Node == nullptr || !Node->Contains(Point))
         {
             return nullptr;
         }
 
-        if (Node->Contains(Point))
+        if (Pred(*Node))
         {
-            if (Pred(*Node))
-            {
-                return Node;
-            }
+            return Node;
         }
 
         for (int i = 0; i != 8; ++i)
@@ -0,0 +1,221 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string_view>
+
+#include "Engine/Utils/Logger.h"
+
+_NPGS_BEGIN
+_UTIL_BEGIN
+
+namespace
+{
+    void AppendJsonString(std::string& Output, std::string_view String)
+    {
+        Output += '"';
+        for (char Char : String)
+        {
+            if (Char == '"' || Char == '\\')
+            {
+                Output += '\\';
+            }
+
+            Output += Char;
+        }
+
+        Output += '"';
+    }
+}
+
+// FProfiler implementations
+// -------------------------
+FProfiler::FProfiler()
+    : _bEnabled(false), _StartTime(std::chrono::steady_clock::now())
+{
+}
+
+void FProfiler::Reset()
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+    for (auto& Buffer : _ThreadBuffers)
+    {
+        Buffer->WriteCount = 0;
+    }
+
+    _StartTime = std::chrono::steady_clock::now();
+}
+
+void FProfiler::Record(const char* Name, std::uint64_t BeginTime, std::uint64_t EndTime)
+{
+    FThreadBuffer& Buffer = GetThreadBuffer();
+    Buffer.Records[Buffer.WriteCount % _kThreadBufferCapacity] = { Name, BeginTime, EndTime, Buffer.ThreadIndex };
+    ++Buffer.WriteCount;
+}
+
+std::vector<FProfiler::FZoneRecord> FProfiler::CollectRecords() const
+{
+    std::vector<FZoneRecord> Records;
+
+    std::lock_guard<std::mutex> Lock(_Mutex);
+    for (const auto& Buffer : _ThreadBuffers)
+    {
+        std::size_t Count = static_cast<std::size_t>(std::min<std::uint64_t>(Buffer->WriteCount, _kThreadBufferCapacity));
+        Records.insert(Records.end(), Buffer->Records.begin(), Buffer->Records.begin() + Count);
+    }
+
+    std::sort(Records.begin(), Records.end(), [](const FZoneRecord& Lhs, const FZoneRecord& Rhs) -> bool
+    {
+        return Lhs.BeginTime < Rhs.BeginTime;
+    });
+
+    return Records;
+}
+
+std::string FProfiler::FormatSummary() const
+{
+    struct FZoneSummary
+    {
+        std::size_t                            CallCount{ 0 };
+        std::uint64_t                          TotalTime{ 0 };
+        std::uint64_t                          MaxTime{ 0 };
+        std::uint64_t                          FirstBeginTime{ UINT64_MAX };
+        std::uint64_t                          LastEndTime{ 0 };
+        std::map<std::uint32_t, std::uint64_t> ThreadTimes; // 每个线程的累计耗时
+    };
+
+    std::vector<FZoneRecord> Records = CollectRecords();
+
+    std::uint64_t DroppedCount = 0;
+    {
+        std::lock_guard<std::mutex> Lock(_Mutex);
+        for (const auto& Buffer : _ThreadBuffers)
+        {
+            DroppedCount += Buffer->WriteCount - std::min<std::uint64_t>(Buffer->WriteCount, _kThreadBufferCapacity);
+        }
+    }
+
+    // 按第一次出现的顺序输出，大致就是各阶段的执行顺序
+    std::vector<std::string_view> ZoneOrder;
+    std::map<std::string_view, FZoneSummary> Summaries;
+    for (const auto& Record : Records)
+    {
+        auto [it, bInserted] = Summaries.try_emplace(Record.Name);
+        if (bInserted)
+        {
+            ZoneOrder.emplace_back(Record.Name);
+        }
+
+        FZoneSummary& Summary = it->second;
+        std::uint64_t Duration = Record.EndTime - Record.BeginTime;
+        ++Summary.CallCount;
+        Summary.TotalTime += Duration;
+        Summary.MaxTime = std::max(Summary.MaxTime, Duration);
+        Summary.FirstBeginTime = std::min(Summary.FirstBeginTime, Record.BeginTime);
+        Summary.LastEndTime = std::max(Summary.LastEndTime, Record.EndTime);
+        Summary.ThreadTimes[Record.ThreadIndex] += Duration;
+    }
+
+    auto ToMilliseconds = [](std::uint64_t Nanoseconds) -> double
+    {
+        return static_cast<double>(Nanoseconds) * 1e-6;
+    };
+
+    std::string Output = std::format("{:<36}{:>10}{:>12}{:>12}{:>12}{:>12}{:>9}{:>9}\n",
+                                     "Zone", "Calls", "Span ms", "Total ms", "Mean ms", "Max ms", "Threads", "Balance");
+
+    for (std::string_view Name : ZoneOrder)
+    {
+        const FZoneSummary& Summary = Summaries[Name];
+
+        // 各线程耗时的最大值与平均值之比，1.0 为完全均衡
+        std::uint64_t MaxThreadTime = 0;
+        for (const auto& [ThreadIndex, Time] : Summary.ThreadTimes)
+        {
+            MaxThreadTime = std::max(MaxThreadTime, Time);
+        }
+
+        double MeanThreadTime = static_cast<double>(Summary.TotalTime) / static_cast<double>(Summary.ThreadTimes.size());
+        double Balance = MeanThreadTime > 0.0 ? static_cast<double>(MaxThreadTime) / MeanThreadTime : 1.0;
+
+        std::format_to(std::back_inserter(Output), "{:<36}{:>10}{:>12.3f}{:>12.3f}{:>12.3f}{:>12.3f}{:>9}{:>9.2f}\n",
+                       Name, Summary.CallCount, ToMilliseconds(Summary.LastEndTime - Summary.FirstBeginTime),
+                       ToMilliseconds(Summary.TotalTime), ToMilliseconds(Summary.TotalTime) / Summary.CallCount,
+                       ToMilliseconds(Summary.MaxTime), Summary.ThreadTimes.size(), Balance);
+    }
+
+    if (DroppedCount != 0)
+    {
+        std::format_to(std::back_inserter(Output), "{} oldest records were overwritten, summary is incomplete.\n", DroppedCount);
+    }
+
+    return Output;
+}
+
+void FProfiler::ExportChromeTrace(const std::string& Filename) const
+{
+    std::ofstream TraceFile(Filename);
+    if (!TraceFile.is_open())
+    {
+        NpgsCoreError("Failed to open trace file \"{}\".", Filename);
+        return;
+    }
+
+    std::string Output = "{\"traceEvents\":[\n";
+    bool bFirst = true;
+    for (const auto& Record : CollectRecords())
+    {
+        if (!bFirst)
+        {
+            Output += ",\n";
+        }
+
+        bFirst = false;
+
+        // 时间单位为微秒
+        Output += "{\"name\":";
+        AppendJsonString(Output, Record.Name);
+        std::format_to(std::back_inserter(Output), ",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                       Record.ThreadIndex, static_cast<double>(Record.BeginTime) * 1e-3,
+                       static_cast<double>(Record.EndTime - Record.BeginTime) * 1e-3);
+    }
+
+    Output += "\n],\"displayTimeUnit\":\"ms\"}\n";
+    TraceFile << Output;
+}
+
+FProfiler* FProfiler::GetInstance()
+{
+    static FProfiler Instance;
+    return &Instance;
+}
+
+FProfiler::FThreadBuffer*& FProfiler::GetCurrentThreadBuffer()
+{
+    // 当前线程在分析器中的缓冲区，第一次记录时注册
+    thread_local FThreadBuffer* tThreadBuffer = nullptr;
+    return tThreadBuffer;
+}
+
+FProfiler::FThreadBuffer& FProfiler::GetThreadBuffer()
+{
+    FThreadBuffer*& CurrentBuffer = GetCurrentThreadBuffer();
+    if (CurrentBuffer == nullptr)
+    {
+        auto Buffer = std::make_unique<FThreadBuffer>();
+        Buffer->Records.resize(_kThreadBufferCapacity);
+
+        std::lock_guard<std::mutex> Lock(_Mutex);
+        Buffer->ThreadIndex = static_cast<std::uint32_t>(_ThreadBuffers.size());
+        CurrentBuffer = Buffer.get();
+        _ThreadBuffers.emplace_back(std::move(Buffer));
+    }
+
+    return *CurrentBuffer;
+}
+
+_UTIL_END
+_NPGS_END
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Engine/Core/Base/Base.h"
+
+_NPGS_BEGIN
+_UTIL_BEGIN
+
+// 轻量的分段计时器，每个线程把计时区间写入自己的环形缓冲区，写满后覆盖最旧的记录
+// 记录时不加锁，汇总、导出和 Reset 不能与记录并发调用，应在生成结束、线程池空闲时调用
+class FProfiler
+{
+public:
+    struct FZoneRecord
+    {
+        const char*   Name;        // 必须是静态存储期的字符串
+        std::uint64_t BeginTime;   // 纳秒，从 Reset 开始计
+        std::uint64_t EndTime;
+        std::uint32_t ThreadIndex; // 线程第一次记录时分配的序号
+    };
+
+public:
+    void SetEnable(bool bEnable);
+    bool IsEnabled() const;
+
+    // 清空所有记录并重新开始计时
+    void Reset();
+    void Record(const char* Name, std::uint64_t BeginTime, std::uint64_t EndTime);
+    std::uint64_t GetTimestamp() const;
+
+    // 按开始时间排序的全部记录
+    std::vector<FZoneRecord> CollectRecords() const;
+    // 每个分段的调用次数、总耗时、平均和最大耗时，以及各线程耗时的最大值与平均值之比（负载均衡）
+    std::string FormatSummary() const;
+    // 导出为 Chrome trace event 格式，可以在 chrome://tracing 或 Perfetto 中打开
+    void ExportChromeTrace(const std::string& Filename) const;
+
+    static FProfiler* GetInstance();
+
+private:
+    struct FThreadBuffer
+    {
+        std::vector<FZoneRecord> Records;
+        std::uint64_t            WriteCount{ 0 }; // 写入过的记录总数，超过容量的部分已被覆盖
+        std::uint32_t            ThreadIndex{ 0 };
+    };
+
+private:
+    explicit FProfiler();
+    FProfiler(const FProfiler&) = delete;
+    FProfiler(FProfiler&&)      = delete;
+    ~FProfiler()                = default;
+
+    FProfiler& operator=(const FProfiler&) = delete;
+    FProfiler& operator=(FProfiler&&)      = delete;
+
+    FThreadBuffer& GetThreadBuffer();
+    static FThreadBuffer*& GetCurrentThreadBuffer();
+
+private:
+    std::atomic<bool>                           _bEnabled;
+    std::chrono::steady_clock::time_point       _StartTime;
+    std::vector<std::unique_ptr<FThreadBuffer>> _ThreadBuffers; // 线程退出后缓冲区仍然保留
+    mutable std::mutex                          _Mutex;         // 只保护 _ThreadBuffers 的注册
+
+    static constexpr std::size_t _kThreadBufferCapacity = 1 << 16;
+};
+
+// 构造时记录开始时间，析构时写入一条记录，关闭时只有一次原子读取
+class FProfileZone
+{
+public:
+    explicit FProfileZone(const char* Name);
+    FProfileZone(const FProfileZone&) = delete;
+    FProfileZone(FProfileZone&&)      = delete;
+    ~FProfileZone();
+
+    FProfileZone& operator=(const FProfileZone&) = delete;
+    FProfileZone& operator=(FProfileZone&&)      = delete;
+
+private:
+    const char*   _Name;
+    std::uint64_t _BeginTime;
+};
+
+_UTIL_END
+_NPGS_END
+
+#include "Profiler.inl"
+
+#define _NPGS_PROFILE_CONCAT_IMPL(Lhs, Rhs) Lhs##Rhs
+#define _NPGS_PROFILE_CONCAT(Lhs, Rhs) _NPGS_PROFILE_CONCAT_IMPL(Lhs, Rhs)
+
+#ifdef NPGS_ENABLE_PROFILER
+#define NpgsProfileZone(Name) ::Npgs::Util::FProfileZone _NPGS_PROFILE_CONCAT(_ProfileZone, __LINE__)(Name)
+#else
+#define NpgsProfileZone(Name) static_cast<void>(0)
+#endif // NPGS_ENABLE_PROFILER
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Profiler.h"
+
+_NPGS_BEGIN
+_UTIL_BEGIN
+
+NPGS_INLINE void FProfiler::SetEnable(bool bEnable)
+{
+    _bEnabled.store(bEnable, std::memory_order_relaxed);
+}
+
+NPGS_INLINE bool FProfiler::IsEnabled() const
+{
+    return _bEnabled.load(std::memory_order_relaxed);
+}
+
+NPGS_INLINE std::uint64_t FProfiler::GetTimestamp() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _StartTime).count();
+}
+
+NPGS_INLINE FProfileZone::FProfileZone(const char* Name)
+    : _Name(nullptr), _BeginTime(0)
+{
+    FProfiler* Profiler = FProfiler::GetInstance();
+    if (Profiler->IsEnabled())
+    {
+        _Name      = Name;
+        _BeginTime = Profiler->GetTimestamp();
+    }
+}
+
+NPGS_INLINE FProfileZone::~FProfileZone()
+{
+    if (_Name != nullptr)
+    {
+        FProfiler* Profiler = FProfiler::GetInstance();
+        Profiler->Record(_Name, _BeginTime, Profiler->GetTimestamp());
+    }
+}
+
+_UTIL_END
+_NPGS_END
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <random>
 #include "Engine/Core/Base/Base.h"
 
@@ -13,6 +15,7 @@ public:
     virtual ~TDistribution() = default;
     virtual Ty operator()(RandomEngine& Engine) = 0;
     virtual Ty Generate(RandomEngine& Engine) = 0;
+    virtual void Reset() = 0; // 清除分布内部缓存的状态，使之后的结果只取决于引擎的状态
 };
 
 template <typename Ty = int, typename RandomEngine = std::mt19937>
@@ -32,6 +35,11 @@ public:
         return operator()(Engine);
     }
 
+    void Reset() override
+    {
+        _Distribution.reset();
+    }
+
 private:
     std::uniform_int_distribution<Ty> _Distribution;
 };
@@ -53,6 +61,11 @@ public:
         return operator()(Engine);
     }
 
+    void Reset() override
+    {
+        _Distribution.reset();
+    }
+
 private:
     std::uniform_real_distribution<Ty> _Distribution;
 };
@@ -74,6 +87,11 @@ public:
         return operator()(Engine);
     }
 
+    void Reset() override
+    {
+        _Distribution.reset();
+    }
+
 private:
     std::normal_distribution<Ty> _Distribution;
 };
@@ -95,6 +113,11 @@ public:
         return operator()(Engine);
     }
 
+    void Reset() override
+    {
+        _Distribution.reset();
+    }
+
 private:
     std::lognormal_distribution<Ty> _Distribution;
 };
@@ -116,9 +139,75 @@ public:
         return operator()(Engine);
     }
 
+    void Reset() override
+    {
+        _Distribution.reset();
+    }
+
 private:
     std::bernoulli_distribution _Distribution;
 };
 
+// 基于计数器的种子序列，满足 SeedSequence 的要求，可以直接用于 std::mt19937::seed
+// 产生的种子只由 (Key, Counter, Stream) 决定，用 SplitMix64 混合，相邻计数器得到的种子互不相关
+class FCounterSeedSequence
+{
+public:
+    using result_type = std::uint32_t;
+
+    FCounterSeedSequence() = delete;
+    FCounterSeedSequence(std::uint64_t Key, std::uint64_t Counter, std::uint64_t Stream = 0)
+        : _Key(Key), _Counter(Counter), _Stream(Stream)
+    {
+    }
+
+    template <typename RandomIt>
+    void generate(RandomIt First, RandomIt Last) const
+    {
+        std::uint64_t State = Mix(Mix(_Key + Mix(_Stream)) ^ _Counter);
+        std::uint64_t Value = 0;
+        for (std::size_t i = 0; First != Last; ++First, ++i)
+        {
+            if (i % 2 == 0)
+            {
+                State += _kGoldenGamma;
+                Value  = Mix(State);
+            }
+
+            *First = static_cast<result_type>(i % 2 == 0 ? Value : Value >> 32);
+        }
+    }
+
+    std::size_t size() const
+    {
+        return 6;
+    }
+
+    template <typename OutputIt>
+    void param(OutputIt Destination) const
+    {
+        for (std::uint64_t Word : { _Key, _Counter, _Stream })
+        {
+            *Destination++ = static_cast<result_type>(Word);
+            *Destination++ = static_cast<result_type>(Word >> 32);
+        }
+    }
+
+private:
+    static constexpr std::uint64_t Mix(std::uint64_t Value)
+    {
+        Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+        return Value ^ (Value >> 31);
+    }
+
+private:
+    std::uint64_t _Key;
+    std::uint64_t _Counter;
+    std::uint64_t _Stream;
+
+    static constexpr std::uint64_t _kGoldenGamma = 0x9E3779B97F4A7C15ull;
+};
+
 _UTIL_END
 _NPGS_END
@@ -1,24 +1,65 @@
 #include "Universe.h"
 
+#include <cmath>
 #include <cstdlib>
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <format>
-#include <iomanip>
 #include <iterator>
 #include <limits>
+#include <numeric>
 #include <print>
-#include <sstream>
+#include <queue>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <unordered_set>
 #include <utility>
 
 #include "Engine/Core/Base/Base.h"
 #include "Engine/Core/Math/NumericConstants.h"
 #include "Engine/Core/System/Generators/OrbitalGenerator.h"
 #include "Engine/Utils/Logger.h"
+#include "Engine/Utils/Profiler.h"
 
 _NPGS_BEGIN
 
+// Tool functions
+// --------------
+namespace
+{
+    double GetElapsedSeconds(std::chrono::steady_clock::time_point StartTime)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+    }
+
+    // 在作用域内临时修改一个值，离开作用域（包括异常）时恢复原值
+    template <typename Ty>
+    class TScopedValue
+    {
+    public:
+        TScopedValue(Ty& Value, Ty NewValue)
+            : _Value(Value), _OldValue(std::exchange(Value, std::move(NewValue)))
+        {
+        }
+
+        TScopedValue(const TScopedValue&) = delete;
+        TScopedValue& operator=(const TScopedValue&) = delete;
+
+        ~TScopedValue()
+        {
+            _Value = std::move(_OldValue);
+        }
+
+    private:
+        Ty& _Value;
+        Ty  _OldValue;
+    };
+}
+
+// FUniverse implementations
+// -------------------------
 FUniverse::FUniverse(std::uint32_t Seed, std::size_t StarCount, std::size_t ExtraGiantCount, std::size_t ExtraMassiveStarCount,
                      std::size_t ExtraNeutronStarCount, std::size_t ExtraBlackHoleCount, std::size_t ExtraMergeStarCount,
                      float UniverseAge)
@@ -34,7 +75,12 @@ FUniverse::FUniverse(std::uint32_t Seed, std::size_t StarCount, std::size_t Extr
     _ExtraNeutronStarCount(ExtraNeutronStarCount),
     _ExtraBlackHoleCount(ExtraBlackHoleCount),
     _ExtraMergeStarCount(ExtraMergeStarCount),
-    _UniverseAge(UniverseAge)
+    _UniverseAge(UniverseAge),
+    _DensityRegionRadius(0.0f),
+    _bNumaFirstTouch(false),
+    _bCounterBasedSeeding(false),
+    _bProfiling(false),
+    _CacheCapacity(0)
 {
     std::vector<std::uint32_t> Seeds(32);
     for (int i = 0; i != 32; ++i)
@@ -55,10 +101,532 @@ void FUniverse::FillUniverse()
 {
     int MaxThread = _ThreadPool->GetMaxThreadCount();
 
-    GenerateStars(MaxThread);
-    FillStellarSystem(MaxThread);
+    Util::FProfiler* Profiler = Util::FProfiler::GetInstance();
+    if (_bProfiling)
+    {
+        Profiler->Reset();
+        Profiler->SetEnable(true);
+    }
+
+    {
+        NpgsProfileZone("FillUniverse");
+        GenerateStars(MaxThread);
+        FillStellarSystem(MaxThread);
+    }
+
+    if (_bProfiling)
+    {
+        Profiler->SetEnable(false);
+        NpgsCoreInfo("Profile summary:\n{}", Profiler->FormatSummary());
+        if (!_ProfileTraceFilename.empty())
+        {
+            Profiler->ExportChromeTrace(_ProfileTraceFilename);
+            NpgsCoreInfo("Chrome trace written to \"{}\".", _ProfileTraceFilename);
+        }
+    }
+}
+
+void FUniverse::FillUniverseStreaming(const FStellarSystemSink& Sink, std::size_t ChunkCapacity)
+{
+    using FStellarGenerator = System::Generator::FStellarGenerator;
+
+    int MaxThread = _ThreadPool->GetMaxThreadCount();
+    // 分块生成时恒星的编号就是恒星系的序号，只有计数器种子能保证结果与分块无关，结束后恢复用户的设置
+    TScopedValue<bool> CounterBasedSeeding(_bCounterBasedSeeding, true);
+
+    NpgsCoreInfo("Initializating stellar generators...");
+    std::array<std::vector<FStellarGenerator>, 7> Generators;
+    for (std::size_t i = 0; i != Generators.size(); ++i)
+    {
+        Generators[i] = CreateStellarGenerators(static_cast<EStarCategory>(i), MaxThread);
+    }
+
+    NpgsCoreInfo("Building stellar octree...");
+    GenerateSlots(0.1f, _StarCount, 0.004f);
+
+    // 按遍历顺序给每块分配恒星系序号区间
+    std::vector<std::pair<std::size_t, std::size_t>> Chunks;
+    std::vector<std::size_t> ChunkOffsets;
+    if (_SlotGenerator != nullptr)
+    {
+        // 各叶子的格子数在建树时已经确定
+        Chunks = _SlotGenerator->Partition(ChunkCapacity);
+        ChunkOffsets.resize(Chunks.size() + 1);
+        for (std::size_t i = 0; i != Chunks.size(); ++i)
+        {
+            ChunkOffsets[i] = _SlotGenerator->GetSlotOffset(Chunks[i].first);
+        }
+
+        ChunkOffsets.back() = _SlotGenerator->GetSlotCount();
+    }
+    else
+    {
+        Chunks = _Octree->Partition(ChunkCapacity);
+        ChunkOffsets.resize(Chunks.size() + 1);
+        _ThreadPool->ParallelFor(0, Chunks.size(), 1, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+        {
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                std::size_t PointCount = 0;
+                _Octree->ForEachLeaf(Chunks[i].first, Chunks[i].second, [&PointCount](std::size_t, FLeafType& Leaf) -> void
+                {
+                    if (Leaf.GetValidation() && Leaf.HasPoint())
+                    {
+                        ++PointCount;
+                    }
+                });
+
+                ChunkOffsets[i + 1] = PointCount;
+            }
+        });
+
+        std::partial_sum(ChunkOffsets.begin(), ChunkOffsets.end(), ChunkOffsets.begin());
+    }
+
+    std::size_t SystemCount = ChunkOffsets.back();
+
+    BuildSlotCatalog(SystemCount);
+
+    NpgsCoreInfo("Generating {} stellar systems in {} chunks...", SystemCount, Chunks.size());
+    auto& CommonGenerators    = Generators[std::to_underlying(EStarCategory::kCommon)];
+    auto& CompanionGenerators = Generators[std::to_underlying(EStarCategory::kBinarySecondStar)];
+
+    std::vector<glm::vec3> Points;
+    std::vector<FStellarGenerator::FBasicProperties> BasicProperties;
+    std::vector<std::size_t> BinaryIndices;
+    std::vector<Astro::FStellarSystem> StellarSystems;
+
+    for (std::size_t c = 0; c != Chunks.size(); ++c)
+    {
+        std::size_t FirstIndex = ChunkOffsets[c];
+
+        CollectChunkSlots(Chunks[c], Points);
+        if (Points.empty())
+        {
+            continue;
+        }
+
+        // 每颗恒星以所在恒星系的序号作为计数器，由哪个生成器处理都得到相同的结果
+        BasicProperties.resize(Points.size());
+        _ThreadPool->ParallelFor(0, Points.size(), 256, [&](std::size_t Begin, std::size_t End, std::size_t Slot) -> void
+        {
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                auto& SelectedGenerator = Generators[std::to_underlying(GetStarCategory(FirstIndex + i))][Slot];
+                SelectedGenerator.SetStarSeedCounter(FirstIndex + i);
+                BasicProperties[i] = SelectedGenerator.GenerateBasicProperties();
+            }
+        });
+
+        std::vector<Astro::AStar> Stars = InterpolateStars(CommonGenerators, BasicProperties);
+
+        BinaryIndices.clear();
+        for (std::size_t i = 0; i != Stars.size(); ++i)
+        {
+            if (!Stars[i].GetIsSingleStar())
+            {
+                BinaryIndices.emplace_back(i);
+            }
+        }
+
+        BasicProperties.resize(BinaryIndices.size());
+        _ThreadPool->ParallelFor(0, BinaryIndices.size(), 256, [&](std::size_t Begin, std::size_t End, std::size_t Slot) -> void
+        {
+            auto& SelectedGenerator = CompanionGenerators[Slot];
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                SelectedGenerator.SetStarSeedCounter(FirstIndex + BinaryIndices[i]);
+                BasicProperties[i] = GenerateCompanionProperties(SelectedGenerator, Stars[BinaryIndices[i]]);
+            }
+        });
+
+        std::vector<Astro::AStar> Companions = InterpolateStars(CompanionGenerators, BasicProperties);
+
+        StellarSystems.resize(Points.size());
+        _ThreadPool->ParallelFor(0, Points.size(), 256, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+        {
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                Astro::FStellarSystem& System = StellarSystems[i];
+                System = Astro::FStellarSystem(Astro::FBaryCenter(Points[i], glm::vec2(0.0f), 0, ""));
+                System.StarsData().emplace_back(std::make_unique<Astro::AStar>(std::move(Stars[i])));
+                System.SetBaryNormal(System.StarsData().front()->GetNormal());
+            }
+        });
+
+        for (std::size_t i = 0; i != BinaryIndices.size(); ++i)
+        {
+            StellarSystems[BinaryIndices[i]].StarsData().emplace_back(std::make_unique<Astro::AStar>(std::move(Companions[i])));
+        }
+
+        _ThreadPool->ParallelFor(0, StellarSystems.size(), 256, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+        {
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                FinishCatalogStellarSystem(StellarSystems[i], FirstIndex + i);
+            }
+        });
+
+        Sink(FirstIndex, std::span<Astro::FStellarSystem>(StellarSystems));
+        StellarSystems.clear();
+    }
 
-    _ThreadPool->Terminate();
+    NpgsCoreInfo("Stellar generation completed.");
+}
+
+void FUniverse::FillUniverseLazy(std::size_t CacheCapacity)
+{
+    std::lock_guard Lock(_LazyMutex);
+
+    if (_DensityModel != nullptr)
+    {
+        throw std::logic_error("Lazy generation does not support stellar density models.");
+    }
+
+    // 生成器创建后自带计数器种子的密钥，之后的查询不再读取这个设置，结束后恢复用户的设置
+    TScopedValue<bool> CounterBasedSeeding(_bCounterBasedSeeding, true);
+    _CacheCapacity = std::max<std::size_t>(CacheCapacity, 1);
+    _LruList.clear();
+    _LruIndices.clear();
+
+    NpgsCoreInfo("Initializating stellar generators...");
+    _LazyStellarGenerators.clear();
+    for (int i = 0; i != std::to_underlying(EStarCategory::kBinarySecondStar) + 1; ++i)
+    {
+        _LazyStellarGenerators.emplace_back(std::move(CreateStellarGenerators(static_cast<EStarCategory>(i), 1).front()));
+    }
+
+    std::uint64_t Key = GenerateCounterSeedKey();
+    std::seed_seq SeedSequence{ static_cast<std::uint32_t>(Key), static_cast<std::uint32_t>(Key >> 32) };
+    _LazyOrbitalGenerator = std::make_unique<System::Generator::FOrbitalGenerator>(SeedSequence, _UniverseAge);
+    _LazyOrbitalGenerator->SetCounterSeedKey(Key);
+
+    NpgsCoreInfo("Building stellar octree...");
+    GenerateSlots(0.1f, _StarCount, 0.004f);
+
+    // 只记下每个叶子中恒星系的编号，恒星系本身在查询时生成
+    std::size_t SystemCount = 0;
+    _LeafSystemIndices.clear();
+    _Octree->ForEachLeaf([&](std::size_t LeafIndex, FLeafType& Leaf) -> void
+    {
+        if (Leaf.GetValidation() && Leaf.HasPoint())
+        {
+            _LeafSystemIndices.emplace(LeafIndex, SystemCount);
+            ++SystemCount;
+        }
+    });
+
+    BuildSlotCatalog(SystemCount);
+    NpgsCoreInfo("Lazy universe initialized with {} stellar system slots.", SystemCount);
+}
+
+std::shared_ptr<Astro::FStellarSystem> FUniverse::QueryStellarSystem(const glm::vec3& Position)
+{
+    std::lock_guard Lock(_LazyMutex);
+
+    if (_Octree == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::size_t LeafIndex = _Octree->FindLeaf(Position);
+    auto LeafIt = _LeafSystemIndices.find(LeafIndex);
+    if (LeafIt == _LeafSystemIndices.end())
+    {
+        return nullptr;
+    }
+
+    std::size_t SystemIndex = LeafIt->second;
+    auto CacheIt = _LruIndices.find(SystemIndex);
+    if (CacheIt != _LruIndices.end())
+    {
+        _LruList.splice(_LruList.begin(), _LruList, CacheIt->second);
+        return CacheIt->second->second;
+    }
+
+    auto System = MaterializeStellarSystem(SystemIndex, _Octree->GetLeaf(LeafIndex).GetPoint());
+    _LruList.emplace_front(SystemIndex, System);
+    _LruIndices.emplace(SystemIndex, _LruList.begin());
+
+    if (_LruList.size() > _CacheCapacity)
+    {
+        _LruIndices.erase(_LruList.back().first);
+        _LruList.pop_back();
+    }
+
+    return System;
+}
+
+Astro::FStellarSystem* FUniverse::FindStellarSystem(const glm::vec3& Position) const
+{
+    if (_Octree != nullptr)
+    {
+        return _Octree->FindLink(Position);
+    }
+
+    if (!HasSlotIndex())
+    {
+        return nullptr;
+    }
+
+    // 密度模型的一个叶子中有多个恒星系，取其中离 Position 最近的
+    std::size_t LeafIndex = _SlotGenerator->FindLeaf(Position);
+    if (LeafIndex == System::Generator::FSlotGenerator::kInvalidIndex)
+    {
+        return nullptr;
+    }
+
+    const Astro::FStellarSystem* Nearest = nullptr;
+    float MinSquaredDistance = std::numeric_limits<float>::max();
+    for (std::size_t i = _SlotGenerator->GetSlotOffset(LeafIndex); i != _SlotGenerator->GetSlotOffset(LeafIndex + 1); ++i)
+    {
+        glm::vec3 Delta = _StellarSystems[i].GetBaryPosition() - Position;
+        float SquaredDistance = glm::dot(Delta, Delta);
+        if (SquaredDistance < MinSquaredDistance)
+        {
+            MinSquaredDistance = SquaredDistance;
+            Nearest = &_StellarSystems[i];
+        }
+    }
+
+    return const_cast<Astro::FStellarSystem*>(Nearest);
+}
+
+std::vector<Astro::FStellarSystem*> FUniverse::FindNearestStellarSystems(const glm::vec3& Position, std::size_t Count) const
+{
+    if (_Octree != nullptr)
+    {
+        return _Octree->KNearest(Position, Count);
+    }
+
+    Count = std::min(Count, _StellarSystems.size());
+    if (!HasSlotIndex() || Count == 0)
+    {
+        return {};
+    }
+
+    // 从平均包含 Count 个恒星系的半径开始逐次加倍，球内的恒星系不少于 Count 个时最近的 Count 个都在球内
+    // 半径达到 Position 到区域最远角的距离时包含全部恒星系，循环一定结束
+    float MaxRadius = glm::length(glm::abs(Position) + glm::vec3(_DensityRegionRadius));
+    float Radius    = _DensityRegionRadius * std::cbrt(static_cast<float>(Count) / static_cast<float>(_StellarSystems.size()));
+    Radius = Radius > 0.0f ? std::min(Radius, MaxRadius) : MaxRadius;
+
+    std::vector<std::pair<float, Astro::FStellarSystem*>> Candidates = CollectSlotSystems(Position, Radius);
+    while (Candidates.size() < Count && Radius < MaxRadius)
+    {
+        Radius     = std::min(2.0f * Radius, MaxRadius);
+        Candidates = CollectSlotSystems(Position, Radius);
+    }
+
+    Count = std::min(Count, Candidates.size());
+    std::partial_sort(Candidates.begin(), Candidates.begin() + Count, Candidates.end(),
+                      [](const std::pair<float, Astro::FStellarSystem*>& Lhs, const std::pair<float, Astro::FStellarSystem*>& Rhs) -> bool
+    {
+        return Lhs.first < Rhs.first;
+    });
+
+    std::vector<Astro::FStellarSystem*> Nearest(Count);
+    for (std::size_t i = 0; i != Count; ++i)
+    {
+        Nearest[i] = Candidates[i].second;
+    }
+
+    return Nearest;
+}
+
+void FUniverse::ForEachStellarSystemInRadius(const glm::vec3& Position, float Radius,
+                                             const std::function<void(Astro::FStellarSystem*)>& Pred) const
+{
+    if (_Octree != nullptr)
+    {
+        _Octree->ForEachInRadius(Position, Radius, Pred);
+        return;
+    }
+
+    if (HasSlotIndex())
+    {
+        for (const auto& [SquaredDistance, System] : CollectSlotSystems(Position, Radius))
+        {
+            Pred(System);
+        }
+    }
+}
+
+void FUniverse::BenchmarkNeighbourQueries(std::size_t QueryCount, std::size_t NeighbourCount)
+{
+    if ((_Octree == nullptr && !HasSlotIndex()) || _StellarSystems.empty())
+    {
+        NpgsCoreWarn("Neighbour query benchmark needs a filled universe.");
+        return;
+    }
+
+    // 查询点均匀分布在生成区域内，使用单独的随机数引擎，不影响宇宙的生成
+    std::mt19937 QueryEngine(0);
+    float QueryRange = _Octree != nullptr ? _Octree->GetRadius() : _DensityRegionRadius;
+    Util::TUniformRealDistribution<float> QueryCoord(-QueryRange, QueryRange);
+    std::vector<glm::vec3> Queries(QueryCount);
+    for (auto& Query : Queries)
+    {
+        Query = glm::vec3(QueryCoord(QueryEngine), QueryCoord(QueryEngine), QueryCoord(QueryEngine));
+    }
+
+    // 搜索半径为平均每个恒星系所占格子半边长的 4 倍，密度模型按整个区域的平均值计算
+    float CellRadius = _Octree != nullptr ? _Octree->GetLeafRadius()
+        : _DensityRegionRadius / std::cbrt(static_cast<float>(_StellarSystems.size()));
+    float SearchRadius = 4.0f * CellRadius;
+    float SquaredSearchRadius = SearchRadius * SearchRadius;
+
+    NpgsCoreInfo("Benchmarking neighbour queries over {} stellar systems, {} queries, k = {}, radius = {}...",
+                 _StellarSystems.size(), QueryCount, NeighbourCount, SearchRadius);
+
+    // 各方法只记录距离的平方，用于校验
+    std::vector<std::vector<float>> OctreeDistances(QueryCount);
+    std::vector<std::vector<float>> BruteForceDistances(QueryCount);
+    std::vector<std::size_t> OctreeRadiusCounts(QueryCount);
+    std::vector<std::size_t> BruteForceRadiusCounts(QueryCount);
+
+    auto StartTime = std::chrono::steady_clock::now();
+    _ThreadPool->ParallelFor(0, QueryCount, 1, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+    {
+        for (std::size_t i = Begin; i != End; ++i)
+        {
+            for (const auto* System : FindNearestStellarSystems(Queries[i], NeighbourCount))
+            {
+                glm::vec3 Delta = System->GetBaryPosition() - Queries[i];
+                OctreeDistances[i].emplace_back(glm::dot(Delta, Delta));
+            }
+        }
+    });
+    double OctreeNearestSeconds = GetElapsedSeconds(StartTime);
+
+    StartTime = std::chrono::steady_clock::now();
+    _ThreadPool->ParallelFor(0, QueryCount, 1, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+    {
+        for (std::size_t i = Begin; i != End; ++i)
+        {
+            ForEachStellarSystemInRadius(Queries[i], SearchRadius, [&](const Astro::FStellarSystem*) -> void
+            {
+                ++OctreeRadiusCounts[i];
+            });
+        }
+    });
+    double OctreeRadiusSeconds = GetElapsedSeconds(StartTime);
+
+    StartTime = std::chrono::steady_clock::now();
+    _ThreadPool->ParallelFor(0, QueryCount, 1, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+    {
+        for (std::size_t i = Begin; i != End; ++i)
+        {
+            std::priority_queue<float> Nearest;
+            for (const auto& System : _StellarSystems)
+            {
+                glm::vec3 Delta = System.GetBaryPosition() - Queries[i];
+                float SquaredDistance = glm::dot(Delta, Delta);
+                if (Nearest.size() < NeighbourCount)
+                {
+                    Nearest.push(SquaredDistance);
+                }
+                else if (NeighbourCount != 0 && SquaredDistance < Nearest.top())
+                {
+                    Nearest.pop();
+                    Nearest.push(SquaredDistance);
+                }
+            }
+
+            BruteForceDistances[i].resize(Nearest.size());
+            for (auto it = BruteForceDistances[i].rbegin(); it != BruteForceDistances[i].rend(); ++it)
+            {
+                *it = Nearest.top();
+                Nearest.pop();
+            }
+        }
+    });
+    double BruteForceNearestSeconds = GetElapsedSeconds(StartTime);
+
+    StartTime = std::chrono::steady_clock::now();
+    _ThreadPool->ParallelFor(0, QueryCount, 1, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+    {
+        for (std::size_t i = Begin; i != End; ++i)
+        {
+            for (const auto& System : _StellarSystems)
+            {
+                glm::vec3 Delta = System.GetBaryPosition() - Queries[i];
+                if (glm::dot(Delta, Delta) <= SquaredSearchRadius)
+                {
+                    ++BruteForceRadiusCounts[i];
+                }
+            }
+        }
+    });
+    double BruteForceRadiusSeconds = GetElapsedSeconds(StartTime);
+
+    std::size_t NearestMismatches = 0;
+    std::size_t RadiusMismatches  = 0;
+    for (std::size_t i = 0; i != QueryCount; ++i)
+    {
+        NearestMismatches += OctreeDistances[i] != BruteForceDistances[i] ? 1 : 0;
+        RadiusMismatches  += OctreeRadiusCounts[i] != BruteForceRadiusCounts[i] ? 1 : 0;
+    }
+
+    NpgsCoreInfo("KNearest: octree {:.3f} ms, brute force {:.3f} ms, speedup {:.1f}x, mismatches {}.",
+                 OctreeNearestSeconds * 1e3, BruteForceNearestSeconds * 1e3,
+                 BruteForceNearestSeconds / std::max(OctreeNearestSeconds, 1e-9), NearestMismatches);
+    NpgsCoreInfo("ForEachInRadius: octree {:.3f} ms, brute force {:.3f} ms, speedup {:.1f}x, mismatches {}.",
+                 OctreeRadiusSeconds * 1e3, BruteForceRadiusSeconds * 1e3,
+                 BruteForceRadiusSeconds / std::max(OctreeRadiusSeconds, 1e-9), RadiusMismatches);
+}
+
+void FUniverse::BenchmarkOldPopulation(std::size_t StarCount, float MinAge)
+{
+    using FStellarGenerator = System::Generator::FStellarGenerator;
+    using EStarType         = Astro::FStellarClass::EStarType;
+
+    int   MaxThread   = _ThreadPool->GetMaxThreadCount();
+    float UniverseAge = std::max(_UniverseAge, MinAge);
+
+    std::vector<FStellarGenerator> Generators;
+    Generators.reserve(MaxThread);
+    for (int i = 0; i != MaxThread; ++i)
+    {
+        std::seed_seq SeedSequence{ static_cast<std::uint32_t>(i) };
+        Generators.emplace_back(SeedSequence, FStellarGenerator::EGenerateOption::kNormal, UniverseAge,
+                                0.1f, 300.0f, FStellarGenerator::EGenerateDistribution::kFromPdf,
+                                MinAge, UniverseAge, FStellarGenerator::EGenerateDistribution::kUniform);
+    }
+
+    NpgsCoreInfo("Benchmarking old population generation, {} stars aged {:.3g} to {:.3g} yr on {} threads...",
+                 StarCount, MinAge, UniverseAge, MaxThread);
+
+    // 超过寿命的恒星走轨迹末端分支，结果是白矮星、中子星或黑洞
+    std::array<std::size_t, 5> TypeCounts{};
+    std::mutex CountMutex;
+
+    auto StartTime = std::chrono::steady_clock::now();
+    _ThreadPool->ParallelFor(0, StarCount, 256, [&](std::size_t Begin, std::size_t End, std::size_t Slot) -> void
+    {
+        std::array<std::size_t, 5> LocalCounts{};
+        for (std::size_t i = Begin; i != End; ++i)
+        {
+            Astro::AStar Star = Generators[Slot].GenerateStar();
+            ++LocalCounts[std::to_underlying(Star.GetStellarClass().GetStarType())];
+        }
+
+        std::lock_guard Lock(CountMutex);
+        for (std::size_t i = 0; i != TypeCounts.size(); ++i)
+        {
+            TypeCounts[i] += LocalCounts[i];
+        }
+    });
+    double Seconds = std::max(GetElapsedSeconds(StartTime), 1e-9);
+
+    std::size_t EndOfTrackCount = StarCount - TypeCounts[std::to_underlying(EStarType::kNormalStar)];
+    NpgsCoreInfo("Old population: {:.3f} s, {:.0f} stars/s, {:.0f} stars/s per thread.",
+                 Seconds, StarCount / Seconds, StarCount / Seconds / MaxThread);
+    NpgsCoreInfo("End of track: {} of {} stars ({:.1f}%), white dwarfs {}, neutron stars {}, black holes {}.",
+                 EndOfTrackCount, StarCount, 100.0 * EndOfTrackCount / std::max<std::size_t>(StarCount, 1),
+                 TypeCounts[std::to_underlying(EStarType::kWhiteDwarf)],
+                 TypeCounts[std::to_underlying(EStarType::kNeutronStar)],
+                 TypeCounts[std::to_underlying(EStarType::kBlackHole)]);
 }
 
 void FUniverse::ReplaceStar(std::size_t DistanceRank, const Astro::AStar& StarData)
@@ -79,6 +647,28 @@ void FUniverse::ReplaceStar(std::size_t DistanceRank, const Astro::AStar& StarDa
     }
 }
 
+void FUniverse::SetNumaFirstTouch(bool bEnable)
+{
+    _bNumaFirstTouch = bEnable;
+}
+
+void FUniverse::SetCounterBasedSeeding(bool bEnable)
+{
+    _bCounterBasedSeeding = bEnable;
+}
+
+void FUniverse::SetProfiling(bool bEnable, const std::string& ChromeTraceFilename)
+{
+    _bProfiling           = bEnable;
+    _ProfileTraceFilename = ChromeTraceFilename;
+}
+
+void FUniverse::SetDensityModel(std::shared_ptr<const System::Generator::IStellarDensityModel> DensityModel, float RegionRadius)
+{
+    _DensityModel        = std::move(DensityModel);
+    _DensityRegionRadius = RegionRadius;
+}
+
 void FUniverse::CountStars()
 {
     constexpr int kTypeOIndex = 0;
@@ -89,21 +679,6 @@ void FUniverse::CountStars()
     constexpr int kTypeKIndex = 5;
     constexpr int kTypeMIndex = 6;
 
-    std::array<std::size_t, 7> MainSequence{};
-    std::array<std::size_t, 7> Subgiants{};
-    std::array<std::size_t, 7> Giants{};
-    std::array<std::size_t, 7> BrightGiants{};
-    std::array<std::size_t, 7> Supergiants{};
-    std::array<std::size_t, 7> Hypergiants{};
-
-    std::size_t WolfRayet    = 0;
-    std::size_t WhiteDwarfs  = 0;
-    std::size_t NeutronStars = 0;
-    std::size_t BlackHoles   = 0;
-    std::size_t TotalStars   = 1;
-    std::size_t TotalBinarys = 0;
-    std::size_t TotalSingles = 0;
-
     struct MostLuminous
     {
         double LuminositySol{};
@@ -140,6 +715,42 @@ void FUniverse::CountStars()
         const Astro::AStar* Star = nullptr;
     };
 
+    struct FCategoryRecords
+    {
+        MostLuminous   Luminous;
+        MostMassive    Massive;
+        Largest        Large;
+        Hottest        Hot;
+        Oldest         Old;
+        MostOblateness Oblate;
+    };
+
+    struct FStatistics
+    {
+        std::array<std::size_t, 7> MainSequence{};
+        std::array<std::size_t, 7> Subgiants{};
+        std::array<std::size_t, 7> Giants{};
+        std::array<std::size_t, 7> BrightGiants{};
+        std::array<std::size_t, 7> Supergiants{};
+        std::array<std::size_t, 7> Hypergiants{};
+
+        std::size_t WolfRayet    = 0;
+        std::size_t WhiteDwarfs  = 0;
+        std::size_t NeutronStars = 0;
+        std::size_t BlackHoles   = 0;
+        std::size_t TotalStars   = 0;
+        std::size_t TotalBinarys = 0;
+        std::size_t TotalSingles = 0;
+
+        FCategoryRecords MainSequenceRecords;
+        FCategoryRecords SubgiantRecords;
+        FCategoryRecords GiantRecords;
+        FCategoryRecords BrightGiantRecords;
+        FCategoryRecords SupergiantRecords;
+        FCategoryRecords HypergiantRecords;
+        FCategoryRecords WolfRayetRecords;
+    };
+
     auto FormatTitle = []() -> std::string
     {
         return std::format("{:>6} {:>6} {:>8} {:>8} {:7} {:>5} {:>13} {:>8} {:>8} {:>11} {:>8} {:>9} {:>5} {:>15} {:>9} {:>8}",
@@ -270,375 +881,333 @@ void FUniverse::CountStars()
         }
     };
 
-    MostLuminous MostLuminousMainSequence;
-    MostLuminous MostLuminousSubgiant;
-    MostLuminous MostLuminousGiant;
-    MostLuminous MostLuminousBrightGiant;
-    MostLuminous MostLuminousSupergiant;
-    MostLuminous MostLuminousHypergiant;
-    MostLuminous MostLuminousWolfRayet;
-
-    MostMassive MostMassiveMainSequence;
-    MostMassive MostMassiveSubgiant;
-    MostMassive MostMassiveGiant;
-    MostMassive MostMassiveBrightGiant;
-    MostMassive MostMassiveSupergiant;
-    MostMassive MostMassiveHypergiant;
-    MostMassive MostMassiveWolfRayet;
-
-    Largest LargestMainSequence;
-    Largest LargestSubgiant;
-    Largest LargestGiant;
-    Largest LargestBrightGiant;
-    Largest LargestSupergiant;
-    Largest LargestHypergiant;
-    Largest LargestWolfRayet;
-
-    Hottest HottestMainSequence;
-    Hottest HottestSubgiant;
-    Hottest HottestGiant;
-    Hottest HottestBrightGiant;
-    Hottest HottestSupergiant;
-    Hottest HottestHypergiant;
-    Hottest HottestWolfRayet;
-
-    Oldest OldestMainSequence;
-    Oldest OldestSubgiant;
-    Oldest OldestGiant;
-    Oldest OldestBrightGiant;
-    Oldest OldestSupergiant;
-    Oldest OldestHypergiant;
-    Oldest OldestWolfRayet;
-
-    MostOblateness MostOblatenessMainSequence;
-    MostOblateness MostOblatenessSubgiant;
-    MostOblateness MostOblatenessGiant;
-    MostOblateness MostOblatenessBrightGiant;
-    MostOblateness MostOblatenessSupergiant;
-    MostOblateness MostOblatenessHypergiant;
-    MostOblateness MostOblatenessWolfRayet;
+    auto CountRecords = [&](const std::unique_ptr<Astro::AStar>& Star, FCategoryRecords& Records) -> void
+    {
+        CountMostLuminous(Star, Records.Luminous);
+        CountMostMassive(Star, Records.Massive);
+        CountLargest(Star, Records.Large);
+        CountHottest(Star, Records.Hot);
+        CountOldest(Star, Records.Old);
+        CountMostOblateness(Star, Records.Oblate);
+    };
+
+    auto MergeRecord = []<typename RecordType, typename ValueType>(RecordType& Result, const RecordType& Partial,
+                                                                   ValueType RecordType::* Value) -> void
+    {
+        if (Result.*Value < Partial.*Value)
+        {
+            Result = Partial;
+        }
+    };
+
+    auto MergeRecords = [&](FCategoryRecords& Result, const FCategoryRecords& Partial) -> void
+    {
+        MergeRecord(Result.Luminous, Partial.Luminous, &MostLuminous::LuminositySol);
+        MergeRecord(Result.Massive,  Partial.Massive,  &MostMassive::MassSol);
+        MergeRecord(Result.Large,    Partial.Large,    &Largest::RadiusSol);
+        MergeRecord(Result.Hot,      Partial.Hot,      &Hottest::Teff);
+        MergeRecord(Result.Old,      Partial.Old,      &Oldest::Age);
+        MergeRecord(Result.Oblate,   Partial.Oblate,   &MostOblateness::Oblateness);
+    };
+
+    auto MergeCounts = [](std::array<std::size_t, 7>& Result, const std::array<std::size_t, 7>& Partial) -> void
+    {
+        for (std::size_t i = 0; i != Result.size(); ++i)
+        {
+            Result[i] += Partial[i];
+        }
+    };
 
     std::println("Star statistics results:");
     std::println("{}", FormatTitle());
     std::println("");
 
-    for (auto& System : _StellarSystems)
+    FStatistics Stats = _ThreadPool->ParallelReduce(0, _StellarSystems.size(), 1024, FStatistics{},
+    [&](std::size_t Begin, std::size_t End, FStatistics& Partial) -> void
     {
-        for (auto& Star : System.StarsData())
+        for (std::size_t i = Begin; i != End; ++i)
         {
-            ++TotalStars;
-
-            if (Star->GetIsSingleStar())
+            for (auto& Star : _StellarSystems[i].StarsData())
             {
-                ++TotalSingles;
-            }
-            else
-            {
-                ++TotalBinarys;
-            }
+                ++Partial.TotalStars;
 
-            const auto& Class = Star->GetStellarClass();
-            Astro::FStellarClass::EStarType StarType = Class.GetStarType();
-            if (StarType != Astro::FStellarClass::EStarType::kNormalStar)
-            {
-                switch (StarType)
+                if (Star->GetIsSingleStar())
+                {
+                    ++Partial.TotalSingles;
+                }
+                else
                 {
-                case Astro::FStellarClass::EStarType::kBlackHole:
-                    ++BlackHoles;
-                    break;
-                case Astro::FStellarClass::EStarType::kNeutronStar:
-                    ++NeutronStars;
-                    break;
-                case Astro::FStellarClass::EStarType::kWhiteDwarf:
-                    ++WhiteDwarfs;
-                    break;
-                default:
-                    break;
+                    ++Partial.TotalBinarys;
                 }
 
-                continue;
-            }
+                const auto& Class = Star->GetStellarClass();
+                Astro::FStellarClass::EStarType StarType = Class.GetStarType();
+                if (StarType != Astro::FStellarClass::EStarType::kNormalStar)
+                {
+                    switch (StarType)
+                    {
+                    case Astro::FStellarClass::EStarType::kBlackHole:
+                        ++Partial.BlackHoles;
+                        break;
+                    case Astro::FStellarClass::EStarType::kNeutronStar:
+                        ++Partial.NeutronStars;
+                        break;
+                    case Astro::FStellarClass::EStarType::kWhiteDwarf:
+                        ++Partial.WhiteDwarfs;
+                        break;
+                    default:
+                        break;
+                    }
+
+                    continue;
+                }
 
-            Astro::FStellarClass::FSpectralType SpectralType = Class.Data();
+                Astro::FStellarClass::FSpectralType SpectralType = Class.Data();
 
-            if (SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_Unknown)
-            {
-                if (SpectralType.HSpectralClass == Astro::FStellarClass::ESpectralClass::kSpectral_WC ||
-                    SpectralType.HSpectralClass == Astro::FStellarClass::ESpectralClass::kSpectral_WN ||
-                    SpectralType.HSpectralClass == Astro::FStellarClass::ESpectralClass::kSpectral_WO)
+                if (SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_Unknown)
                 {
-                    ++WolfRayet;
-                    CountMostLuminous(Star, MostLuminousWolfRayet);
-                    CountMostMassive(Star, MostMassiveWolfRayet);
-                    CountLargest(Star, LargestWolfRayet);
-                    CountHottest(Star, HottestWolfRayet);
-                    CountOldest(Star, OldestWolfRayet);
-                    CountMostOblateness(Star, MostOblatenessWolfRayet);
-                    continue;
+                    if (SpectralType.HSpectralClass == Astro::FStellarClass::ESpectralClass::kSpectral_WC ||
+                        SpectralType.HSpectralClass == Astro::FStellarClass::ESpectralClass::kSpectral_WN ||
+                        SpectralType.HSpectralClass == Astro::FStellarClass::ESpectralClass::kSpectral_WO)
+                    {
+                        ++Partial.WolfRayet;
+                        CountRecords(Star, Partial.WolfRayetRecords);
+                        continue;
+                    }
                 }
-            }
 
-            if (SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_0 ||
-                SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_IaPlus)
-            {
-                CountClass(SpectralType, Hypergiants);
-                CountMostLuminous(Star, MostLuminousHypergiant);
-                CountMostMassive(Star, MostMassiveHypergiant);
-                CountLargest(Star, LargestHypergiant);
-                CountHottest(Star, HottestHypergiant);
-                CountOldest(Star, OldestHypergiant);
-                CountMostOblateness(Star, MostOblatenessHypergiant);
-                continue;
-            }
+                if (SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_0 ||
+                    SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_IaPlus)
+                {
+                    CountClass(SpectralType, Partial.Hypergiants);
+                    CountRecords(Star, Partial.HypergiantRecords);
+                    continue;
+                }
 
-            if (SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_Ia ||
-                SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_Iab ||
-                SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_Ib)
-            {
-                CountClass(SpectralType, Supergiants);
-                CountMostLuminous(Star, MostLuminousSupergiant);
-                CountMostMassive(Star, MostMassiveSupergiant);
-                CountLargest(Star, LargestSupergiant);
-                CountHottest(Star, HottestSupergiant);
-                CountOldest(Star, OldestSupergiant);
-                CountMostOblateness(Star, MostOblatenessSupergiant);
-                continue;
-            }
+                if (SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_Ia ||
+                    SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_Iab ||
+                    SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_Ib)
+                {
+                    CountClass(SpectralType, Partial.Supergiants);
+                    CountRecords(Star, Partial.SupergiantRecords);
+                    continue;
+                }
 
-            if (SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_II)
-            {
-                CountClass(SpectralType, BrightGiants);
-                CountMostLuminous(Star, MostLuminousBrightGiant);
-                CountMostMassive(Star, MostMassiveBrightGiant);
-                CountLargest(Star, LargestBrightGiant);
-                CountHottest(Star, HottestBrightGiant);
-                CountOldest(Star, OldestBrightGiant);
-                CountMostOblateness(Star, MostOblatenessBrightGiant);
-                continue;
-            }
+                if (SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_II)
+                {
+                    CountClass(SpectralType, Partial.BrightGiants);
+                    CountRecords(Star, Partial.BrightGiantRecords);
+                    continue;
+                }
 
-            if (SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_III)
-            {
-                CountClass(SpectralType, Giants);
-                CountMostLuminous(Star, MostLuminousGiant);
-                CountMostMassive(Star, MostMassiveGiant);
-                CountLargest(Star, LargestGiant);
-                CountHottest(Star, HottestGiant);
-                CountOldest(Star, OldestGiant);
-                CountMostOblateness(Star, MostOblatenessGiant);
-                continue;
-            }
+                if (SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_III)
+                {
+                    CountClass(SpectralType, Partial.Giants);
+                    CountRecords(Star, Partial.GiantRecords);
+                    continue;
+                }
 
-            if (SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_IV)
-            {
-                CountClass(SpectralType, Subgiants);
-                CountMostLuminous(Star, MostLuminousSubgiant);
-                CountMostMassive(Star, MostMassiveSubgiant);
-                CountLargest(Star, LargestSubgiant);
-                CountHottest(Star, HottestSubgiant);
-                CountOldest(Star, OldestSubgiant);
-                CountMostOblateness(Star, MostOblatenessSubgiant);
-                continue;
-            }
+                if (SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_IV)
+                {
+                    CountClass(SpectralType, Partial.Subgiants);
+                    CountRecords(Star, Partial.SubgiantRecords);
+                    continue;
+                }
 
-            if (SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_V)
-            {
-                CountClass(SpectralType, MainSequence);
-                CountMostLuminous(Star, MostLuminousMainSequence);
-                CountMostMassive(Star, MostMassiveMainSequence);
-                CountLargest(Star, LargestMainSequence);
-                CountHottest(Star, HottestMainSequence);
-                CountOldest(Star, OldestMainSequence);
-                CountMostOblateness(Star, MostOblatenessMainSequence);
-                continue;
+                if (SpectralType.LuminosityClass == Astro::FStellarClass::ELuminosityClass::kLuminosity_V)
+                {
+                    CountClass(SpectralType, Partial.MainSequence);
+                    CountRecords(Star, Partial.MainSequenceRecords);
+                    continue;
+                }
             }
         }
-    }
+    },
+    [&](FStatistics& Result, const FStatistics& Partial) -> void
+    {
+        MergeCounts(Result.MainSequence, Partial.MainSequence);
+        MergeCounts(Result.Subgiants,    Partial.Subgiants);
+        MergeCounts(Result.Giants,       Partial.Giants);
+        MergeCounts(Result.BrightGiants, Partial.BrightGiants);
+        MergeCounts(Result.Supergiants,  Partial.Supergiants);
+        MergeCounts(Result.Hypergiants,  Partial.Hypergiants);
+
+        Result.WolfRayet    += Partial.WolfRayet;
+        Result.WhiteDwarfs  += Partial.WhiteDwarfs;
+        Result.NeutronStars += Partial.NeutronStars;
+        Result.BlackHoles   += Partial.BlackHoles;
+        Result.TotalStars   += Partial.TotalStars;
+        Result.TotalBinarys += Partial.TotalBinarys;
+        Result.TotalSingles += Partial.TotalSingles;
+
+        MergeRecords(Result.MainSequenceRecords, Partial.MainSequenceRecords);
+        MergeRecords(Result.SubgiantRecords,     Partial.SubgiantRecords);
+        MergeRecords(Result.GiantRecords,        Partial.GiantRecords);
+        MergeRecords(Result.BrightGiantRecords,  Partial.BrightGiantRecords);
+        MergeRecords(Result.SupergiantRecords,   Partial.SupergiantRecords);
+        MergeRecords(Result.HypergiantRecords,   Partial.HypergiantRecords);
+        MergeRecords(Result.WolfRayetRecords,    Partial.WolfRayetRecords);
+    });
 
-    std::println("Most luminous main sequence star: luminosity: {}", MostLuminousMainSequence.LuminositySol);
-    std::println("{}", FormatInfo(MostLuminousMainSequence.Star));
-    std::println("Most luminous Wolf-Rayet star: luminosity: {}", MostLuminousWolfRayet.LuminositySol);
-    std::println("{}", FormatInfo(MostLuminousWolfRayet.Star));
-    std::println("Most luminous subgiant star: luminosity: {}", MostLuminousSubgiant.LuminositySol);
-    std::println("{}", FormatInfo(MostLuminousSubgiant.Star));
-    std::println("Most luminous giant star: luminosity: {}", MostLuminousGiant.LuminositySol);
-    std::println("{}", FormatInfo(MostLuminousGiant.Star));
-    std::println("Most luminous bright giant star: luminosity: {}", MostLuminousBrightGiant.LuminositySol);
-    std::println("{}", FormatInfo(MostLuminousBrightGiant.Star));
-    std::println("Most luminous supergiant star: luminosity: {}", MostLuminousSupergiant.LuminositySol);
-    std::println("{}", FormatInfo(MostLuminousSupergiant.Star));
-    std::println("Most luminous hypergiant star: luminosity: {}", MostLuminousHypergiant.LuminositySol);
-    std::println("{}", FormatInfo(MostLuminousHypergiant.Star));
+    std::println("Most luminous main sequence star: luminosity: {}", Stats.MainSequenceRecords.Luminous.LuminositySol);
+    std::println("{}", FormatInfo(Stats.MainSequenceRecords.Luminous.Star));
+    std::println("Most luminous Wolf-Rayet star: luminosity: {}", Stats.WolfRayetRecords.Luminous.LuminositySol);
+    std::println("{}", FormatInfo(Stats.WolfRayetRecords.Luminous.Star));
+    std::println("Most luminous subgiant star: luminosity: {}", Stats.SubgiantRecords.Luminous.LuminositySol);
+    std::println("{}", FormatInfo(Stats.SubgiantRecords.Luminous.Star));
+    std::println("Most luminous giant star: luminosity: {}", Stats.GiantRecords.Luminous.LuminositySol);
+    std::println("{}", FormatInfo(Stats.GiantRecords.Luminous.Star));
+    std::println("Most luminous bright giant star: luminosity: {}", Stats.BrightGiantRecords.Luminous.LuminositySol);
+    std::println("{}", FormatInfo(Stats.BrightGiantRecords.Luminous.Star));
+    std::println("Most luminous supergiant star: luminosity: {}", Stats.SupergiantRecords.Luminous.LuminositySol);
+    std::println("{}", FormatInfo(Stats.SupergiantRecords.Luminous.Star));
+    std::println("Most luminous hypergiant star: luminosity: {}", Stats.HypergiantRecords.Luminous.LuminositySol);
+    std::println("{}", FormatInfo(Stats.HypergiantRecords.Luminous.Star));
     std::println("");
-    std::println("Most massive main sequence star: mass: {}", MostMassiveMainSequence.MassSol);
-    std::println("{}", FormatInfo(MostMassiveMainSequence.Star));
-    std::println("Most massive Wolf-Rayet star: mass: {}", MostMassiveWolfRayet.MassSol);
-    std::println("{}", FormatInfo(MostMassiveWolfRayet.Star));
-    std::println("Most massive subgiant star: mass: {}", MostMassiveSubgiant.MassSol);
-    std::println("{}", FormatInfo(MostMassiveSubgiant.Star));
-    std::println("Most massive giant star: mass: {}", MostMassiveGiant.MassSol);
-    std::println("{}", FormatInfo(MostMassiveGiant.Star));
-    std::println("Most massive bright giant star: mass: {}", MostMassiveBrightGiant.MassSol);
-    std::println("{}", FormatInfo(MostMassiveBrightGiant.Star));
-    std::println("Most massive supergiant star: mass: {}", MostMassiveSupergiant.MassSol);
-    std::println("{}", FormatInfo(MostMassiveSupergiant.Star));
-    std::println("Most massive hypergiant star: mass: {}", MostMassiveHypergiant.MassSol);
-    std::println("{}", FormatInfo(MostMassiveHypergiant.Star));
+    std::println("Most massive main sequence star: mass: {}", Stats.MainSequenceRecords.Massive.MassSol);
+    std::println("{}", FormatInfo(Stats.MainSequenceRecords.Massive.Star));
+    std::println("Most massive Wolf-Rayet star: mass: {}", Stats.WolfRayetRecords.Massive.MassSol);
+    std::println("{}", FormatInfo(Stats.WolfRayetRecords.Massive.Star));
+    std::println("Most massive subgiant star: mass: {}", Stats.SubgiantRecords.Massive.MassSol);
+    std::println("{}", FormatInfo(Stats.SubgiantRecords.Massive.Star));
+    std::println("Most massive giant star: mass: {}", Stats.GiantRecords.Massive.MassSol);
+    std::println("{}", FormatInfo(Stats.GiantRecords.Massive.Star));
+    std::println("Most massive bright giant star: mass: {}", Stats.BrightGiantRecords.Massive.MassSol);
+    std::println("{}", FormatInfo(Stats.BrightGiantRecords.Massive.Star));
+    std::println("Most massive supergiant star: mass: {}", Stats.SupergiantRecords.Massive.MassSol);
+    std::println("{}", FormatInfo(Stats.SupergiantRecords.Massive.Star));
+    std::println("Most massive hypergiant star: mass: {}", Stats.HypergiantRecords.Massive.MassSol);
+    std::println("{}", FormatInfo(Stats.HypergiantRecords.Massive.Star));
     std::println("");
-    std::println("Largest main sequence star: radius: {}", LargestMainSequence.RadiusSol);
-    std::println("{}", FormatInfo(LargestMainSequence.Star));
-    std::println("Largest Wolf-Rayet star: radius: {}", LargestWolfRayet.RadiusSol);
-    std::println("{}", FormatInfo(LargestWolfRayet.Star));
-    std::println("Largest subgiant star: radius: {}", LargestSubgiant.RadiusSol);
-    std::println("{}", FormatInfo(LargestSubgiant.Star));
-    std::println("Largest giant star: radius: {}", LargestGiant.RadiusSol);
-    std::println("{}", FormatInfo(LargestGiant.Star));
-    std::println("Largest bright giant star: radius: {}", LargestBrightGiant.RadiusSol);
-    std::println("{}", FormatInfo(LargestBrightGiant.Star));
-    std::println("Largest supergiant star: radius: {}", LargestSupergiant.RadiusSol);
-    std::println("{}", FormatInfo(LargestSupergiant.Star));
-    std::println("Largest hypergiant star: radius: {}", LargestHypergiant.RadiusSol);
-    std::println("{}", FormatInfo(LargestHypergiant.Star));
+    std::println("Largest main sequence star: radius: {}", Stats.MainSequenceRecords.Large.RadiusSol);
+    std::println("{}", FormatInfo(Stats.MainSequenceRecords.Large.Star));
+    std::println("Largest Wolf-Rayet star: radius: {}", Stats.WolfRayetRecords.Large.RadiusSol);
+    std::println("{}", FormatInfo(Stats.WolfRayetRecords.Large.Star));
+    std::println("Largest subgiant star: radius: {}", Stats.SubgiantRecords.Large.RadiusSol);
+    std::println("{}", FormatInfo(Stats.SubgiantRecords.Large.Star));
+    std::println("Largest giant star: radius: {}", Stats.GiantRecords.Large.RadiusSol);
+    std::println("{}", FormatInfo(Stats.GiantRecords.Large.Star));
+    std::println("Largest bright giant star: radius: {}", Stats.BrightGiantRecords.Large.RadiusSol);
+    std::println("{}", FormatInfo(Stats.BrightGiantRecords.Large.Star));
+    std::println("Largest supergiant star: radius: {}", Stats.SupergiantRecords.Large.RadiusSol);
+    std::println("{}", FormatInfo(Stats.SupergiantRecords.Large.Star));
+    std::println("Largest hypergiant star: radius: {}", Stats.HypergiantRecords.Large.RadiusSol);
+    std::println("{}", FormatInfo(Stats.HypergiantRecords.Large.Star));
     std::println("");
-    std::println("Hottest main sequence star: Teff: {}", HottestMainSequence.Teff);
-    std::println("{}", FormatInfo(HottestMainSequence.Star));
-    std::println("Hottest Wolf-Rayet star: Teff: {}", HottestWolfRayet.Teff);
-    std::println("{}", FormatInfo(HottestWolfRayet.Star));
-    std::println("Hottest subgiant star: Teff: {}", HottestSubgiant.Teff);
-    std::println("{}", FormatInfo(HottestSubgiant.Star));
-    std::println("Hottest giant star: Teff: {}", HottestGiant.Teff);
-    std::println("{}", FormatInfo(HottestGiant.Star));
-    std::println("Hottest bright giant star: Teff: {}", HottestBrightGiant.Teff);
-    std::println("{}", FormatInfo(HottestBrightGiant.Star));
-    std::println("Hottest supergiant star: Teff: {}", HottestSupergiant.Teff);
-    std::println("{}", FormatInfo(HottestSupergiant.Star));
-    std::println("Hottest hypergiant star: Teff: {}", HottestHypergiant.Teff);
-    std::println("{}", FormatInfo(HottestHypergiant.Star));
+    std::println("Hottest main sequence star: Teff: {}", Stats.MainSequenceRecords.Hot.Teff);
+    std::println("{}", FormatInfo(Stats.MainSequenceRecords.Hot.Star));
+    std::println("Hottest Wolf-Rayet star: Teff: {}", Stats.WolfRayetRecords.Hot.Teff);
+    std::println("{}", FormatInfo(Stats.WolfRayetRecords.Hot.Star));
+    std::println("Hottest subgiant star: Teff: {}", Stats.SubgiantRecords.Hot.Teff);
+    std::println("{}", FormatInfo(Stats.SubgiantRecords.Hot.Star));
+    std::println("Hottest giant star: Teff: {}", Stats.GiantRecords.Hot.Teff);
+    std::println("{}", FormatInfo(Stats.GiantRecords.Hot.Star));
+    std::println("Hottest bright giant star: Teff: {}", Stats.BrightGiantRecords.Hot.Teff);
+    std::println("{}", FormatInfo(Stats.BrightGiantRecords.Hot.Star));
+    std::println("Hottest supergiant star: Teff: {}", Stats.SupergiantRecords.Hot.Teff);
+    std::println("{}", FormatInfo(Stats.SupergiantRecords.Hot.Star));
+    std::println("Hottest hypergiant star: Teff: {}", Stats.HypergiantRecords.Hot.Teff);
+    std::println("{}", FormatInfo(Stats.HypergiantRecords.Hot.Star));
     std::println("");
-    std::println("Oldest main sequence star: Age: {}", OldestMainSequence.Age);
-    std::println("{}", FormatInfo(OldestMainSequence.Star));
-    std::println("Oldest Wolf-Rayet star: Age: {}", OldestWolfRayet.Age);
-    std::println("{}", FormatInfo(OldestWolfRayet.Star));
-    std::println("Oldest subgiant star: Age: {}", OldestSubgiant.Age);
-    std::println("{}", FormatInfo(OldestSubgiant.Star));
-    std::println("Oldest giant star: Age: {}", OldestGiant.Age);
-    std::println("{}", FormatInfo(OldestGiant.Star));
-    std::println("Oldest bright giant star: Age: {}", OldestBrightGiant.Age);
-    std::println("{}", FormatInfo(OldestBrightGiant.Star));
-    std::println("Oldest supergiant star: Age: {}", OldestSupergiant.Age);
-    std::println("{}", FormatInfo(OldestSupergiant.Star));
-    std::println("Oldest hypergiant star: Age: {}", OldestHypergiant.Age);
-    std::println("{}", FormatInfo(OldestHypergiant.Star));
+    std::println("Oldest main sequence star: Age: {}", Stats.MainSequenceRecords.Old.Age);
+    std::println("{}", FormatInfo(Stats.MainSequenceRecords.Old.Star));
+    std::println("Oldest Wolf-Rayet star: Age: {}", Stats.WolfRayetRecords.Old.Age);
+    std::println("{}", FormatInfo(Stats.WolfRayetRecords.Old.Star));
+    std::println("Oldest subgiant star: Age: {}", Stats.SubgiantRecords.Old.Age);
+    std::println("{}", FormatInfo(Stats.SubgiantRecords.Old.Star));
+    std::println("Oldest giant star: Age: {}", Stats.GiantRecords.Old.Age);
+    std::println("{}", FormatInfo(Stats.GiantRecords.Old.Star));
+    std::println("Oldest bright giant star: Age: {}", Stats.BrightGiantRecords.Old.Age);
+    std::println("{}", FormatInfo(Stats.BrightGiantRecords.Old.Star));
+    std::println("Oldest supergiant star: Age: {}", Stats.SupergiantRecords.Old.Age);
+    std::println("{}", FormatInfo(Stats.SupergiantRecords.Old.Star));
+    std::println("Oldest hypergiant star: Age: {}", Stats.HypergiantRecords.Old.Age);
+    std::println("{}", FormatInfo(Stats.HypergiantRecords.Old.Star));
     std::println("");
-    std::println("Most oblateness main sequence star: Oblateness: {}", MostOblatenessMainSequence.Oblateness);
-    std::println("{}", FormatInfo(MostOblatenessMainSequence.Star));
-    std::println("Most oblateness Wolf-Rayet star: Oblateness: {}", MostOblatenessWolfRayet.Oblateness);
-    std::println("{}", FormatInfo(MostOblatenessWolfRayet.Star));
-    std::println("Most oblateness subgiant star: Oblateness: {}", MostOblatenessSubgiant.Oblateness);
-    std::println("{}", FormatInfo(MostOblatenessSubgiant.Star));
-    std::println("Most oblateness giant star: Oblateness: {}", MostOblatenessGiant.Oblateness);
-    std::println("{}", FormatInfo(MostOblatenessGiant.Star));
-    std::println("Most oblateness bright giant star: Oblateness: {}", MostOblatenessBrightGiant.Oblateness);
-    std::println("{}", FormatInfo(MostOblatenessBrightGiant.Star));
-    std::println("Most oblateness supergiant star: Oblateness: {}", MostOblatenessSupergiant.Oblateness);
-    std::println("{}", FormatInfo(MostOblatenessSupergiant.Star));
-    std::println("Most oblateness hypergiant star: Oblateness: {}", MostOblatenessHypergiant.Oblateness);
-    std::println("{}", FormatInfo(MostOblatenessHypergiant.Star));
+    std::println("Most oblateness main sequence star: Oblateness: {}", Stats.MainSequenceRecords.Oblate.Oblateness);
+    std::println("{}", FormatInfo(Stats.MainSequenceRecords.Oblate.Star));
+    std::println("Most oblateness Wolf-Rayet star: Oblateness: {}", Stats.WolfRayetRecords.Oblate.Oblateness);
+    std::println("{}", FormatInfo(Stats.WolfRayetRecords.Oblate.Star));
+    std::println("Most oblateness subgiant star: Oblateness: {}", Stats.SubgiantRecords.Oblate.Oblateness);
+    std::println("{}", FormatInfo(Stats.SubgiantRecords.Oblate.Star));
+    std::println("Most oblateness giant star: Oblateness: {}", Stats.GiantRecords.Oblate.Oblateness);
+    std::println("{}", FormatInfo(Stats.GiantRecords.Oblate.Star));
+    std::println("Most oblateness bright giant star: Oblateness: {}", Stats.BrightGiantRecords.Oblate.Oblateness);
+    std::println("{}", FormatInfo(Stats.BrightGiantRecords.Oblate.Star));
+    std::println("Most oblateness supergiant star: Oblateness: {}", Stats.SupergiantRecords.Oblate.Oblateness);
+    std::println("{}", FormatInfo(Stats.SupergiantRecords.Oblate.Star));
+    std::println("Most oblateness hypergiant star: Oblateness: {}", Stats.HypergiantRecords.Oblate.Oblateness);
+    std::println("{}", FormatInfo(Stats.HypergiantRecords.Oblate.Star));
 
     std::size_t TotalMainSequence = 0;
-    for (std::size_t Count : MainSequence)
+    for (std::size_t Count : Stats.MainSequence)
     {
         TotalMainSequence += Count;
     }
 
     std::println("");
     std::println("Total main sequence: {}", TotalMainSequence);
-    std::println("Total main sequence rate: {}", TotalMainSequence / static_cast<double>(TotalStars));
-    std::println("Total O type star rate: {}", static_cast<double>(MainSequence[kTypeOIndex]) / static_cast<double>(TotalMainSequence));
-    std::println("Total B type star rate: {}", static_cast<double>(MainSequence[kTypeBIndex]) / static_cast<double>(TotalMainSequence));
-    std::println("Total A type star rate: {}", static_cast<double>(MainSequence[kTypeAIndex]) / static_cast<double>(TotalMainSequence));
-    std::println("Total F type star rate: {}", static_cast<double>(MainSequence[kTypeFIndex]) / static_cast<double>(TotalMainSequence));
-    std::println("Total G type star rate: {}", static_cast<double>(MainSequence[kTypeGIndex]) / static_cast<double>(TotalMainSequence));
-    std::println("Total K type star rate: {}", static_cast<double>(MainSequence[kTypeKIndex]) / static_cast<double>(TotalMainSequence));
-    std::println("Total M type star rate: {}", static_cast<double>(MainSequence[kTypeMIndex]) / static_cast<double>(TotalMainSequence));
-    std::println("Total Wolf-Rayet / O main star rate: {}", static_cast<double>(WolfRayet) / static_cast<double>(MainSequence[kTypeOIndex]));
+    std::println("Total main sequence rate: {}", TotalMainSequence / static_cast<double>(Stats.TotalStars));
+    std::println("Total O type star rate: {}", static_cast<double>(Stats.MainSequence[kTypeOIndex]) / static_cast<double>(TotalMainSequence));
+    std::println("Total B type star rate: {}", static_cast<double>(Stats.MainSequence[kTypeBIndex]) / static_cast<double>(TotalMainSequence));
+    std::println("Total A type star rate: {}", static_cast<double>(Stats.MainSequence[kTypeAIndex]) / static_cast<double>(TotalMainSequence));
+    std::println("Total F type star rate: {}", static_cast<double>(Stats.MainSequence[kTypeFIndex]) / static_cast<double>(TotalMainSequence));
+    std::println("Total G type star rate: {}", static_cast<double>(Stats.MainSequence[kTypeGIndex]) / static_cast<double>(TotalMainSequence));
+    std::println("Total K type star rate: {}", static_cast<double>(Stats.MainSequence[kTypeKIndex]) / static_cast<double>(TotalMainSequence));
+    std::println("Total M type star rate: {}", static_cast<double>(Stats.MainSequence[kTypeMIndex]) / static_cast<double>(TotalMainSequence));
+    std::println("Total Wolf-Rayet / O main star rate: {}", static_cast<double>(Stats.WolfRayet) / static_cast<double>(Stats.MainSequence[kTypeOIndex]));
 
     std::println("O type main sequence: {}\nB type main sequence: {}\nA type main sequence: {}\nF type main sequence: {}\nG type main sequence: {}\nK type main sequence: {}\nM type main sequence: {}",
-                 MainSequence[kTypeOIndex], MainSequence[kTypeBIndex], MainSequence[kTypeAIndex], MainSequence[kTypeFIndex], MainSequence[kTypeGIndex], MainSequence[kTypeKIndex], MainSequence[kTypeMIndex]);
+                 Stats.MainSequence[kTypeOIndex], Stats.MainSequence[kTypeBIndex], Stats.MainSequence[kTypeAIndex], Stats.MainSequence[kTypeFIndex], Stats.MainSequence[kTypeGIndex], Stats.MainSequence[kTypeKIndex], Stats.MainSequence[kTypeMIndex]);
     std::println("O type subgiants: {}\nB type subgiants: {}\nA type subgiants: {}\nF type subgiants: {}\nG type subgiants: {}\nK type subgiants: {}\nM type subgiants: {}",
-                 Subgiants[kTypeOIndex], Subgiants[kTypeBIndex], Subgiants[kTypeAIndex], Subgiants[kTypeFIndex], Subgiants[kTypeGIndex], Subgiants[kTypeKIndex], Subgiants[kTypeMIndex]);
+                 Stats.Subgiants[kTypeOIndex], Stats.Subgiants[kTypeBIndex], Stats.Subgiants[kTypeAIndex], Stats.Subgiants[kTypeFIndex], Stats.Subgiants[kTypeGIndex], Stats.Subgiants[kTypeKIndex], Stats.Subgiants[kTypeMIndex]);
     std::println("O type giants: {}\nB type giants: {}\nA type giants: {}\nF type giants: {}\nG type giants: {}\nK type giants: {}\nM type giants: {}",
-                 Giants[kTypeOIndex], Giants[kTypeBIndex], Giants[kTypeAIndex], Giants[kTypeFIndex], Giants[kTypeGIndex], Giants[kTypeKIndex], Giants[kTypeMIndex]);
+                 Stats.Giants[kTypeOIndex], Stats.Giants[kTypeBIndex], Stats.Giants[kTypeAIndex], Stats.Giants[kTypeFIndex], Stats.Giants[kTypeGIndex], Stats.Giants[kTypeKIndex], Stats.Giants[kTypeMIndex]);
     std::println("O type bright giants: {}\nB type bright giants: {}\nA type bright giants: {}\nF type bright giants: {}\nG type bright giants: {}\nK type bright giants: {}\nM type bright giants: {}",
-                 BrightGiants[kTypeOIndex], BrightGiants[kTypeBIndex], BrightGiants[kTypeAIndex], BrightGiants[kTypeAIndex], BrightGiants[kTypeFIndex], BrightGiants[kTypeGIndex], BrightGiants[kTypeMIndex]);
+                 Stats.BrightGiants[kTypeOIndex], Stats.BrightGiants[kTypeBIndex], Stats.BrightGiants[kTypeAIndex], Stats.BrightGiants[kTypeAIndex], Stats.BrightGiants[kTypeFIndex], Stats.BrightGiants[kTypeGIndex], Stats.BrightGiants[kTypeMIndex]);
     std::println("O type supergiants: {}\nB type supergiants: {}\nA type supergiants: {}\nF type supergiants: {}\nG type supergiants: {}\nK type supergiants: {}\nM type supergiants: {}",
-                 Supergiants[kTypeOIndex], Supergiants[kTypeBIndex], Supergiants[kTypeAIndex], Supergiants[kTypeFIndex], Supergiants[kTypeGIndex], Supergiants[kTypeKIndex], Supergiants[kTypeMIndex]);
+                 Stats.Supergiants[kTypeOIndex], Stats.Supergiants[kTypeBIndex], Stats.Supergiants[kTypeAIndex], Stats.Supergiants[kTypeFIndex], Stats.Supergiants[kTypeGIndex], Stats.Supergiants[kTypeKIndex], Stats.Supergiants[kTypeMIndex]);
     std::println("O type hypergiants: {}\nB type hypergiants: {}\nA type hypergiants: {}\nF type hypergiants: {}\nG type hypergiants: {}\nK type hypergiants: {}\nM type hypergiants: {}",
-                 Hypergiants[kTypeOIndex], Hypergiants[kTypeBIndex], Hypergiants[kTypeAIndex], Hypergiants[kTypeFIndex], Hypergiants[kTypeGIndex], Hypergiants[kTypeKIndex], Hypergiants[kTypeMIndex]);
-    std::println("Wolf-Rayet stars: {}", WolfRayet);
-    std::println("White dwarfs: {}\nNeutron stars: {}\nBlack holes: {}", WhiteDwarfs, NeutronStars, BlackHoles);
+                 Stats.Hypergiants[kTypeOIndex], Stats.Hypergiants[kTypeBIndex], Stats.Hypergiants[kTypeAIndex], Stats.Hypergiants[kTypeFIndex], Stats.Hypergiants[kTypeGIndex], Stats.Hypergiants[kTypeKIndex], Stats.Hypergiants[kTypeMIndex]);
+    std::println("Wolf-Rayet stars: {}", Stats.WolfRayet);
+    std::println("White dwarfs: {}\nNeutron stars: {}\nBlack holes: {}", Stats.WhiteDwarfs, Stats.NeutronStars, Stats.BlackHoles);
     std::println("");
-    std::println("Number of single stars: {}", TotalSingles);
-    std::println("Number of binary stars: {}", TotalBinarys);
+    std::println("Number of single stars: {}", Stats.TotalSingles);
+    std::println("Number of binary stars: {}", Stats.TotalBinarys);
     std::println("");
 }
 
-template <typename AstroType, typename DataType>
-void FUniverse::MakeChunks(int MaxThread, std::vector<DataType>& Data, std::vector<std::vector<DataType>>& DataLists,
-                           std::vector<std::promise<std::vector<AstroType>>>& Promises,
-                           std::vector<std::future<std::vector<AstroType>>>& ChunkFutures)
-{
-    for (std::size_t i = 0; i != Data.size(); ++i)
-    {
-        std::size_t ThreadId = i % MaxThread;
-        DataLists[ThreadId].emplace_back(std::move(Data[i]));
-    }
-
-    Promises.resize(MaxThread);
-
-    for (int i = 0; i != MaxThread; ++i)
-    {
-        ChunkFutures.emplace_back(Promises[i].get_future());
-    }
-}
-
 void FUniverse::GenerateStars(int MaxThread)
 {
+    NpgsProfileZone("GenerateStars");
     NpgsCoreInfo("Initializating and generating basic properties...");
     std::vector<System::Generator::FStellarGenerator> Generators;
     std::vector<System::Generator::FStellarGenerator::FBasicProperties> BasicProperties;
 
-    using enum System::Generator::FStellarGenerator::EGenerateDistribution;
-    using enum System::Generator::FStellarGenerator::EGenerateOption;
-    auto CreateGenerators =
-    [&, this](System::Generator::FStellarGenerator::EGenerateOption Option = kNormal,
-              float MassLowerLimit = 0.1f,  float MassUpperLimit = 300.0f,
-              System::Generator::FStellarGenerator::EGenerateDistribution MassDistribution = kFromPdf,
-              float AgeLowerLimit  = 0.0f,  float AgeUpperLimit  = 1.26e10f,
-              System::Generator::FStellarGenerator::EGenerateDistribution AgeDistribution  = kFromPdf,
-              float FeHLowerLimit  = -4.0f, float FeHUpperLimit  = 0.5f,
-              System::Generator::FStellarGenerator::EGenerateDistribution FeHDistribution  = kFromPdf) -> void
+    // 生成基础属性
+    auto GenerateBasicProperties = [&, this](std::size_t NumStars) -> void
     {
-        for (int i = 0; i != MaxThread; ++i)
+        if (_bCounterBasedSeeding)
         {
-            std::vector<std::uint32_t> Seeds(32);
-            for (int i = 0; i != 32; ++i)
+            // 第 i 颗恒星固定使用编号 i，由哪个生成器处理都得到相同的结果，可以并行生成
+            // 插值时各类恒星都由普通恒星的生成器用同一个密钥处理，编号必须取全局序号，否则各类中序号相同的恒星会得到相同的插值随机数
+            std::size_t Offset = BasicProperties.size();
+            BasicProperties.resize(Offset + NumStars);
+            _ThreadPool->ParallelFor(0, NumStars, 256, [&](std::size_t Begin, std::size_t End, std::size_t Slot) -> void
             {
-                Seeds[i] = _SeedGenerator(_RandomEngine);
-            }
+                NpgsProfileZone("GenerateBasicProperties");
+                auto& SelectedGenerator = Generators[Slot];
+                for (std::size_t i = Begin; i != End; ++i)
+                {
+                    SelectedGenerator.SetStarSeedCounter(Offset + i);
+                    BasicProperties[Offset + i] = SelectedGenerator.GenerateBasicProperties();
+                }
+            });
 
-            std::shuffle(Seeds.begin(), Seeds.end(), _RandomEngine);
-            std::seed_seq SeedSequence(Seeds.begin(), Seeds.end());
-            Generators.emplace_back(SeedSequence, Option, _UniverseAge,
-                                    MassLowerLimit, MassUpperLimit, MassDistribution,
-                                    AgeLowerLimit,  AgeUpperLimit,  AgeDistribution,
-                                    FeHLowerLimit,  FeHUpperLimit,  FeHDistribution);
+            return;
         }
-    };
 
-    // 生成基础属性
-    auto GenerateBasicProperties = [&, this](std::size_t NumStars) -> void
-    {
+        NpgsProfileZone("GenerateBasicProperties");
         for (std::size_t i = 0; i != NumStars; ++i)
         {
             std::size_t ThreadId = i % Generators.size();
@@ -649,332 +1218,567 @@ void FUniverse::GenerateStars(int MaxThread)
     // 特殊星基础参数设置
     if (_ExtraGiantCount != 0)
     {
-        Generators.clear();
-        CreateGenerators(System::Generator::FStellarGenerator::EGenerateOption::kGiant, 1.0f, 35.0f);
+        Generators = CreateStellarGenerators(EStarCategory::kGiant, MaxThread);
         GenerateBasicProperties(_ExtraGiantCount);
     }
 
     if (_ExtraMassiveStarCount != 0)
     {
-        Generators.clear();
-        CreateGenerators(System::Generator::FStellarGenerator::EGenerateOption::kNormal,
-                         20.0f, 300.0f, System::Generator::FStellarGenerator::EGenerateDistribution::kUniform,
-                         0.0f,  3.5e6f, System::Generator::FStellarGenerator::EGenerateDistribution::kUniform);
+        Generators = CreateStellarGenerators(EStarCategory::kMassiveStar, MaxThread);
         GenerateBasicProperties(_ExtraMassiveStarCount);
     }
 
     if (_ExtraNeutronStarCount != 0)
     {
-        Generators.clear();
-        CreateGenerators(System::Generator::FStellarGenerator::EGenerateOption::kDeathStar,
-                         10.0f, 20.0f, System::Generator::FStellarGenerator::EGenerateDistribution::kUniform,
-                         1e7f,  1e8f,  System::Generator::FStellarGenerator::EGenerateDistribution::kUniformByExponent);
+        Generators = CreateStellarGenerators(EStarCategory::kNeutronStar, MaxThread);
         GenerateBasicProperties(_ExtraNeutronStarCount);
     }
 
     if (_ExtraBlackHoleCount != 0)
     {
-        Generators.clear();
-        CreateGenerators(System::Generator::FStellarGenerator::EGenerateOption::kNormal,
-                         35.0f,  300.0f, System::Generator::FStellarGenerator::EGenerateDistribution::kUniform,
-                         1e7f, 1.26e10f, System::Generator::FStellarGenerator::EGenerateDistribution::kFromPdf,
-                         -2.0, 0.5);
+        Generators = CreateStellarGenerators(EStarCategory::kBlackHole, MaxThread);
         GenerateBasicProperties(_ExtraBlackHoleCount);
     }
 
     if (_ExtraMergeStarCount != 0)
     {
-        Generators.clear();
-        CreateGenerators(System::Generator::FStellarGenerator::EGenerateOption::kMergeStar,
-                         0.0f, 0.0f, System::Generator::FStellarGenerator::EGenerateDistribution::kUniform,
-                         1e6f, 1e8f, System::Generator::FStellarGenerator::EGenerateDistribution::kUniformByExponent);
+        Generators = CreateStellarGenerators(EStarCategory::kMergeStar, MaxThread);
         GenerateBasicProperties(_ExtraMergeStarCount);
     }
 
     std::size_t CommonStarsCount =
         _StarCount - _ExtraGiantCount - _ExtraMassiveStarCount - _ExtraNeutronStarCount - _ExtraBlackHoleCount - _ExtraMergeStarCount;
 
-    Generators.clear();
-    CreateGenerators(System::Generator::FStellarGenerator::EGenerateOption::kNormal, 0.075f);
+    Generators = CreateStellarGenerators(EStarCategory::kCommon, MaxThread);
     GenerateBasicProperties(CommonStarsCount);
 
-    NpgsCoreInfo("Interpolating stellar data as {} physical cores...", MaxThread);
+    // 伴星生成器必须在八叉树任务开始前创建，之后 _RandomEngine 归八叉树任务独占，直到等待结束
+    std::vector<System::Generator::FStellarGenerator> CompanionGenerators =
+        CreateStellarGenerators(EStarCategory::kBinarySecondStar, MaxThread);
+
+    // 构建八叉树是单线程的，与插值并行执行，插值占满其余的工作线程
+    NpgsCoreInfo("Building stellar octree while interpolating stellar data as {} physical cores...", MaxThread);
+    auto SlotFuture = _ThreadPool->Submit([this]() -> void
+    {
+        GenerateSlots(0.1f, _StarCount, 0.004f);
+    });
 
-    std::vector<Astro::AStar> Stars = InterpolateStars(MaxThread, Generators, BasicProperties);
+    std::vector<Astro::AStar> Stars;
+    std::vector<std::unique_ptr<Astro::AStar>> Companions;
+    try
+    {
+        Stars = InterpolateStarsWithCompanions(Generators, CompanionGenerators, BasicProperties, Companions);
+    }
+    catch (...)
+    {
+        SlotFuture.wait(); // 任务引用了 this，不能先于它返回
+        throw;
+    }
 
-    NpgsCoreInfo("Building stellar octree in 8 threads...");
-    GenerateSlots(0.1f, _StarCount, 0.004f);
+    SlotFuture.get();
 
     NpgsCoreInfo("Linking positions in octree to stellar systems...");
-    _StellarSystems.reserve(_StarCount);
-    std::shuffle(Stars.begin(), Stars.end(), _RandomEngine);
-    std::vector<glm::vec3> Slots;
-    OctreeLinkToStellarSystems(Stars, Slots);
 
-    NpgsCoreInfo("Generating binary stars...");
-    GenerateBinaryStars(MaxThread);
+    // 只打乱下标，主星和伴星一起分配到恒星系
+    std::vector<std::size_t> StarOrder(Stars.size());
+    std::iota(StarOrder.begin(), StarOrder.end(), std::size_t{ 0 });
+    std::shuffle(StarOrder.begin(), StarOrder.end(), _RandomEngine);
 
-    NpgsCoreInfo("Sorting...");
-    std::sort(Slots.begin(), Slots.end(), [](const glm::vec3& Point1, const glm::vec3& Point2)
+    OctreeLinkToStellarSystems([&](Astro::FStellarSystem& System, std::size_t SystemIndex) -> void
     {
-        return glm::length(Point1) < glm::length(Point2);
-    });
+        std::size_t StarIndex = StarOrder[SystemIndex];
+        System.StarsData().emplace_back(std::make_unique<Astro::AStar>(std::move(Stars[StarIndex])));
+        System.SetBaryNormal(System.StarsData().front()->GetNormal());
 
-    NpgsCoreInfo("Assigning name...");
-    std::string Name;
-    std::ostringstream Stream;
-    for (auto& System : _StellarSystems)
-    {
-        glm::vec3 Position = System.GetBaryPosition();
-        auto it = std::lower_bound(Slots.begin(), Slots.end(), Position,
-                                   [](const glm::vec3& Point1, const glm::vec3& Point2) -> bool
+        auto& Companion = Companions[StarIndex];
+        if (Companion != nullptr)
         {
-            return glm::length(Point1) < glm::length(Point2);
-        });
-        std::ptrdiff_t Offset = it - Slots.begin();
-        Stream << std::setfill('0') << std::setw(8) << std::to_string(Offset);
-        Name = "SYSTEM-" + Stream.str();
-        System.SetBaryName(Name).SetBaryDistanceRank(Offset);
+            // 伴星在插值时由任意线程分配，first-touch 模式下在本线程重新分配
+            System.StarsData().emplace_back(_bNumaFirstTouch
+                ? std::make_unique<Astro::AStar>(std::move(*Companion)) : std::move(Companion));
+        }
+    });
 
-        auto& Stars = System.StarsData();
-        if (Stars.size() > 1)
-        {
-            std::sort(Stars.begin(), Stars.end(),
-            [](const std::unique_ptr<Astro::AStar>& Star1, std::unique_ptr<Astro::AStar>& Star2) -> bool
-            {
-                return Star1->GetMass() > Star2->GetMass();
-            });
+    NpgsCoreInfo("Ranking stellar systems by distance...");
+    RankStellarSystems();
 
-            char Rank = 'A';
-            for (auto& Star : Stars)
-            {
-                Star->SetName("STAR-" + Stream.str() + " " + Rank);
-                ++Rank;
-            }
+    NpgsCoreInfo("Stellar generation completed.");
+}
+
+void FUniverse::FillStellarSystem(int MaxThread)
+{
+    NpgsProfileZone("FillStellarSystem");
+    NpgsCoreInfo("Naming stellar systems and generating planets...");
+
+    // 生成器的随机数都来自按恒星系编号（计数器种子）或按段的重新播种，只需从主引擎取一个密钥
+    std::vector<System::Generator::FOrbitalGenerator> Generators;
+    std::uint64_t Key = GenerateCounterSeedKey();
+    std::seed_seq SeedSequence{ static_cast<std::uint32_t>(Key), static_cast<std::uint32_t>(Key >> 32) };
+    for (int i = 0; i != MaxThread; ++i)
+    {
+        Generators.emplace_back(SeedSequence, _UniverseAge);
+        if (_bCounterBasedSeeding)
+        {
+            Generators.back().SetCounterSeedKey(Key);
         }
         else
         {
-            Stars.front()->SetName("STAR-" + Stream.str());
+            Generators.back().SetSegmentSeedKey(Key);
         }
-
-        Stream.str("");
-        Stream.clear();
     }
 
-    NpgsCoreInfo("Reset home stellar system...");
-    FNodeType* HomeNode = _Octree->Find(glm::vec3(0.0f), [](const FNodeType& Node) -> bool
+    // 双星和大质量恒星等会提前返回，各恒星系的计算量差别很大，用较小的段动态分配
+    // 每个恒星系命名后（恒星按质量排好序）立即生成行星，不等待其他恒星系
+    ParallelForGenerators(_StellarSystems.size(), 16, _bNumaFirstTouch, [&](std::size_t Begin, std::size_t End, std::size_t SegmentIndex, std::size_t Slot) -> void
     {
-        if (Node.IsLeafNode())
+        NpgsProfileZone("NameAndGenerateOrbitals");
+        auto& SelectedGenerator = Generators[Slot];
+        if (!_bCounterBasedSeeding)
         {
-            auto& Points = Node.GetPoints();
-            return std::find(Points.begin(), Points.end(), glm::vec3(0.0f)) != Points.end();
+            SelectedGenerator.ReseedSegment(SegmentIndex);
         }
-        else
+
+        for (std::size_t i = Begin; i != End; ++i)
         {
-            return false;
+            FinishStellarSystem(_StellarSystems[i], _StellarSystems[i].GetBaryDistanceRank());
+            SelectedGenerator.SetSystemSeedCounter(i);
+            SelectedGenerator.GenerateOrbitals(_StellarSystems[i]);
         }
     });
-
-    auto* HomeSystem = HomeNode->GetLink([](Astro::FStellarSystem* System) -> bool
-    {
-        return System->GetBaryPosition() == glm::vec3(0.0f);
-    });
-    HomeNode->RemoveStorage();
-    HomeNode->AddPoint(glm::vec3(0.0f));
-    HomeSystem->SetBaryNormal(glm::vec2(0.0f));
-
-    for (auto& Star : HomeSystem->StarsData())
-    {
-        Star->SetNormal(glm::vec3(0.0f));
-    }
-
-    NpgsCoreInfo("Stellar generation completed.");
 }
 
-void FUniverse::FillStellarSystem(int MaxThread)
+std::vector<Astro::AStar>
+FUniverse::InterpolateStars(std::vector<System::Generator::FStellarGenerator>& Generators,
+                            std::vector<System::Generator::FStellarGenerator::FBasicProperties>& BasicProperties)
 {
-    NpgsCoreInfo("Generating planets...");
-
-    std::vector<System::Generator::FOrbitalGenerator> Generators;
+    // 恒星的计算量差别很大（死星、白矮星走不同的分支），按段动态分配
+    std::vector<Astro::AStar> Stars(BasicProperties.size());
+    std::span<const System::Generator::FStellarGenerator::FBasicProperties> PropertySpan(BasicProperties);
+    std::span<Astro::AStar> StarSpan(Stars);
 
-    for (int i = 0; i != MaxThread; ++i)
+    ParallelForGenerators(BasicProperties.size(), 256, false, [&](std::size_t Begin, std::size_t End, std::size_t SegmentIndex, std::size_t Slot) -> void
     {
-        std::vector<std::uint32_t> Seeds(32);
-        for (int i = 0; i != 32; ++i)
+        NpgsProfileZone("InterpolateStars");
+        auto& SelectedGenerator = Generators[Slot];
+        if (!_bCounterBasedSeeding)
         {
-            Seeds[i] = _SeedGenerator(_RandomEngine);
+            SelectedGenerator.ReseedSegment(SegmentIndex);
         }
 
-        std::shuffle(Seeds.begin(), Seeds.end(), _RandomEngine);
-        std::seed_seq SeedSequence(Seeds.begin(), Seeds.end());
+        SelectedGenerator.GenerateStars(PropertySpan.subspan(Begin, End - Begin), StarSpan.subspan(Begin, End - Begin));
+    });
 
-        Generators.emplace_back(SeedSequence);
-    }
+    BasicProperties.clear();
+    return Stars;
 }
 
 std::vector<Astro::AStar>
-FUniverse::InterpolateStars(int MaxThread, std::vector<System::Generator::FStellarGenerator>& Generators,
-                            std::vector<System::Generator::FStellarGenerator::FBasicProperties>& BasicProperties)
+FUniverse::InterpolateStarsWithCompanions(std::vector<System::Generator::FStellarGenerator>& Generators,
+                                          std::vector<System::Generator::FStellarGenerator>& CompanionGenerators,
+                                          std::vector<System::Generator::FStellarGenerator::FBasicProperties>& BasicProperties,
+                                          std::vector<std::unique_ptr<Astro::AStar>>& Companions)
 {
-    std::vector<std::vector<System::Generator::FStellarGenerator::FBasicProperties>> PropertyLists(MaxThread);
-    std::vector<std::promise<std::vector<Astro::AStar>>> Promises(MaxThread);
-    std::vector<std::future<std::vector<Astro::AStar>>> ChunkFutures;
+    // 每段主星插值完成后立即在同一个参与者上生成伴星，不再单独等待全部主星
+    std::vector<Astro::AStar> Stars(BasicProperties.size());
+    std::span<const System::Generator::FStellarGenerator::FBasicProperties> PropertySpan(BasicProperties);
+    std::span<Astro::AStar> StarSpan(Stars);
+    Companions.clear();
+    Companions.resize(BasicProperties.size());
+
+    ParallelForGenerators(BasicProperties.size(), 256, false, [&](std::size_t Begin, std::size_t End, std::size_t SegmentIndex, std::size_t Slot) -> void
+    {
+        auto& SelectedGenerator  = Generators[Slot];
+        auto& CompanionGenerator = CompanionGenerators[Slot];
+        if (!_bCounterBasedSeeding)
+        {
+            SelectedGenerator.ReseedSegment(SegmentIndex);
+            CompanionGenerator.ReseedSegment(SegmentIndex);
+        }
 
-    MakeChunks(MaxThread, BasicProperties, PropertyLists, Promises, ChunkFutures);
+        {
+            NpgsProfileZone("InterpolateStars");
+            SelectedGenerator.GenerateStars(PropertySpan.subspan(Begin, End - Begin), StarSpan.subspan(Begin, End - Begin));
+        }
 
-    for (int i = 0; i != MaxThread; ++i)
-    {
-        _ThreadPool->Submit([&, i]() -> void
+        NpgsProfileZone("GenerateCompanions");
+        for (std::size_t i = Begin; i != End; ++i)
         {
-            std::vector<Astro::AStar> Stars;
-            for (auto& Properties : PropertyLists[i])
+            if (!Stars[i].GetIsSingleStar())
             {
-                Stars.emplace_back(Generators[i].GenerateStar(std::move(Properties)));
+                // 伴星的编号取主星的编号，与主星由哪个参与者插值无关
+                CompanionGenerator.SetStarSeedCounter(i);
+                auto CompanionProperties = GenerateCompanionProperties(CompanionGenerator, Stars[i]);
+                Companions[i] = std::make_unique<Astro::AStar>(CompanionGenerator.GenerateStar(std::move(CompanionProperties)));
             }
-            Promises[i].set_value(std::move(Stars));
-        });
-    }
+        }
+    });
 
     BasicProperties.clear();
+    return Stars;
+}
 
-    std::vector<Astro::AStar> Stars;
-    for (auto& Future : ChunkFutures)
+template <typename Func>
+void FUniverse::ParallelForGenerators(std::size_t Count, std::size_t Grain, bool bStatic, Func&& Pred)
+{
+    // 段由哪个参与者处理随调度变化，段的划分必须只取决于 Count 和 Grain，按段播种的结果才能复现
+    std::size_t SegmentCount = (Count + Grain - 1) / Grain;
+    if (!bStatic)
     {
-        auto Chunk = Future.get();
-        Stars.insert(Stars.end(), std::make_move_iterator(Chunk.begin()), std::make_move_iterator(Chunk.end()));
+        _ThreadPool->ParallelForChunked(0, Count, SegmentCount, std::forward<Func>(Pred));
+        return;
     }
 
-    return Stars;
+    // 段按 ParallelForStatic 的划分连续地交给各工作线程，与 first-touch 时各线程负责的恒星系基本一致
+    _ThreadPool->ParallelForStatic(0, SegmentCount, [&](std::size_t FirstSegment, std::size_t LastSegment, std::size_t WorkerIndex) -> void
+    {
+        for (std::size_t SegmentIndex = FirstSegment; SegmentIndex != LastSegment; ++SegmentIndex)
+        {
+            Pred(Count * SegmentIndex / SegmentCount, Count * (SegmentIndex + 1) / SegmentCount, SegmentIndex, WorkerIndex);
+        }
+    });
 }
 
 void FUniverse::GenerateSlots(float MinDistance, std::size_t SampleCount, float Density)
 {
+    NpgsProfileZone("GenerateSlots");
+
+    if (_DensityModel != nullptr)
+    {
+        GenerateDensitySlots(SampleCount);
+        return;
+    }
+
+    _SlotGenerator.reset();
+
     float Radius     = std::pow((3.0f * SampleCount / (4 * Math::kPi * Density)), (1.0f / 3.0f));
     float LeafSize   = std::pow((1.0f / Density), (1.0f / 3.0f));
     int   Exponent   = static_cast<int>(std::ceil(std::log2(Radius / LeafSize)));
     float LeafRadius = LeafSize * 0.5f;
     float RootRadius = LeafSize * static_cast<float>(std::pow(2, Exponent));
 
-    _Octree = std::make_unique<System::Spatial::TOctree<Astro::FStellarSystem>>(glm::vec3(0.0), RootRadius);
-    _Octree->BuildEmptyTree(LeafRadius); // 快速构建一个空树，每个叶子节点作为一个格子，用于生成恒星
+    _Octree = std::make_unique<System::Spatial::TLinearOctree<Astro::FStellarSystem>>(glm::vec3(0.0), RootRadius);
+    {
+        NpgsProfileZone("BuildEmptyTree");
+        _Octree->BuildEmptyTree(LeafRadius); // 一次分配全部叶子，每个叶子作为一个格子，用于生成恒星
+    }
 
-    // 遍历八叉树，将距离原点大于半径的叶子节点标记为无效，保证恒星只会在范围内生成
-    _Octree->Traverse([Radius](FNodeType& Node) -> void
+    // 遍历八叉树，将距离原点大于半径的叶子标记为无效，保证恒星只会在范围内生成
+    _Octree->ParallelForEachLeaf([Radius, this](std::size_t LeafIndex, FLeafType& Leaf) -> void
     {
-        if (Node.IsLeafNode() && glm::length(Node.GetCenter()) > Radius)
+        if (glm::length(_Octree->GetLeafCenter(LeafIndex)) > Radius)
         {
-            Node.SetValidation(false);
+            Leaf.SetValidation(false);
         }
     });
 
+    // 使用栅格采样，八叉树的每个叶子作为一个格子，在这个格子中生成一个恒星
+    // 只有球面附近半个叶子厚的壳层中的叶子会被收回或删除，一次收集出来打乱后按顺序处理，直到格子数量等于目标数量
     std::size_t ValidLeafCount = _Octree->GetCapacity();
-    std::vector<FNodeType*> LeafNodes;
+    if (ValidLeafCount != SampleCount)
+    {
+        bool  bRestore    = ValidLeafCount < SampleCount;
+        float InnerRadius = bRestore ? Radius : Radius - LeafRadius;
+        float OuterRadius = bRestore ? Radius + LeafRadius : Radius;
+
+        std::vector<std::size_t> ShellLeafIndices = _Octree->CollectLeaves(
+            [&, this](std::size_t LeafIndex, const FLeafType& Leaf) -> bool
+        {
+            float Distance = glm::length(_Octree->GetLeafCenter(LeafIndex));
+            return Leaf.GetValidation() != bRestore && Distance >= InnerRadius && Distance <= OuterRadius;
+        });
+
+        std::size_t AdjustCount = bRestore ? SampleCount - ValidLeafCount : ValidLeafCount - SampleCount;
+        if (ShellLeafIndices.size() < AdjustCount)
+        {
+            throw std::runtime_error("Not enough boundary leaves to match the star count.");
+        }
+
+        std::shuffle(ShellLeafIndices.begin(), ShellLeafIndices.end(), _RandomEngine); // 打乱叶子，保证随机性
+        for (std::size_t i = 0; i != AdjustCount; ++i)
+        {
+            _Octree->GetLeafMutable(ShellLeafIndices[i]).SetValidation(bRestore);
+        }
+    }
 
-    auto CollectLeafNodes = [&LeafNodes](FNodeType& Node) -> void
+    Util::TUniformRealDistribution Offset(-LeafRadius, LeafRadius - MinDistance); // 用于随机生成恒星位置相对于叶子中心点的偏移量
+    // 按 Morton 码顺序为每个有效的叶子生成一个恒星
+    _Octree->ForEachLeaf([&Offset, this](std::size_t LeafIndex, FLeafType& Leaf) -> void
     {
-        if (Node.IsLeafNode())
+        if (Leaf.GetValidation())
         {
-            LeafNodes.emplace_back(&Node);
+            glm::vec3 Center(_Octree->GetLeafCenter(LeafIndex));
+            glm::vec3 StellarSlot(Center.x + Offset(_RandomEngine),
+                                  Center.y + Offset(_RandomEngine),
+                                  Center.z + Offset(_RandomEngine));
+            Leaf.SetPoint(StellarSlot);
         }
-    };
+    });
+
+    // 为了保证恒星系统的唯一性，将原点附近所在的叶子作为存储初始恒星系统的格子
+    // 包含了 (LeafRadius, LeafRadius, LeafRadius) 的叶子存储的位置修改为原点
+    _Octree->GetLeafMutable(_Octree->FindLeaf(glm::vec3(LeafRadius))).SetPoint(glm::vec3(0.0f));
+}
+
+void FUniverse::GenerateDensitySlots(std::size_t SampleCount)
+{
+    _Octree.reset();
+
+    // 只确定每个叶子的格子数，位置在使用时按叶子区间生成
+    _SlotGenerator = std::make_unique<System::Generator::FSlotGenerator>(
+        _DensityModel, glm::vec3(0.0f), _DensityRegionRadius, GenerateCounterSeedKey());
 
-    // 使用栅格采样，八叉树的每个叶子节点作为一个格子，在这个格子中生成一个恒星
-    while (ValidLeafCount != SampleCount)
+    _SlotGenerator->SetAnchor(glm::vec3(0.0f)); // 与均匀栅格一样把原点留给初始恒星系
+    _SlotGenerator->Build(SampleCount);
+}
+
+void FUniverse::CollectChunkSlots(const std::pair<std::size_t, std::size_t>& Chunk, std::vector<glm::vec3>& Points) const
+{
+    Points.clear();
+    if (_SlotGenerator != nullptr)
+    {
+        _SlotGenerator->GenerateSlots(Chunk.first, Chunk.second, Points);
+        return;
+    }
+
+    _Octree->ForEachLeaf(Chunk.first, Chunk.second, [&Points](std::size_t, FLeafType& Leaf) -> void
     {
-        LeafNodes.clear();
-        _Octree->Traverse(CollectLeafNodes);
-        std::shuffle(LeafNodes.begin(), LeafNodes.end(), _RandomEngine); // 打乱叶子节点，保证随机性
+        if (Leaf.GetValidation() && Leaf.HasPoint())
+        {
+            Points.emplace_back(Leaf.GetPoint());
+        }
+    });
+}
+
+bool FUniverse::HasSlotIndex() const
+{
+    return _SlotGenerator != nullptr && !_StellarSystems.empty() && _StellarSystems.size() == _SlotGenerator->GetSlotCount();
+}
 
-        // 删除或收回叶子节点，直到格子数量等于目标数量
-        if (ValidLeafCount < SampleCount)
+std::vector<std::pair<float, Astro::FStellarSystem*>> FUniverse::CollectSlotSystems(const glm::vec3& Position, float Radius) const
+{
+    std::vector<std::pair<float, Astro::FStellarSystem*>> Systems;
+    for (std::size_t LeafIndex : _SlotGenerator->CollectLeavesInRadius(Position, Radius))
+    {
+        for (std::size_t i = _SlotGenerator->GetSlotOffset(LeafIndex); i != _SlotGenerator->GetSlotOffset(LeafIndex + 1); ++i)
         {
-            for (auto* Node : LeafNodes)
+            glm::vec3 Delta = _StellarSystems[i].GetBaryPosition() - Position;
+            float SquaredDistance = glm::dot(Delta, Delta);
+            if (SquaredDistance <= Radius * Radius)
             {
-                glm::vec3 Center = Node->GetCenter();
-                float Distance = glm::length(Center);
-                if (!Node->GetValidation() && Distance >= Radius && Distance <= Radius + LeafRadius)
-                {
-                    Node->SetValidation(true);
-                    if (++ValidLeafCount == SampleCount)
-                    {
-                        break;
-                    }
-                }
+                // 与八叉树的链接一样返回可修改的指针
+                Systems.emplace_back(SquaredDistance, const_cast<Astro::FStellarSystem*>(&_StellarSystems[i]));
             }
         }
-        else
+    }
+
+    return Systems;
+}
+
+template <typename Func>
+void FUniverse::OctreeLinkToStellarSystems(Func&& AttachStars)
+{
+    NpgsProfileZone("OctreeLinkToStellarSystems");
+
+    // 按密度模型生成的位置没有对应的八叉树叶子，只创建恒星系
+    // 否则存有点的叶子并行筛选出来，恒星系按 Morton 码顺序编号，序号与线程数无关
+    std::vector<glm::vec3>   Slots;
+    std::vector<std::size_t> LeafIndices;
+    if (_SlotGenerator != nullptr)
+    {
+        CollectChunkSlots({ 0, _SlotGenerator->GetLeafCount() }, Slots);
+    }
+    else
+    {
+        LeafIndices = _Octree->CollectLeaves([](std::size_t, const FLeafType& Leaf) -> bool
+        {
+            return Leaf.GetValidation() && Leaf.HasPoint();
+        });
+    }
+
+    std::size_t Offset = _StellarSystems.size();
+    std::size_t Count  = _SlotGenerator != nullptr ? Slots.size() : LeafIndices.size();
+    _StellarSystems.resize(Offset + Count);
+
+    auto LinkSystems = [&](std::size_t Begin, std::size_t End, std::size_t) -> void
+    {
+        NpgsProfileZone("LinkStellarSystems");
+        for (std::size_t i = Begin; i != End; ++i)
         {
-            for (auto* Node : LeafNodes)
+            auto& System = _StellarSystems[Offset + i];
+            if (_SlotGenerator != nullptr)
             {
-                glm::vec3 Center = Node->GetCenter();
-                float Distance = glm::length(Center);
-                if (Node->GetValidation() && Distance >= Radius - LeafRadius && Distance <= Radius)
-                {
-                    Node->SetValidation(false);
-                    if (--ValidLeafCount == SampleCount)
-                    {
-                        break;
-                    }
-                }
+                System = Astro::FStellarSystem(Astro::FBaryCenter(Slots[i], glm::vec2(0.0f), 0, ""));
+            }
+            else
+            {
+                FLeafType& Leaf = _Octree->GetLeafMutable(LeafIndices[i]);
+                System = Astro::FStellarSystem(Astro::FBaryCenter(Leaf.GetPoint(), glm::vec2(0.0f), 0, ""));
+                Leaf.SetLink(&System);
             }
+
+            AttachStars(System, Offset + i);
         }
+    };
+
+    if (_bNumaFirstTouch)
+    {
+        // 恒星系的数据和恒星由负责该段的工作线程分配，内存落在该线程所在的节点上
+        // 恒星系数组本身由 resize 在调用线程上构造，只有各对象持有的堆内存分布到各节点
+        _ThreadPool->ParallelForStatic(0, Count, LinkSystems);
     }
+    else
+    {
+        _ThreadPool->ParallelFor(0, Count, 1024, LinkSystems);
+    }
+}
+
+void FUniverse::RankStellarSystems()
+{
+    NpgsProfileZone("RankStellarSystems");
 
-    Util::TUniformRealDistribution Offset(-LeafRadius, LeafRadius - MinDistance); // 用于随机生成恒星位置相对于叶子节点中心点的偏移量
-    // 遍历八叉树，为每个有效的叶子节点生成一个恒星
-    _Octree->Traverse([&Offset, LeafRadius, MinDistance, this](FNodeType& Node) -> void
+    // 按平方距离排序，排好序后的位置就是排名，距离相同时按下标区分
+    std::vector<std::pair<float, std::size_t>> SquaredDistances(_StellarSystems.size());
+    _ThreadPool->ParallelFor(0, _StellarSystems.size(), 4096, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
     {
-        if (Node.IsLeafNode() && Node.GetValidation())
+        for (std::size_t i = Begin; i != End; ++i)
         {
-            glm::vec3 Center(Node.GetCenter());
-            glm::vec3 StellarSlot(Center.x + Offset(_RandomEngine),
-                                  Center.y + Offset(_RandomEngine),
-                                  Center.z + Offset(_RandomEngine));
-            Node.AddPoint(StellarSlot);
+            const glm::vec3& Position = _StellarSystems[i].GetBaryPosition();
+            SquaredDistances[i] = { glm::dot(Position, Position), i };
         }
     });
 
-    // 为了保证恒星系统的唯一性，将原点附近所在的叶子节点作为存储初始恒星系统的结点
-    // 寻找包含了 (LeafRadius, LeafRadius, LeafRadius) 的叶子节点，将这个格子存储的位置修改为原点
-    FNodeType* HomeNode = _Octree->Find(glm::vec3(LeafRadius), [](const FNodeType& Node) -> bool
+    _ThreadPool->ParallelSort(SquaredDistances.begin(), SquaredDistances.end());
+
+    _ThreadPool->ParallelFor(0, SquaredDistances.size(), 4096, [&](std::size_t Begin, std::size_t End, std::size_t) -> void
     {
-        return Node.IsLeafNode();
+        for (std::size_t Rank = Begin; Rank != End; ++Rank)
+        {
+            _StellarSystems[SquaredDistances[Rank].second].SetBaryDistanceRank(Rank);
+        }
     });
-
-    // 把最靠近原点的格子存储旧的位置点删除，加入初始恒星系统
-    HomeNode->RemoveStorage();
-    HomeNode->AddPoint(glm::vec3(0.0f));
 }
 
-void FUniverse::OctreeLinkToStellarSystems(std::vector<Astro::AStar>& Stars, std::vector<glm::vec3>& Slots)
+void FUniverse::NameStellarSystem(Astro::FStellarSystem& System, std::size_t DistanceRank)
 {
-    std::size_t Index = 0;
+    // 排名不超过 8 位时名字不超过 15 个字符，不会分配堆内存
+    std::array<char, 32> NameBuffer{};
+    char* NameEnd = std::format_to(NameBuffer.data(), "SYSTEM-{:08}", DistanceRank);
+    System.SetBaryName(std::string(NameBuffer.data(), NameEnd)).SetBaryDistanceRank(DistanceRank);
 
-    _Octree->Traverse([&](FNodeType& Node) -> void
+    auto& Stars = System.StarsData();
+    if (Stars.size() > 1)
     {
-        if (Node.IsLeafNode() && Node.GetValidation())
+        std::sort(Stars.begin(), Stars.end(),
+        [](const std::unique_ptr<Astro::AStar>& Star1, std::unique_ptr<Astro::AStar>& Star2) -> bool
         {
-            for (const auto& Point : Node.GetPoints())
-            {
-                Astro::FBaryCenter NewBary(Point, glm::vec2(0.0f), 0, "");
-                Astro::FStellarSystem NewSystem(NewBary);
-                NewSystem.StarsData().emplace_back(std::make_unique<Astro::AStar>(Stars.back()));
-                NewSystem.SetBaryNormal(NewSystem.StarsData().front()->GetNormal());
-                Stars.pop_back();
-
-                _StellarSystems.emplace_back(std::move(NewSystem));
+            return Star1->GetMass() > Star2->GetMass();
+        });
 
-                Node.AddLink(&_StellarSystems[Index]);
-                Slots.emplace_back(Point);
-                ++Index;
-            }
+        char Rank = 'A';
+        for (auto& Star : Stars)
+        {
+            NameEnd = std::format_to(NameBuffer.data(), "STAR-{:08} {}", DistanceRank, Rank);
+            Star->SetName(std::string(NameBuffer.data(), NameEnd));
+            ++Rank;
         }
-    });
+    }
+    else
+    {
+        NameEnd = std::format_to(NameBuffer.data(), "STAR-{:08}", DistanceRank);
+        Stars.front()->SetName(std::string(NameBuffer.data(), NameEnd));
+    }
 }
 
-void FUniverse::GenerateBinaryStars(int MaxThread)
+std::uint64_t FUniverse::GenerateCounterSeedKey()
 {
-    std::vector<System::Generator::FStellarGenerator> Generators;
+    std::uint64_t High = _SeedGenerator(_RandomEngine);
+    std::uint64_t Low  = _SeedGenerator(_RandomEngine);
+    return (High << 32) | Low;
+}
+
+std::vector<System::Generator::FStellarGenerator> FUniverse::CreateStellarGenerators(EStarCategory Category, int MaxThread)
+{
+    using FStellarGenerator = System::Generator::FStellarGenerator;
+    using enum FStellarGenerator::EGenerateDistribution;
+    using enum FStellarGenerator::EGenerateOption;
+
+    FStellarGenerator::EGenerateOption Option = kNormal;
+    float MassLowerLimit = 0.1f;
+    float MassUpperLimit = 300.0f;
+    float AgeLowerLimit  = 0.0f;
+    float AgeUpperLimit  = 1.26e10f;
+    float FeHLowerLimit  = -4.0f;
+    float FeHUpperLimit  = 0.5f;
+    FStellarGenerator::EGenerateDistribution MassDistribution = kFromPdf;
+    FStellarGenerator::EGenerateDistribution AgeDistribution  = kFromPdf;
+
+    switch (Category)
+    {
+    case EStarCategory::kGiant:
+        Option         = kGiant;
+        MassLowerLimit = 1.0f;
+        MassUpperLimit = 35.0f;
+        break;
+    case EStarCategory::kMassiveStar:
+        MassLowerLimit   = 20.0f;
+        AgeUpperLimit    = 3.5e6f;
+        MassDistribution = kUniform;
+        AgeDistribution  = kUniform;
+        break;
+    case EStarCategory::kNeutronStar:
+        Option           = kDeathStar;
+        MassLowerLimit   = 10.0f;
+        MassUpperLimit   = 20.0f;
+        AgeLowerLimit    = 1e7f;
+        AgeUpperLimit    = 1e8f;
+        MassDistribution = kUniform;
+        AgeDistribution  = kUniformByExponent;
+        break;
+    case EStarCategory::kBlackHole:
+        MassLowerLimit   = 35.0f;
+        AgeLowerLimit    = 1e7f;
+        FeHLowerLimit    = -2.0f;
+        MassDistribution = kUniform;
+        break;
+    case EStarCategory::kMergeStar:
+        Option           = kMergeStar;
+        MassLowerLimit   = 0.0f;
+        MassUpperLimit   = 0.0f;
+        AgeLowerLimit    = 1e6f;
+        AgeUpperLimit    = 1e8f;
+        MassDistribution = kUniform;
+        AgeDistribution  = kUniformByExponent;
+        break;
+    case EStarCategory::kCommon:
+        MassLowerLimit = 0.075f;
+        break;
+    case EStarCategory::kBinarySecondStar:
+        Option = kBinarySecondStar; // 质量范围由主星决定，见 GenerateCompanionProperties
+        break;
+    default:
+        break;
+    }
+
+    std::vector<FStellarGenerator> Generators;
+    Generators.reserve(MaxThread);
+
+    if (_bCounterBasedSeeding)
+    {
+        // 每类恒星只从主引擎取一个密钥，主引擎之后的状态与线程数无关
+        std::uint64_t Key = GenerateCounterSeedKey();
+        std::seed_seq SeedSequence{ static_cast<std::uint32_t>(Key), static_cast<std::uint32_t>(Key >> 32) };
+        for (int i = 0; i != MaxThread; ++i)
+        {
+            Generators.emplace_back(SeedSequence, Option, _UniverseAge,
+                                    MassLowerLimit, MassUpperLimit, MassDistribution,
+                                    AgeLowerLimit,  AgeUpperLimit,  AgeDistribution,
+                                    FeHLowerLimit,  FeHUpperLimit);
+            Generators.back().SetCounterSeedKey(Key);
+        }
+
+        return Generators;
+    }
+
     for (int i = 0; i != MaxThread; ++i)
     {
         std::vector<std::uint32_t> Seeds(32);
@@ -985,52 +1789,179 @@ void FUniverse::GenerateBinaryStars(int MaxThread)
 
         std::shuffle(Seeds.begin(), Seeds.end(), _RandomEngine);
         std::seed_seq SeedSequence(Seeds.begin(), Seeds.end());
-        Generators.emplace_back(SeedSequence, System::Generator::FStellarGenerator::EGenerateOption::kBinarySecondStar);
+        Generators.emplace_back(SeedSequence, Option, _UniverseAge,
+                                MassLowerLimit, MassUpperLimit, MassDistribution,
+                                AgeLowerLimit,  AgeUpperLimit,  AgeDistribution,
+                                FeHLowerLimit,  FeHUpperLimit);
     }
 
-    std::vector<Astro::FStellarSystem*> BinarySystems;
-    for (auto& System : _StellarSystems)
+    // 各生成器的引擎用于依次生成基础属性，插值时按段重新播种，同类生成器共用一个段密钥
+    std::uint64_t SegmentKey = GenerateCounterSeedKey();
+    for (auto& Generator : Generators)
+    {
+        Generator.SetSegmentSeedKey(SegmentKey);
+    }
+
+    return Generators;
+}
+
+System::Generator::FStellarGenerator::FBasicProperties
+FUniverse::GenerateCompanionProperties(System::Generator::FStellarGenerator& Generator, const Astro::AStar& FirstStar)
+{
+    float FirstStarInitialMassSol = FirstStar.GetInitialMass() / kSolarMass;
+    float MassLowerLimit = std::max(0.075f, 0.1f * FirstStarInitialMassSol);
+    float MassUpperLimit = std::min(10 * FirstStarInitialMassSol, 300.0f);
+
+    Generator.SetMassLowerLimit(MassLowerLimit);
+    Generator.SetMassUpperLimit(MassUpperLimit);
+    Generator.SetLogMassSuggestDistribution(
+        std::make_unique<Util::TNormalDistribution<>>(std::log10(FirstStarInitialMassSol), 0.25f));
+
+    double Age = FirstStar.GetAge();
+    float  FeH = FirstStar.GetFeH();
+
+    if (std::to_underlying(FirstStar.GetEvolutionPhase()) > 10)
+    {
+        Age -= FirstStar.GetLifetime();
+    }
+
+    return Generator.GenerateBasicProperties(static_cast<float>(Age), FeH);
+}
+
+void FUniverse::BuildSlotCatalog(std::size_t SystemCount)
+{
+    // 恒星系按到原点的距离排名命名，只保存排好序的距离和编号。格子按恒星系编号的顺序取出，距离相同时与 RankStellarSystems 一样按编号区分
+    _SortedSlotDistances.clear();
+    _SortedSlotDistances.reserve(SystemCount);
+    if (_SlotGenerator != nullptr)
     {
-        const auto& Star = System.StarsData().front();
-        if (!Star->GetIsSingleStar())
+        // 位置按块重新生成，不需要同时保存全部位置
+        std::vector<glm::vec3> Slots;
+        for (const auto& Chunk : _SlotGenerator->Partition(1 << 20))
         {
-            BinarySystems.emplace_back(&System);
+            CollectChunkSlots(Chunk, Slots);
+            for (const glm::vec3& Slot : Slots)
+            {
+                _SortedSlotDistances.emplace_back(glm::dot(Slot, Slot), _SortedSlotDistances.size());
+            }
         }
     }
-
-    std::vector<System::Generator::FStellarGenerator::FBasicProperties> BasicProperties;
-    for (std::size_t i = 0; i != BinarySystems.size(); ++i)
+    else
     {
-        std::size_t ThreadId = i % MaxThread;
-        auto& SelectedGenerator = Generators[ThreadId];
+        _Octree->ForEachLeaf([this](std::size_t, FLeafType& Leaf) -> void
+        {
+            if (Leaf.GetValidation() && Leaf.HasPoint())
+            {
+                const glm::vec3& Point = Leaf.GetPoint();
+                _SortedSlotDistances.emplace_back(glm::dot(Point, Point), _SortedSlotDistances.size());
+            }
+        });
+    }
 
-        const auto& Star = BinarySystems[i]->StarsData().front();
-        float FirstStarInitialMassSol = Star->GetInitialMass() / kSolarMass;
-        float MassLowerLimit = std::max(0.075f, 0.1f * FirstStarInitialMassSol);
-        float MassUpperLimit = std::min(10 * FirstStarInitialMassSol, 300.0f);
+    _ThreadPool->ParallelSort(_SortedSlotDistances.begin(), _SortedSlotDistances.end());
 
-        SelectedGenerator.SetMassLowerLimit(MassLowerLimit);
-        SelectedGenerator.SetMassUpperLimit(MassUpperLimit);
-        SelectedGenerator.SetLogMassSuggestDistribution(
-            std::make_unique<Util::TNormalDistribution<>>(std::log10(FirstStarInitialMassSol), 0.25f));
+    // 特殊星随机分布在全部恒星系中
+    const std::array<std::pair<std::size_t, EStarCategory>, 5> kExtraStarCounts
+    {{
+        { _ExtraGiantCount,       EStarCategory::kGiant       },
+        { _ExtraMassiveStarCount, EStarCategory::kMassiveStar },
+        { _ExtraNeutronStarCount, EStarCategory::kNeutronStar },
+        { _ExtraBlackHoleCount,   EStarCategory::kBlackHole   },
+        { _ExtraMergeStarCount,   EStarCategory::kMergeStar   }
+    }};
 
-        double Age = Star->GetAge();
-        float  FeH = Star->GetFeH();
+    std::size_t ExtraStarCount = 0;
+    for (const auto& [Count, Category] : kExtraStarCounts)
+    {
+        ExtraStarCount += Count;
+    }
+
+    if (ExtraStarCount > SystemCount)
+    {
+        throw std::invalid_argument("Extra star count exceeds star count.");
+    }
 
-        if (std::to_underlying(Star->GetEvolutionPhase()) > 10)
+    _ExtraStars.clear();
+    std::unordered_set<std::size_t> UsedIndices;
+    Util::TUniformIntDistribution<std::size_t> IndexGenerator(0, SystemCount - 1);
+    for (const auto& [Count, Category] : kExtraStarCounts)
+    {
+        for (std::size_t i = 0; i != Count; ++i)
         {
-            Age -= Star->GetLifetime();
+            std::size_t Index = 0;
+            do {
+                Index = IndexGenerator(_RandomEngine);
+            } while (!UsedIndices.insert(Index).second);
+
+            _ExtraStars.emplace_back(Index, Category);
         }
+    }
+
+    std::sort(_ExtraStars.begin(), _ExtraStars.end());
+}
+
+FUniverse::EStarCategory FUniverse::GetStarCategory(std::size_t SystemIndex) const
+{
+    auto it = std::lower_bound(_ExtraStars.begin(), _ExtraStars.end(), SystemIndex,
+                               [](const std::pair<std::size_t, EStarCategory>& Extra, std::size_t Index) -> bool
+    {
+        return Extra.first < Index;
+    });
+
+    return it != _ExtraStars.end() && it->first == SystemIndex ? it->second : EStarCategory::kCommon;
+}
 
-        BasicProperties.emplace_back(SelectedGenerator.GenerateBasicProperties(static_cast<float>(Age), FeH));
+void FUniverse::FinishCatalogStellarSystem(Astro::FStellarSystem& System, std::size_t SystemIndex)
+{
+    const glm::vec3& Position = System.GetBaryPosition();
+    auto it = std::lower_bound(_SortedSlotDistances.begin(), _SortedSlotDistances.end(),
+                               std::make_pair(glm::dot(Position, Position), SystemIndex));
+    FinishStellarSystem(System, it - _SortedSlotDistances.begin());
+}
+
+void FUniverse::FinishStellarSystem(Astro::FStellarSystem& System, std::size_t DistanceRank)
+{
+    NameStellarSystem(System, DistanceRank);
+
+    // GenerateSlots 把原点的格子留给初始恒星系
+    if (System.GetBaryPosition() == glm::vec3(0.0f))
+    {
+        System.SetBaryNormal(glm::vec2(0.0f));
+        for (auto& Star : System.StarsData())
+        {
+            Star->SetNormal(glm::vec2(0.0f));
+        }
     }
+}
+
+std::shared_ptr<Astro::FStellarSystem> FUniverse::MaterializeStellarSystem(std::size_t SystemIndex, const glm::vec3& Position)
+{
+    // 与流式生成相同，恒星以所在恒星系的编号作为计数器，完整数据统一由普通恒星的生成器插值
+    auto& SelectedGenerator  = _LazyStellarGenerators[std::to_underlying(GetStarCategory(SystemIndex))];
+    auto& CommonGenerator    = _LazyStellarGenerators[std::to_underlying(EStarCategory::kCommon)];
+    auto& CompanionGenerator = _LazyStellarGenerators[std::to_underlying(EStarCategory::kBinarySecondStar)];
 
-    std::vector<Astro::AStar> Stars = InterpolateStars(MaxThread, Generators, BasicProperties);
+    SelectedGenerator.SetStarSeedCounter(SystemIndex);
+    auto Star = std::make_unique<Astro::AStar>(CommonGenerator.GenerateStar(SelectedGenerator.GenerateBasicProperties()));
 
-    for (std::size_t i = 0; i != BinarySystems.size(); ++i)
+    auto System = std::make_shared<Astro::FStellarSystem>(Astro::FBaryCenter(Position, glm::vec2(0.0f), 0, ""));
+    System->SetBaryNormal(Star->GetNormal());
+    System->StarsData().emplace_back(std::move(Star));
+
+    const Astro::AStar& FirstStar = *System->StarsData().front();
+    if (!FirstStar.GetIsSingleStar())
     {
-        BinarySystems[i]->StarsData().emplace_back(std::make_unique<Astro::AStar>(Stars[i]));
+        CompanionGenerator.SetStarSeedCounter(SystemIndex);
+        auto CompanionProperties = GenerateCompanionProperties(CompanionGenerator, FirstStar);
+        System->StarsData().emplace_back(std::make_unique<Astro::AStar>(CompanionGenerator.GenerateStar(CompanionProperties)));
     }
+
+    FinishCatalogStellarSystem(*System, SystemIndex);
+
+    _LazyOrbitalGenerator->SetSystemSeedCounter(SystemIndex);
+    _LazyOrbitalGenerator->GenerateOrbitals(*System);
+
+    return System;
 }
 
 _NPGS_END
@@ -1,15 +1,25 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <random>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <glm/glm.hpp>
 
 #include "Engine/Core/Base/Base.h"
+#include "Engine/Core/System/Generators/OrbitalGenerator.h"
+#include "Engine/Core/System/Generators/SlotGenerator.h"
 #include "Engine/Core/System/Generators/StellarGenerator.h"
-#include "Engine/Core/System/Spatial/Octree.hpp"
+#include "Engine/Core/System/Spatial/LinearOctree.hpp"
 #include "Engine/Core/Runtime/Threads/ThreadPool.h"
 #include "Engine/Core/Types/Entries/Astro/Star.h"
 #include "Engine/Core/Types/Entries/Astro/StellarSystem.h"
@@ -19,6 +29,10 @@ _NPGS_BEGIN
 
 class FUniverse
 {
+public:
+    // FirstIndex 为块中第一个恒星系按八叉树遍历顺序在全部恒星系中的序号
+    using FStellarSystemSink = std::function<void(std::size_t FirstIndex, std::span<Astro::FStellarSystem> StellarSystems)>;
+
 public:
     FUniverse() = delete;
     FUniverse(std::uint32_t Seed, std::size_t StarCount, std::size_t ExtraGiantCount = 0, std::size_t ExtraMassiveStarCount = 0,
@@ -28,34 +42,118 @@ public:
     ~FUniverse();
 
     void FillUniverse();
+
+    // 流式生成，以八叉树中叶子数不超过 ChunkCapacity 的子树（使用密度模型时为格子数不超过 ChunkCapacity 的一段叶子）为单位
+    // 逐块生成恒星系，每块生成后交给 Sink，Sink 返回后立即释放
+    // 恒星数据只在块内存在，峰值内存与块大小成正比。总是使用计数器种子，结果与块大小和线程数无关
+    // 生成的恒星系不保存在 FUniverse 中，八叉树节点也不链接到恒星系
+    void FillUniverseStreaming(const FStellarSystemSink& Sink, std::size_t ChunkCapacity = 65536);
+
+    // 惰性生成，只生成恒星系的位置，恒星和行星在第一次查询所在格子时才生成，结果只取决于种子和格子的序号。不支持密度模型
+    // 最多缓存 CacheCapacity 个已生成的恒星系，超出时淘汰最久未访问的。总是使用计数器种子
+    void FillUniverseLazy(std::size_t CacheCapacity = 4096);
+    // 返回包含 Position 的格子中的恒星系，格子中没有恒星系时返回 nullptr，可以在多个线程中调用
+    // 被淘汰的恒星系在外部持有的指针全部释放后销毁，再次查询时重新生成
+    std::shared_ptr<Astro::FStellarSystem> QueryStellarSystem(const glm::vec3& Position);
+
+    // Position 所在格子中的恒星系，格子中没有恒星系时返回 nullptr，常数时间。调用条件同下
+    // 使用密度模型时返回 Position 所在的自适应八叉树叶子中离它最近的恒星系
+    Astro::FStellarSystem* FindStellarSystem(const glm::vec3& Position) const;
+    // 离 Position 最近的 Count 个恒星系，按距离升序排列。只能在 FillUniverse 之后调用，可以在多个线程中并发调用
+    std::vector<Astro::FStellarSystem*> FindNearestStellarSystems(const glm::vec3& Position, std::size_t Count) const;
+    // 对与 Position 距离不超过 Radius 的每个恒星系调用 Pred，顺序不定，调用条件同上
+    void ForEachStellarSystemInRadius(const glm::vec3& Position, float Radius,
+                                      const std::function<void(Astro::FStellarSystem*)>& Pred) const;
+    // 用随机的查询点比较八叉树查询与暴力搜索的耗时并校验结果。暴力搜索的耗时与恒星系数量成正比，恒星系很多时应减少 QueryCount
+    void BenchmarkNeighbourQueries(std::size_t QueryCount = 1000, std::size_t NeighbourCount = 16);
+    // 在所有工作线程上生成 StarCount 颗年龄不小于 MinAge 的恒星，报告吞吐量和走轨迹末端（死星）分支的比例
+    // 使用单独的种子，不影响宇宙的生成，不需要先生成宇宙
+    void BenchmarkOldPopulation(std::size_t StarCount = 100000, float MinAge = 1e10f);
+
     void ReplaceStar(std::size_t DistanceRank, const Astro::AStar& StarData);
     void CountStars();
 
+    // 开启后由各工作线程分配和填充自己负责的那一段恒星系数据，使内存分布在各 NUMA 节点上
+    void SetNumaFirstTouch(bool bEnable);
+    // 开启后每颗恒星的随机数由种子和恒星编号决定，同一种子在不同线程数的机器上生成相同的宇宙
+    void SetCounterBasedSeeding(bool bEnable);
+    // 开启后 FillUniverse 结束时输出各阶段的耗时汇总，文件名不为空时同时导出 Chrome trace
+    void SetProfiling(bool bEnable, const std::string& ChromeTraceFilename = "");
+    // 设置后恒星系按密度模型分布在以原点为中心、半边长为 RegionRadius 的立方体中，初始恒星系仍在原点，nullptr 恢复均匀的球体
+    // 此时不建立均匀栅格的八叉树，FindStellarSystem 等空间查询使用格子生成器的自适应八叉树
+    void SetDensityModel(std::shared_ptr<const System::Generator::IStellarDensityModel> DensityModel, float RegionRadius);
+
 private:
-    template <typename AstroType, typename DataType>
-    void MakeChunks(int MaxThread, std::vector<DataType>& Data, std::vector<std::vector<DataType>>& DataLists,
-                    std::vector<std::promise<std::vector<AstroType>>>& Promises,
-                    std::vector<std::future<std::vector<AstroType>>>& ChunkFutures);
+    enum class EStarCategory
+    {
+        kGiant,
+        kMassiveStar,
+        kNeutronStar,
+        kBlackHole,
+        kMergeStar,
+        kCommon,
+        kBinarySecondStar
+    };
 
+private:
     void GenerateStars(int MaxThread);
     void FillStellarSystem(int MaxThread);
 
-    std::vector<Astro::AStar> InterpolateStars(int MaxThread, std::vector<System::Generator::FStellarGenerator>& Generators,
+    std::vector<Astro::AStar> InterpolateStars(std::vector<System::Generator::FStellarGenerator>& Generators,
                                                std::vector<System::Generator::FStellarGenerator::FBasicProperties>& BasicProperties);
 
+    // Companions[i] 为第 i 颗恒星的伴星，单星为 nullptr
+    std::vector<Astro::AStar>
+    InterpolateStarsWithCompanions(std::vector<System::Generator::FStellarGenerator>& Generators,
+                                   std::vector<System::Generator::FStellarGenerator>& CompanionGenerators,
+                                   std::vector<System::Generator::FStellarGenerator::FBasicProperties>& BasicProperties,
+                                   std::vector<std::unique_ptr<Astro::AStar>>& Companions);
+
+    // 将 [0, Count) 按 Grain 切成固定的段动态分配给参与者，Pred(Begin, End, SegmentIndex, Slot) 使用第 Slot 个生成器
+    // 段数远多于线程数且与线程数无关。非计数器种子模式下 Pred 处理一段前用 SegmentIndex 重新播种生成器，结果与调度无关
+    // bStatic 为 true 时各段按 ParallelForStatic 的划分固定交给工作线程，Slot 为工作线程序号
+    template <typename Func>
+    void ParallelForGenerators(std::size_t Count, std::size_t Grain, bool bStatic, Func&& Pred);
+
     void GenerateSlots(float MinDistance, std::size_t SampleCount, float Density);
-    void OctreeLinkToStellarSystems(std::vector<Astro::AStar>& Stars, std::vector<glm::vec3>& Slots);
-    void GenerateBinaryStars(int MaxThread);
+    void GenerateDensitySlots(std::size_t SampleCount);
+    // 取出 GenerateSlots 生成的一块位置，Chunk 为八叉树或自适应格子生成器的叶子区间
+    void CollectChunkSlots(const std::pair<std::size_t, std::size_t>& Chunk, std::vector<glm::vec3>& Points) const;
+    // 为每个八叉树叶子（或密度模型生成的位置）创建恒星系，并在同一个并行划分中调用 AttachStars(System, SystemIndex) 填充恒星
+    // first-touch 模式下使用 ParallelForStatic，与之后行星生成的划分一致
+    template <typename Func>
+    void OctreeLinkToStellarSystems(Func&& AttachStars);
+    // 使用密度模型时恒星系按格子顺序存放，叶子 L 中的恒星系下标为 [GetSlotOffset(L), GetSlotOffset(L + 1))
+    // 只有 FillUniverse 生成的恒星系与格子一一对应，流式生成后不可用
+    bool HasSlotIndex() const;
+    // 与 Position 距离不超过 Radius 的恒星系及其距离的平方，顺序不定
+    std::vector<std::pair<float, Astro::FStellarSystem*>> CollectSlotSystems(const glm::vec3& Position, float Radius) const;
+    void RankStellarSystems();
+    void NameStellarSystem(Astro::FStellarSystem& System, std::size_t DistanceRank);
+    void FinishStellarSystem(Astro::FStellarSystem& System, std::size_t DistanceRank);
+    std::uint64_t GenerateCounterSeedKey();
+
+    // 流式和惰性生成共用，按八叉树遍历顺序给恒星系编号，特殊星只记录所在恒星系的编号
+    void BuildSlotCatalog(std::size_t SystemCount);
+    EStarCategory GetStarCategory(std::size_t SystemIndex) const;
+    void FinishCatalogStellarSystem(Astro::FStellarSystem& System, std::size_t SystemIndex);
+    std::shared_ptr<Astro::FStellarSystem> MaterializeStellarSystem(std::size_t SystemIndex, const glm::vec3& Position);
+
+    std::vector<System::Generator::FStellarGenerator> CreateStellarGenerators(EStarCategory Category, int MaxThread);
+    System::Generator::FStellarGenerator::FBasicProperties
+    GenerateCompanionProperties(System::Generator::FStellarGenerator& Generator, const Astro::AStar& FirstStar);
 
 private:
-    using FNodeType = System::Spatial::TOctree<Astro::FStellarSystem>::FNodeType;
+    using FLeafType = System::Spatial::TLinearOctree<Astro::FStellarSystem>::FLeafType;
 
 private:
-    std::mt19937                                                     _RandomEngine;
-    Util::TUniformIntDistribution<std::uint32_t>                     _SeedGenerator;
-    Util::TUniformRealDistribution<>                                 _CommonGenerator;
-    std::unique_ptr<System::Spatial::TOctree<Astro::FStellarSystem>> _Octree;
-    Runtime::Thread::FThreadPool*                                    _ThreadPool;
+    std::mt19937                                                           _RandomEngine;
+    Util::TUniformIntDistribution<std::uint32_t>                           _SeedGenerator;
+    Util::TUniformRealDistribution<>                                       _CommonGenerator;
+    std::unique_ptr<System::Spatial::TLinearOctree<Astro::FStellarSystem>> _Octree;
+    std::shared_ptr<const System::Generator::IStellarDensityModel>         _DensityModel;
+    std::unique_ptr<System::Generator::FSlotGenerator>                     _SlotGenerator; // 使用密度模型时代替 _Octree
+    Runtime::Thread::FThreadPool*                                          _ThreadPool;
 
     std::size_t _StarCount;
     std::size_t _ExtraGiantCount;
@@ -64,8 +162,28 @@ private:
     std::size_t _ExtraBlackHoleCount;
     std::size_t _ExtraMergeStarCount;
     float       _UniverseAge;
+    float       _DensityRegionRadius;
+    bool        _bNumaFirstTouch;
+    bool        _bCounterBasedSeeding;
+    bool        _bProfiling;
+    std::string _ProfileTraceFilename;
 
     std::vector<Astro::FStellarSystem> _StellarSystems;
+
+    // 流式和惰性生成的恒星系目录
+    std::vector<std::pair<std::size_t, EStarCategory>> _ExtraStars;          // 按恒星系编号升序排列
+    std::vector<std::pair<float, std::size_t>>         _SortedSlotDistances; // (距离的平方, 恒星系编号)，用于按距离排名命名
+
+    // 惰性生成
+    using FLruList = std::list<std::pair<std::size_t, std::shared_ptr<Astro::FStellarSystem>>>;
+
+    std::vector<System::Generator::FStellarGenerator>        _LazyStellarGenerators; // 下标为 EStarCategory
+    std::unique_ptr<System::Generator::FOrbitalGenerator>    _LazyOrbitalGenerator;
+    std::unordered_map<std::size_t, std::size_t>             _LeafSystemIndices;     // 叶子下标到恒星系编号
+    FLruList                                                 _LruList;               // 最近访问的在前
+    std::unordered_map<std::size_t, FLruList::iterator>      _LruIndices;
+    std::size_t                                              _CacheCapacity;
+    std::mutex                                               _LazyMutex;
 };
 
 _NPGS_END
@@ -199,3 +199,6 @@
 #define NPGS_ENABLE_CONSOLE_LOGGER
 #endif // _RELEASE
 #include "Engine/Utils/Logger.h"
+
+// 分析器默认在运行时关闭，注释掉后分段计时完全不参与编译
+#define NPGS_ENABLE_PROFILER
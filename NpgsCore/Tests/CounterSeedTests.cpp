@@ -0,0 +1,86 @@
+// 检查计数器种子的约定：第 i 个对象用 FCounterSeedSequence(Key, i, Stream) 播种时，结果与线程数和调度无关
+// FStellarGenerator 和 FOrbitalGenerator 在计数器种子模式下都按这种方式在 ParallelFor 中逐个播种
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <random>
+#include <vector>
+
+#include "Engine/Core/Runtime/Threads/ThreadPool.h"
+#include "Engine/Utils/Random.hpp"
+#include "TestMain.h"
+
+using namespace Npgs::Runtime::Thread;
+using Npgs::Util::FCounterSeedSequence;
+
+namespace
+{
+    constexpr std::uint64_t kKey   = 0x9E3779B97F4A7C15ull;
+    constexpr std::size_t   kCount = 20000;
+
+    using FDraws = std::array<std::mt19937::result_type, 4>;
+
+    // 每个参与者一个引擎，处理每个下标前重新播种；计算量随下标变化，让各块的完成顺序随调度变化
+    std::vector<FDraws> DrawAll(FThreadPool* ThreadPool, std::uint64_t Stream, std::size_t Grain)
+    {
+        std::vector<std::mt19937> Engines(ThreadPool->GetMaxThreadCount());
+        std::vector<FDraws> Results(kCount);
+        ThreadPool->ParallelFor(0, kCount, Grain, [&](std::size_t Begin, std::size_t End, std::size_t Slot) -> void
+        {
+            auto& Engine = Engines[Slot];
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                FCounterSeedSequence SeedSequence(kKey, i, Stream);
+                Engine.seed(SeedSequence);
+
+                std::size_t Skip = Engine() % 32;
+                for (std::size_t j = 0; j != Skip; ++j)
+                {
+                    Engine();
+                }
+
+                Results[i] = { Engine(), Engine(), Engine(), Engine() };
+            }
+        });
+
+        return Results;
+    }
+
+    void TestIndependentOfThreadCount(FThreadPool* ThreadPool)
+    {
+        ThreadPool->Resize(1);
+        const std::vector<FDraws> Expected = DrawAll(ThreadPool, 0, 64);
+
+        for (int ThreadCount : { 2, 3, 4, 8 })
+        {
+            ThreadPool->Resize(ThreadCount);
+            for (std::size_t Grain : { 1, 64, 1000 })
+            {
+                NpgsCheck(DrawAll(ThreadPool, 0, Grain) == Expected);
+            }
+        }
+    }
+
+    // 同一下标的不同流不能相同，否则同一颗恒星的基础属性和插值会使用相同的随机数
+    void TestStreamsDiffer(FThreadPool* ThreadPool)
+    {
+        ThreadPool->Resize(4);
+        const std::vector<FDraws> First  = DrawAll(ThreadPool, 0, 64);
+        const std::vector<FDraws> Second = DrawAll(ThreadPool, 1, 64);
+        for (std::size_t i = 0; i != kCount; ++i)
+        {
+            NpgsCheck(First[i] != Second[i]);
+        }
+    }
+}
+
+int main()
+{
+    FThreadPool* ThreadPool = FThreadPool::GetInstance();
+
+    TestIndependentOfThreadCount(ThreadPool);
+    TestStreamsDiffer(ThreadPool);
+
+    ThreadPool->Stop();
+    return 0;
+}
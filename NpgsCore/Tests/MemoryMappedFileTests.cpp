@@ -0,0 +1,68 @@
+// 检查 FMemoryMappedFile 的 mmap 分支
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "Engine/Core/Runtime/Assets/MemoryMappedFile.h"
+#include "TestMain.h"
+
+using namespace Npgs::Runtime::Asset;
+
+namespace
+{
+    std::filesystem::path WriteTemporaryFile(const std::string& Name, const std::string& Content)
+    {
+        std::filesystem::path Filepath = std::filesystem::temp_directory_path() / Name;
+        std::ofstream File(Filepath, std::ios::binary | std::ios::trunc);
+        File.write(Content.data(), static_cast<std::streamsize>(Content.size()));
+        return Filepath;
+    }
+
+    template <typename Func>
+    bool ThrowsRuntimeError(Func&& Pred)
+    {
+        try
+        {
+            Pred();
+        }
+        catch (const std::runtime_error&)
+        {
+            return true;
+        }
+
+        return false;
+    }
+}
+
+int main()
+{
+    const std::string Content = "log_Teff,log_R,star_mass\n3.76,0.0,1.0\n";
+    std::filesystem::path Filepath = WriteTemporaryFile("NpgsMemoryMappedFileTests.csv", Content);
+
+    {
+        FMemoryMappedFile File(Filepath.string());
+        NpgsCheck(File.IsOpen());
+        NpgsCheck(File.GetSize() == Content.size());
+        NpgsCheck(std::memcmp(File.GetData(), Content.data(), Content.size()) == 0);
+
+        FMemoryMappedFile Moved(std::move(File));
+        NpgsCheck(!File.IsOpen());
+        NpgsCheck(Moved.IsOpen());
+        NpgsCheck(Moved.GetSize() == Content.size());
+
+        Moved.Close();
+        NpgsCheck(!Moved.IsOpen());
+    }
+
+    std::filesystem::path EmptyFilepath = WriteTemporaryFile("NpgsMemoryMappedFileTestsEmpty.csv", "");
+    NpgsCheck(ThrowsRuntimeError([&]() -> void { FMemoryMappedFile File(EmptyFilepath.string()); }));
+    NpgsCheck(ThrowsRuntimeError([&]() -> void { FMemoryMappedFile File((Filepath.parent_path() / "NpgsMissing.csv").string()); }));
+
+    std::filesystem::remove(Filepath);
+    std::filesystem::remove(EmptyFilepath);
+    return 0;
+}
@@ -0,0 +1,144 @@
+// 检查 Exp10Array 各指令集实现与 std::pow 的一致性，包括尾部长度和 NaN 的处理
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "Engine/Core/Math/SimdKernels.h"
+#include "TestMain.h"
+
+using namespace Npgs::Math;
+
+namespace
+{
+    constexpr double kRelativeTolerance = 1e-14;
+    constexpr double kSentinel          = -1.0;
+
+    bool Matches(double Input, double Value)
+    {
+        if (std::isnan(Input))
+        {
+            return std::isnan(Value);
+        }
+
+        double Expected = std::pow(10.0, std::fmin(std::fmax(Input, -307.0), 308.0));
+        return std::abs(Value - Expected) <= Expected * kRelativeTolerance;
+    }
+
+    void TestRange(ESimdLevel Level)
+    {
+        std::vector<double> Source;
+        for (double x = -307.0; x <= 308.0; x += 0.0137)
+        {
+            Source.push_back(x);
+        }
+
+        Source.insert(Source.end(), { -307.0, 308.0, 0.0, -0.0, 1.0, -1.0, 0.5 });
+        std::vector<double> Result(Source.size());
+        Exp10Array(Source.data(), Result.data(), Source.size(), Level);
+
+        for (std::size_t i = 0; i != Source.size(); ++i)
+        {
+            NpgsCheck(Matches(Source[i], Result[i]));
+        }
+
+        // 原地计算
+        std::vector<double> InPlace = Source;
+        Exp10Array(InPlace.data(), InPlace.data(), InPlace.size(), Level);
+        NpgsCheck(InPlace == Result);
+    }
+
+    // 超出范围的输入被钳制，NaN 原样输出
+    void TestSpecialValues(ESimdLevel Level)
+    {
+        constexpr double kInfinity = std::numeric_limits<double>::infinity();
+        constexpr double kNaN      = std::numeric_limits<double>::quiet_NaN();
+
+        const std::vector<double> Source{ kNaN, -400.0, 400.0, -kInfinity, kInfinity, kNaN, 2.0, -kNaN, kNaN };
+        std::vector<double> Result(Source.size());
+        Exp10Array(Source.data(), Result.data(), Source.size(), Level);
+
+        for (std::size_t i = 0; i != Source.size(); ++i)
+        {
+            NpgsCheck(Matches(Source[i], Result[i]));
+        }
+    }
+
+    // 长度 0 到 8 覆盖每种实现的整向量和尾部，Count 之后的元素不能被写入
+    void TestTails(ESimdLevel Level)
+    {
+        for (std::size_t Count = 0; Count <= 8; ++Count)
+        {
+            std::vector<double> Source(16);
+            for (std::size_t i = 0; i != Source.size(); ++i)
+            {
+                Source[i] = static_cast<double>(i) * 37.5 - 300.0;
+            }
+
+            std::vector<double> Result(Source.size(), kSentinel);
+            Exp10Array(Source.data(), Result.data(), Count, Level);
+
+            for (std::size_t i = 0; i != Count; ++i)
+            {
+                NpgsCheck(Matches(Source[i], Result[i]));
+            }
+
+            for (std::size_t i = Count; i != Result.size(); ++i)
+            {
+                NpgsCheck(Result[i] == kSentinel);
+            }
+        }
+    }
+
+    void TestUnsupportedLevel()
+    {
+        if (GetSimdLevel() == ESimdLevel::kAvx512)
+        {
+            return;
+        }
+
+        bool bCaught = false;
+        double Value = 0.0;
+        try
+        {
+            Exp10Array(&Value, &Value, 1, ESimdLevel::kAvx512);
+        }
+        catch (const std::invalid_argument&)
+        {
+            bCaught = true;
+        }
+
+        NpgsCheck(bCaught);
+    }
+}
+
+int main()
+{
+    for (ESimdLevel Level : { ESimdLevel::kScalar, ESimdLevel::kSse2, ESimdLevel::kAvx2, ESimdLevel::kAvx512 })
+    {
+        if (Level > GetSimdLevel())
+        {
+            std::printf("Skipping SIMD level %d, not supported by this CPU\n", static_cast<int>(Level));
+            continue;
+        }
+
+        TestRange(Level);
+        TestSpecialValues(Level);
+        TestTails(Level);
+    }
+
+    // 默认分派与最高指令集的实现一致
+    const std::vector<double> Source{ -12.5, 0.0, 3.25, 100.0, std::numeric_limits<double>::quiet_NaN() };
+    std::vector<double> Dispatched(Source.size());
+    std::vector<double> Highest(Source.size());
+    Exp10Array(Source.data(), Dispatched.data(), Source.size());
+    Exp10Array(Source.data(), Highest.data(), Source.size(), GetSimdLevel());
+    for (std::size_t i = 0; i != Source.size(); ++i)
+    {
+        NpgsCheck(Dispatched[i] == Highest[i] || (std::isnan(Dispatched[i]) && std::isnan(Highest[i])));
+    }
+
+    TestUnsupportedLevel();
+    return 0;
+}
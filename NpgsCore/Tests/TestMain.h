@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// 检查失败时打印表达式和位置并以非零值退出，ctest 据此判定失败
+#define NpgsCheck(Expr)                                                                             \
+do                                                                                                  \
+{                                                                                                   \
+    if (!(Expr))                                                                                    \
+    {                                                                                               \
+        std::fprintf(stderr, "Check failed: %s in %s at line %d\n", #Expr, __FILE__, __LINE__);     \
+        std::exit(EXIT_FAILURE);                                                                    \
+    }                                                                                               \
+} while (false)
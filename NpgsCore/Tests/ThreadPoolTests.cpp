@@ -0,0 +1,337 @@
+// 在 Linux 上检查 FThreadPool 和 FTaskGroup 的基本行为，同时覆盖 Base.h 和 Assert.h 的非 Windows 分支
+#define NPGS_ENABLE_ASSERT
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Engine/Core/Base/Assert.h"
+#include "Engine/Core/Base/Base.h"
+#include "Engine/Core/Runtime/Threads/TaskGroup.h"
+#include "Engine/Core/Runtime/Threads/ThreadPool.h"
+#include "TestMain.h"
+
+using namespace Npgs::Runtime::Thread;
+
+namespace
+{
+    // 本线程调用全局 operator new 的次数
+    thread_local std::size_t tAllocationCount = 0;
+}
+
+void* operator new(std::size_t Size)
+{
+    ++tAllocationCount;
+    if (void* Memory = std::malloc(Size != 0 ? Size : 1))
+    {
+        return Memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* Memory) noexcept
+{
+    std::free(Memory);
+}
+
+void operator delete(void* Memory, std::size_t) noexcept
+{
+    std::free(Memory);
+}
+
+namespace
+{
+    constexpr int kThreadCount = 4;
+
+    void TestSubmit(FThreadPool* ThreadPool)
+    {
+        auto Future = ThreadPool->Submit([](int Lhs, int Rhs) -> int { return Lhs + Rhs; }, 40, 2);
+        NpgsCheck(Future.get() == 42);
+    }
+
+    void WaitForCount(const std::atomic<int>& Count, int Expected)
+    {
+        while (Count.load(std::memory_order_acquire) != Expected)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // 任务节点执行后被复用，预热之后提交小任务不再分配内存
+    void TestSubmitWithoutAllocation(FThreadPool* ThreadPool)
+    {
+        constexpr int kTaskCount = 1000;
+
+        // 预热时任务都阻塞在闸门上，节点数达到提交数量，留出一倍余量给还没放回的节点
+        std::atomic<int>  Count{ 0 };
+        std::atomic<bool> bGateOpen{ false };
+        for (int i = 0; i != 2 * kTaskCount; ++i)
+        {
+            ThreadPool->SubmitDetached([&Count, &bGateOpen]() -> void
+            {
+                while (!bGateOpen.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+
+                Count.fetch_add(1, std::memory_order_release);
+            });
+        }
+
+        bGateOpen.store(true, std::memory_order_release);
+        WaitForCount(Count, 2 * kTaskCount);
+
+        Count.store(0, std::memory_order_relaxed);
+        std::size_t AllocationCount = tAllocationCount;
+        for (int i = 0; i != kTaskCount; ++i)
+        {
+            ThreadPool->SubmitDetached([&Count]() -> void { Count.fetch_add(1, std::memory_order_release); });
+        }
+
+        AllocationCount = tAllocationCount - AllocationCount;
+        WaitForCount(Count, kTaskCount);
+        NpgsCheck(AllocationCount == 0);
+    }
+
+    void TestParallelFor(FThreadPool* ThreadPool)
+    {
+        constexpr std::size_t kCount = 100000;
+        std::vector<std::atomic<int>> Visits(kCount);
+        std::atomic<bool> bSlotInRange{ true };
+
+        ThreadPool->ParallelFor(0, kCount, 64, [&](std::size_t Begin, std::size_t End, std::size_t Slot) -> void
+        {
+            if (Slot >= static_cast<std::size_t>(ThreadPool->GetMaxThreadCount()))
+            {
+                bSlotInRange = false;
+            }
+
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                Visits[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+
+        NpgsCheck(bSlotInRange);
+        NpgsCheck(std::all_of(Visits.begin(), Visits.end(), [](const std::atomic<int>& Count) -> bool { return Count == 1; }));
+
+        // 空区间不调用 Pred
+        bool bCalled = false;
+        ThreadPool->ParallelFor(5, 5, 1, [&](std::size_t, std::size_t, std::size_t) -> void { bCalled = true; });
+        NpgsCheck(!bCalled);
+    }
+
+    void TestParallelForException(FThreadPool* ThreadPool)
+    {
+        bool bCaught = false;
+        try
+        {
+            ThreadPool->ParallelFor(0, 1000, 1, [](std::size_t Begin, std::size_t, std::size_t) -> void
+            {
+                if (Begin == 500)
+                {
+                    throw std::runtime_error("Expected");
+                }
+            });
+        }
+        catch (const std::runtime_error&)
+        {
+            bCaught = true;
+        }
+
+        NpgsCheck(bCaught);
+    }
+
+    void TestParallelReduce(FThreadPool* ThreadPool)
+    {
+        constexpr std::uint64_t kCount = 1000000;
+        std::uint64_t Sum = ThreadPool->ParallelReduce(std::size_t{ 0 }, std::size_t{ kCount }, 1024, std::uint64_t{ 0 },
+            [](std::size_t Begin, std::size_t End, std::uint64_t& Partial) -> void
+        {
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                Partial += i;
+            }
+        },
+            [](std::uint64_t& Result, std::uint64_t Partial) -> void
+        {
+            Result += Partial;
+        });
+
+        NpgsCheck(Sum == kCount * (kCount - 1) / 2);
+    }
+
+    void TestParallelForStatic(FThreadPool* ThreadPool)
+    {
+        constexpr std::size_t kCount = 10007;
+        std::vector<int> Owners(kCount, -1);
+
+        ThreadPool->ParallelForStatic(0, kCount, [&](std::size_t Begin, std::size_t End, std::size_t WorkerIndex) -> void
+        {
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                Owners[i] = static_cast<int>(WorkerIndex);
+            }
+        });
+
+        // 每段由一个线程连续覆盖，线程编号随段递增
+        NpgsCheck(std::all_of(Owners.begin(), Owners.end(), [](int Owner) -> bool { return Owner >= 0 && Owner < kThreadCount; }));
+        NpgsCheck(std::is_sorted(Owners.begin(), Owners.end()));
+    }
+
+    // 模拟 FUniverse 非计数器种子模式的用法：每个参与者一个引擎，处理每段前用段编号重新播种，结果只由种子决定
+    std::vector<std::uint32_t> DrawChunked(FThreadPool* ThreadPool, std::size_t Count, std::size_t ChunkCount)
+    {
+        std::vector<std::mt19937> Engines(ThreadPool->GetMaxThreadCount());
+        std::vector<std::uint32_t> Values(Count);
+        std::vector<std::atomic<int>> ChunkVisits(ChunkCount);
+        std::atomic<bool> bSlotInRange{ true };
+        ThreadPool->ParallelForChunked(0, Count, ChunkCount, [&](std::size_t Begin, std::size_t End, std::size_t ChunkIndex, std::size_t Slot) -> void
+        {
+            if (Slot >= Engines.size())
+            {
+                bSlotInRange = false;
+                return;
+            }
+
+            ChunkVisits[ChunkIndex].fetch_add(1, std::memory_order_relaxed);
+            auto& Engine = Engines[Slot];
+            Engine.seed(static_cast<std::uint32_t>(1000 + ChunkIndex));
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                // 计算量不均匀，让各段的完成顺序随机变化
+                std::size_t Work = Engine() % 64;
+                std::uint32_t Value = 0;
+                for (std::size_t j = 0; j != Work; ++j)
+                {
+                    Value ^= Engine();
+                }
+
+                Values[i] = Value;
+            }
+        });
+
+        NpgsCheck(bSlotInRange);
+        NpgsCheck(std::all_of(ChunkVisits.begin(), ChunkVisits.end(), [](const std::atomic<int>& Visits) -> bool { return Visits == 1; }));
+        return Values;
+    }
+
+    void TestParallelForChunked(FThreadPool* ThreadPool)
+    {
+        constexpr std::size_t kCount      = 50000;
+        constexpr std::size_t kChunkCount = 64; // 远多于线程数
+
+        std::vector<std::uint32_t> First  = DrawChunked(ThreadPool, kCount, kChunkCount);
+        std::vector<std::uint32_t> Second = DrawChunked(ThreadPool, kCount, kChunkCount);
+        NpgsCheck(First == Second);
+
+        // 线程数变化时段的划分不变
+        ThreadPool->Resize(2);
+        std::vector<std::uint32_t> Third = DrawChunked(ThreadPool, kCount, kChunkCount);
+        ThreadPool->Resize(kThreadCount);
+        NpgsCheck(First == Third);
+
+        // 段数多于元素数时多余的段不调用 Pred
+        std::vector<int> Visits(3, 0);
+        ThreadPool->ParallelForChunked(0, 3, 8, [&](std::size_t Begin, std::size_t End, std::size_t, std::size_t) -> void
+        {
+            for (std::size_t i = Begin; i != End; ++i)
+            {
+                ++Visits[i];
+            }
+        });
+
+        NpgsCheck(Visits == std::vector<int>(3, 1));
+    }
+
+    void TestParallelSort(FThreadPool* ThreadPool)
+    {
+        std::mt19937 Engine(42);
+        std::vector<int> Values(200000);
+        for (int& Value : Values)
+        {
+            Value = static_cast<int>(Engine());
+        }
+
+        std::vector<int> Expected = Values;
+        std::sort(Expected.begin(), Expected.end());
+        ThreadPool->ParallelSort(Values.begin(), Values.end(), std::less<>{}, 1000);
+        NpgsCheck(Values == Expected);
+    }
+
+    void TestTaskGroup(FThreadPool* ThreadPool)
+    {
+        std::atomic<int> Count{ 0 };
+        FTaskGroup Outer(ThreadPool);
+        for (int i = 0; i != 8; ++i)
+        {
+            Outer.Run([&]() -> void
+            {
+                // 在工作线程中嵌套等待
+                FTaskGroup Inner(ThreadPool);
+                for (int j = 0; j != 8; ++j)
+                {
+                    Inner.Run([&]() -> void { Count.fetch_add(1, std::memory_order_relaxed); });
+                }
+
+                Inner.Wait();
+            });
+        }
+
+        Outer.Wait();
+        NpgsCheck(Count == 64);
+
+        bool bCaught = false;
+        FTaskGroup Throwing(ThreadPool);
+        Throwing.Run([]() -> void { throw std::logic_error("Expected"); });
+        try
+        {
+            Throwing.Wait();
+        }
+        catch (const std::logic_error&)
+        {
+            bCaught = true;
+        }
+
+        NpgsCheck(bCaught);
+    }
+
+    void TestLifecycle(FThreadPool* ThreadPool)
+    {
+        ThreadPool->Resize(2);
+        NpgsCheck(ThreadPool->IsRunning());
+        TestParallelFor(ThreadPool);
+        ThreadPool->Resize(kThreadCount);
+        NpgsCheck(ThreadPool->GetMaxThreadCount() == kThreadCount);
+    }
+}
+
+int main()
+{
+    NpgsAssert(true, "Assert.h must compile with assertions enabled");
+
+    FThreadPool* ThreadPool = FThreadPool::GetInstance();
+    ThreadPool->Start(kThreadCount);
+
+    TestSubmit(ThreadPool);
+    TestSubmitWithoutAllocation(ThreadPool);
+    TestParallelFor(ThreadPool);
+    TestParallelForException(ThreadPool);
+    TestParallelReduce(ThreadPool);
+    TestParallelForStatic(ThreadPool);
+    TestParallelForChunked(ThreadPool);
+    TestParallelSort(ThreadPool);
+    TestTaskGroup(ThreadPool);
+    TestLifecycle(ThreadPool);
+
+    ThreadPool->Stop();
+    return 0;
+}